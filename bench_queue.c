@@ -0,0 +1,330 @@
+/*
+ * SMART TICKET ENGINE - MICROBENCHMARK SUITE
+ * Measures the engine's hot functions at queue sizes from 100 up to the
+ * whole ticket ID space (MAX_TICKET_ID tickets, just short of 1M), using
+ * data_generator.c's ticket generation for realistic inputs.
+ *
+ * Compile: see run_benchmarks.sh (main.c + data_generator.c as libraries)
+ * Run: ./bench_runner [max_queue_size] [repetitions]
+ *
+ * Output is CSV on stdout, one row per benchmark and queue size, with
+ * '#' metadata lines, so results can be diffed across releases.
+ * Needs GENERATOR_CONFIG.json and a templates/ directory in the working
+ * directory; it writes the active database CSV there (run it in a scratch dir).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <stdint.h>
+#include "config.h"
+
+/* ==================== EXTERNAL DECLARATIONS ==================== */
+
+// Data structure from main.c
+struct Ticket {
+    int ticketID;
+    char customerName[MAX_CUSTOMER_NAME_LEN + 1];
+    char email[MAX_EMAIL_LEN + 1];
+    char product[MAX_PRODUCT_LEN + 1];
+    char purchaseDate[MAX_PURCHASE_DATE_LEN + 1];
+    char issueDescription[MAX_ISSUE_DESC_LEN + 1];
+    char priority[MAX_PRIORITY_LEN + 1];
+    time_t queueEntryTime;
+};
+
+// Text fields of a queued ticket (enum TicketField in main.c)
+enum { FIELD_NAME, FIELD_EMAIL, FIELD_PRODUCT, FIELD_DATE, FIELD_ISSUE };
+
+// External variables and functions from main.c
+extern int front, rear;
+extern size_t textArenaSize;
+extern const char *queuedTicketText(int slot, int field);
+extern int enqueue(struct Ticket t);
+extern int dequeue(struct Ticket *t);
+extern void resetQueue();
+extern const char* getAutoPriority(const char* desc);
+extern int isDuplicateInQueue(const char *email, const char *issue);
+extern void getQueueStats(int *total, double *avgWaitHours, int *oldestHours, int priorities[4]);
+extern void escalateOldTickets();
+extern void loadFromFile();
+extern void saveQueueToFile();
+extern void generateAdminHTML();
+extern uint64_t metricsNow();
+extern int ingestTicket(struct Ticket *t, time_t entryTime, FILE *db, int *existingID);
+extern int enqueueBatch(struct Ticket *tickets, int count, time_t entryTime, FILE *db, int *results);
+extern long reserveTicketIDs(int count, long floorID);
+extern int coldFieldMode;
+extern int startLogger();
+extern void stopLogger();
+
+// Ticket generation from data_generator.c (built with -DGENERATOR_LIBRARY)
+struct GeneratedTicket {
+    int id;
+    char name[100];
+    char email[100];
+    char product[50];
+    char date[20];
+    char issue[256];
+    const char *priority;
+    long entry_time;
+};
+struct GenRng {
+    uint64_t s[4];
+};
+extern void init_data();
+extern void rng_seed(struct GenRng *rng, uint64_t seed, uint64_t stream);
+extern void generate_ticket(struct GenRng *rng, struct GeneratedTicket *g, int id, long current_time);
+
+/* ==================== BENCHMARK HARNESS ==================== */
+
+#define BENCH_SEED 20240601
+#define BENCH_MIN_REP_NS 20000000ULL     // Aim for >= 20 ms per repetition
+#define BENCH_MAX_OPS_PER_REP 10000000L
+#define BENCH_POOL_SIZE 4096             // Generated tickets recycled by the ingest benchmarks
+#define BENCH_BATCH_SIZE 1000            // Spool batch size for enqueue_batch
+#ifdef _WIN32
+#define BENCH_NULL_DEVICE "NUL"
+#else
+#define BENCH_NULL_DEVICE "/dev/null"
+#endif
+
+typedef void (*BenchOp)(long iteration);
+
+int benchSize = 0;                        // Queue size of the current run
+volatile uintptr_t benchSink = 0;         // Keeps results observable
+
+double timeOps(BenchOp op, long ops, long *iteration) {
+    uint64_t start = metricsNow();
+    for (long i = 0; i < ops; i++) op((*iteration)++);
+    return (double)(metricsNow() - start);
+}
+
+/*
+ * Calibrates ops per repetition, then runs `reps` timed repetitions and
+ * prints one CSV row: mean/stddev/min/max ns per op and ops per second.
+ */
+void runBenchmark(const char *name, BenchOp op, int reps) {
+    long iteration = 0;
+
+    // Calibrate: double the batch until one batch takes long enough
+    long ops = 1;
+    while (ops < BENCH_MAX_OPS_PER_REP && timeOps(op, ops, &iteration) < BENCH_MIN_REP_NS) {
+        ops *= 2;
+    }
+
+    double sum = 0.0, sumSquares = 0.0, min = 0.0, max = 0.0;
+    for (int r = 0; r < reps; r++) {
+        double nsPerOp = timeOps(op, ops, &iteration) / (double)ops;
+        sum += nsPerOp;
+        sumSquares += nsPerOp * nsPerOp;
+        if (r == 0 || nsPerOp < min) min = nsPerOp;
+        if (r == 0 || nsPerOp > max) max = nsPerOp;
+    }
+
+    double mean = sum / reps;
+    double variance = reps > 1 ? (sumSquares - sum * mean) / (reps - 1) : 0.0;
+    if (variance < 0) variance = 0;
+
+    printf("%s,%d,%d,%ld,%.1f,%.1f,%.1f,%.1f,%.0f\n",
+           name, benchSize, reps, ops, mean, sqrt(variance), min, max, mean > 0 ? 1e9 / mean : 0.0);
+    fflush(stdout);
+}
+
+// Slot of the i-th ticket in a pseudo-random but repeatable order
+int benchSlot(long i) {
+    return (int)((front + (i * 7919L) % benchSize) % MAX_QUEUE_SIZE);
+}
+
+void toTicket(const struct GeneratedTicket *g, struct Ticket *t) {
+    memset(t, 0, sizeof(*t));
+    t->ticketID = g->id;
+    snprintf(t->customerName, sizeof(t->customerName), "%s", g->name);
+    snprintf(t->email, sizeof(t->email), "%s", g->email);
+    snprintf(t->product, sizeof(t->product), "%s", g->product);
+    snprintf(t->purchaseDate, sizeof(t->purchaseDate), "%s", g->date);
+    snprintf(t->issueDescription, sizeof(t->issueDescription), "%s", g->issue);
+    snprintf(t->priority, sizeof(t->priority), "%s", getAutoPriority(g->issue));
+}
+
+// Fills the queue with `size` generated tickets #1..#size aged 0-95 hours
+void fillQueue(int size) {
+    struct GenRng rng;
+    rng_seed(&rng, BENCH_SEED, 0);
+    resetQueue();
+
+    long now = (long)time(NULL);
+    for (int i = 0; i < size; i++) {
+        struct GeneratedTicket g;
+        generate_ticket(&rng, &g, i + 1, now);
+
+        struct Ticket t;
+        toTicket(&g, &t);
+        t.queueEntryTime = (time_t)(now - (long)(i % 96) * 3600);
+        enqueue(t);
+    }
+    benchSize = size;
+}
+
+/*
+ * Ingest benchmarks submit fresh tickets (unique email) drawn from a pool
+ * and dequeue as many, so the depth stays at benchSize. Each new ticket
+ * takes the ID of the one just dequeued, so IDs stay valid and unique at
+ * every queue size.
+ */
+struct Ticket ingestPool[BENCH_POOL_SIZE];
+struct Ticket ingestBatch[BENCH_BATCH_SIZE];
+FILE *ingestDb = NULL;
+long ingestCounter = 0;
+
+void fillIngestPool() {
+    struct GenRng rng;
+    rng_seed(&rng, BENCH_SEED, 1);
+    for (int i = 0; i < BENCH_POOL_SIZE; i++) {
+        struct GeneratedTicket g;
+        generate_ticket(&rng, &g, 0, (long)time(NULL));
+        toTicket(&g, &ingestPool[i]);
+    }
+}
+
+// Copies the fields rather than the struct: the pool is mostly unused issue
+// buffer, and a whole-struct copy would make it a cache-miss benchmark
+void nextIngestTicket(struct Ticket *t, int id) {
+    long n = ingestCounter++;
+    const struct Ticket *p = &ingestPool[n % BENCH_POOL_SIZE];
+    strcpy(t->customerName, p->customerName);
+    strcpy(t->product, p->product);
+    strcpy(t->purchaseDate, p->purchaseDate);
+    strcpy(t->issueDescription, p->issueDescription);
+    strcpy(t->priority, p->priority);
+    t->queueEntryTime = 0;
+    t->ticketID = id;
+    snprintf(t->email, sizeof(t->email), "i%ld@bench.invalid", n);
+}
+
+// Row-at-a-time path: dedup probe, enqueue, fprintf per ticket
+void opIngestTicket(long i) {
+    (void)i;
+    struct Ticket t, out;
+    dequeue(&out);
+    nextIngestTicket(&t, out.ticketID);
+    benchSink += (uintptr_t)ingestTicket(&t, time(NULL), ingestDb, NULL);
+}
+
+// Batch path, amortized per ticket: every batch-th call submits a whole batch
+void opEnqueueBatch(long i) {
+    int batch = benchSize < BENCH_BATCH_SIZE ? benchSize : BENCH_BATCH_SIZE;
+    if (i % batch != 0) return;
+
+    struct Ticket out;
+    for (int k = 0; k < batch; k++) {
+        dequeue(&out);
+        nextIngestTicket(&ingestBatch[k], out.ticketID);
+    }
+    benchSink += (uintptr_t)enqueueBatch(ingestBatch, batch, time(NULL), ingestDb, NULL);
+}
+
+/* ==================== BENCHMARKED OPERATIONS ==================== */
+
+// Steady state at a fixed depth: take the front ticket, requeue it at the rear
+void opEnqueueDequeue(long i) {
+    (void)i;
+    struct Ticket t;
+    dequeue(&t);
+    enqueue(t);
+}
+
+// Alternates hits (a queued ticket's email + issue) and misses
+void opIsDuplicateInQueue(long i) {
+    int slot = benchSlot(i);
+    const char *email = (i & 1) ? "nobody@bench.invalid" : queuedTicketText(slot, FIELD_EMAIL);
+    benchSink += (uintptr_t)isDuplicateInQueue(email, queuedTicketText(slot, FIELD_ISSUE));
+}
+
+void opGetAutoPriority(long i) {
+    benchSink += (uintptr_t)getAutoPriority(queuedTicketText(benchSlot(i), FIELD_ISSUE));
+}
+
+void opGetQueueStats(long i) {
+    (void)i;
+    int total, oldest, priorities[4];
+    double avgWait;
+    getQueueStats(&total, &avgWait, &oldest, priorities);
+    benchSink += (uintptr_t)total;
+}
+
+// First call escalates aged tickets; the rest measure the steady-state scan
+void opEscalateOldTickets(long i) {
+    (void)i;
+    escalateOldTickets();
+}
+
+void opLoadFromFile(long i) {
+    (void)i;
+    loadFromFile();
+}
+
+void opGenerateAdminHTML(long i) {
+    (void)i;
+    generateAdminHTML();
+}
+
+/* ==================== MAIN ==================== */
+
+int main(int argc, char *argv[]) {
+    static const int sizes[] = {100, 1000, 10000, 100000, MAX_TICKET_ID};
+    int maxSize = argc > 1 ? atoi(argv[1]) : MAX_TICKET_ID;
+    int reps = argc > 2 ? atoi(argv[2]) : 5;
+    if (reps < 2) reps = 2;
+
+    init_data();
+    startLogger();   // Production logging path (escalation messages)
+    fillIngestPool();
+    ingestDb = fopen(BENCH_NULL_DEVICE, "w");
+    reserveTicketIDs(0, MAX_TICKET_ID);   // No high-water-mark fsyncs inside the ingest loops
+
+    time_t now = time(NULL);
+    printf("# Smart Ticket Engine microbenchmarks\n");
+    printf("# date=%ld max_queue_size=%d reps=%d compiler=\"%s\"\n", (long)now, MAX_QUEUE_SIZE, reps, __VERSION__);
+    printf("benchmark,queue_size,reps,ops_per_rep,ns_per_op_mean,ns_per_op_stddev,ns_per_op_min,ns_per_op_max,ops_per_sec\n");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int size = sizes[s];
+        if (size > maxSize) break;
+        if (size > MAX_QUEUE_SIZE - 1) {
+            printf("# skipping size %d: rebuild with -DMAX_QUEUE_SIZE=%d\n", size, size + 1);
+            break;
+        }
+
+        fillQueue(size);
+        printf("# queue_size=%d text_arena_bytes_per_ticket=%.1f\n", size, (double)textArenaSize / size);
+        runBenchmark("enqueue_dequeue", opEnqueueDequeue, reps);
+        runBenchmark("is_duplicate_in_queue", opIsDuplicateInQueue, reps);
+        runBenchmark("get_auto_priority", opGetAutoPriority, reps);
+        runBenchmark("get_queue_stats", opGetQueueStats, reps);
+        runBenchmark("escalate_old_tickets", opEscalateOldTickets, reps);
+        if (ingestDb) {
+            runBenchmark("ingest_ticket", opIngestTicket, reps);
+            fillQueue(size);
+            runBenchmark("enqueue_batch", opEnqueueBatch, reps);
+            fillQueue(size);
+        }
+
+        saveQueueToFile();   // Database for loadFromFile() to parse
+        runBenchmark("load_from_file", opLoadFromFile, reps);
+        runBenchmark("generate_admin_html", opGenerateAdminHTML, reps);
+
+        // Same database with --cold-fields: the arena keeps only emails
+        coldFieldMode = 1;
+        runBenchmark("load_from_file_cold", opLoadFromFile, reps);
+        printf("# queue_size=%d cold_text_arena_bytes_per_ticket=%.1f\n", size, (double)textArenaSize / size);
+        runBenchmark("is_duplicate_in_queue_cold", opIsDuplicateInQueue, reps);
+        coldFieldMode = 0;
+    }
+
+    if (ingestDb) fclose(ingestDb);
+    stopLogger();
+    return 0;
+}
@@ -13,11 +13,25 @@
 
 // Maximum number of tickets in queue
 // Recommendation: 10000 for academic projects, scale up for production
+// (overridable with -DMAX_QUEUE_SIZE=..., e.g. by run_benchmarks.sh)
+#ifndef MAX_QUEUE_SIZE
 #define MAX_QUEUE_SIZE 10000
+#endif
 
 // Queue capacity warning threshold (percentage)
 #define QUEUE_WARNING_THRESHOLD 80  // Alert when 80% full
 
+// Queued ticket text is packed into a string arena in blocks rounded up
+// to ARENA_GRANULE bytes; the arena starts at ARENA_INITIAL_BYTES, doubles
+// as needed and reuses freed blocks of the same size first
+#define ARENA_GRANULE 16
+#define ARENA_INITIAL_BYTES (64 * 1024)
+
+// --cold-fields: queued tickets keep only ID, priority, times and email in
+// memory and read the rest from the mmapped active database; decoded rows
+// of the most recently used tickets are cached
+#define COLD_FIELD_CACHE_ENTRIES 256
+
 /* ==================== ESCALATION SETTINGS ==================== */
 
 // Hours between automatic priority escalations
@@ -42,23 +56,176 @@
 // 30 cycles * 500ms = every 15 seconds
 #define STATS_DISPLAY_CYCLES 30
 
+// Tickless event loop (Linux): the loop above is only the fallback.
+// Status line at most this often, and only after activity
+#define STATS_DISPLAY_SECONDS 15
+
+// Re-render the dashboard this often even without events, so the
+// Wait Time column (0.1h resolution) never drifts by more than a step
+#define DASHBOARD_REFRESH_SECONDS 360
+
+// The owner publishes a new queue view (an O(N) copy) at most this often,
+// and only once the renderer has taken the previous one
+#define VIEW_PUBLISH_INTERVAL_MS 100
+
+// Resolve-wait quantiles (dashboard and stats): streaming histograms per
+// priority and product whose weights halve every WAIT_SKETCH_HALF_LIFE_HOURS;
+// the dashboard lists the busiest DASHBOARD_PRODUCT_WAITS products
+#define WAIT_SKETCH_HALF_LIFE_HOURS 24
+#define DASHBOARD_PRODUCT_WAITS 8
+
 /* ==================== FILE PATHS ==================== */
 
 // Primary data files
 #define PENDING_TICKETS_FILE "customer_support_tickets_updated.csv"
-#define RESOLVED_TICKETS_FILE "resolved_tickets.csv"
-#define ADMIN_COMMANDS_FILE "admin_commands.txt"
+#define RESOLVED_TICKETS_FILE "resolved_tickets.csv"   // Legacy archive, moved into partitions at startup
+
+// Resolved archive: ARCHIVE_DIR/resolved-YYYY-MM.csv, one file per
+// ARCHIVE_PARTITION_MONTHS of resolve time (named after its first month;
+// fixed once an archive exists). The manifest lists
+// "<file> <first resolved> <last resolved> <rows>" per partition.
+#define ARCHIVE_DIR "archive"
+#define ARCHIVE_MANIFEST_FILE ARCHIVE_DIR "/manifest.txt"
+#define ARCHIVE_MANIFEST_TMP ARCHIVE_DIR "/manifest.txt.tmp"
+#define ARCHIVE_PARTITION_MONTHS 1
+
+// Delete partitions whose newest ticket was resolved longer ago (0 = keep all)
+#define ARCHIVE_RETENTION_DAYS 0
+
+// Columnar sidecar per partition (resolved-YYYY-MM.cols) for reports:
+// chunks of <magic u32> <rows u32>, then entry time and resolve time
+// (uint32 Unix seconds), product and admin (uint16 dictionary IDs) and
+// priority (uint8) columns, native byte order, padded to 8 bytes.
+// Dictionary lines are "product|admin <TAB> name"; an ID is the name's
+// position among its kind.
+#define ANALYTICS_DICTIONARY_FILE ARCHIVE_DIR "/columns.dict"
+
+// Window of REPORT requests and ./main --report without a day count
+#define REPORT_DEFAULT_DAYS 365
+
+// Longest window either accepts (a "day" report keeps a histogram per day);
+// with ARCHIVE_RETENTION_DAYS set, nothing older than retention plus one
+// partition is left to report on, so the window is clamped to that too
+#define REPORT_MAX_DAYS (5 * 366)
+
+// File-based ticket submission (when the engine socket is unavailable):
+// producers write a batch file (pending_tickets.csv columns) into
+// SPOOL_TMP_DIR and rename() it into SPOOL_NEW_DIR. The engine claims
+// files by moving them to SPOOL_CUR_DIR and deletes them once the
+// active database is fsynced. pending_tickets.csv is still claimed
+// whole for older producers.
+#define SPOOL_DIR "spool"
+#define SPOOL_TMP_DIR SPOOL_DIR "/tmp"
+#define SPOOL_NEW_DIR SPOOL_DIR "/new"
+#define SPOOL_CUR_DIR SPOOL_DIR "/cur"
+#define LEGACY_PENDING_FILE "pending_tickets.csv"
+#define SPOOL_LEGACY_CLAIMS_PER_SECOND 1000   // cur/<time>.<seq>.legacy.csv names
+
+// Claimed batch files are parsed on worker threads from this backlog on
+#define SPOOL_PARALLEL_MIN_FILES 8
+#define SPOOL_PARSE_THREADS 4
+
+// Append-only admin command journal: "<seq> <COMMAND> <args>" per line.
+// The engine records the last applied seq + offset in the state file and
+// appends "<seq> OK|ERR <message>" per command to the results file.
+// Commands take the socket requests' arguments (ENGINE SOCKET below),
+// space-separated; RESOLVE_MATCHING's product runs to the end of the line.
+#define ADMIN_COMMANDS_FILE "admin_commands.journal"
+#define ADMIN_COMMAND_STATE_FILE "admin_commands.state"
+#define ADMIN_COMMAND_RESULTS_FILE "admin_command_results.txt"
+
+// Longest journal line (bulk RESOLVE_IDS lists); producers split longer lists
+#define ADMIN_COMMAND_MAX_LINE 8192
+
+// Truncate the journal (once fully applied) / results file beyond this size
+#define ADMIN_JOURNAL_COMPACT_BYTES 65536
+
+// Result lines kept when the results file is compacted
+#define ADMIN_RESULTS_KEEP_LINES 256
+
+// Ticket ID high-water mark: the next unassigned ID, as text.
+// Producers lease blocks of IDs under flock (engine ALLOC request or directly).
+#define TICKET_ID_HWM_FILE "ticket_id.hwm"
+
+// Priority changes appended as "<id>,<priority>,<time>" and replayed on load;
+// folded into the active database after this many records
+#define PRIORITY_LOG_FILE "priority_updates.log"
+#define PRIORITY_LOG_COMPACT_RECORDS 256
+
+// Resolves append "<id>,<time>" tombstones here instead of rewriting the
+// active database; loadFromFile() skips listed IDs until compaction
+#define REMOVAL_LOG_FILE "resolved_removals.log"
+
+// Background compaction rewrites the active database (via the temp file)
+// once dead rows reach this share of it, and at least this many
+#define DATABASE_COMPACT_TMP "customer_support_tickets_updated.csv.compact"
+#define COMPACT_DEAD_PERCENT 50
+#define COMPACT_MIN_DEAD_ROWS 256
+
+// Memory-mapped queue index published by the engine (seqlock, see main.c)
+#define QUEUE_SNAPSHOT_FILE "queue_snapshot.shm"
+
+// Workload trace (engine started with --trace <file>): binary, append-only.
+//   header: TRACE_MAGIC, then per record
+//   <u8 type> <varint us since previous record> <payload>
+//   SUBMIT:       <varint id> <str name> <str email> <str product> <str date> <str issue>
+//   RESOLVE:      <varint id> <str admin>
+//   SET_PRIORITY: <varint id> <str priority> <str admin>
+// varint = unsigned LEB128, str = <varint length> <bytes>
+#define TRACE_MAGIC "STETRC1\n"
+#define TRACE_SUBMIT 1
+#define TRACE_RESOLVE 2
+#define TRACE_SET_PRIORITY 3
 
 // Log files
 #define ERROR_LOG_FILE "error_log.txt"
 #define OVERFLOW_LOG_FILE "overflow_log.txt"
 #define ESCALATION_LOG_FILE "escalation_log.txt"
 #define DUPLICATE_LOG_FILE "duplicate_tickets.log"
+#define ARCHIVE_LOG_FILE "archive_log.txt"
+
+// Prometheus text-format metrics, rewritten atomically at most this often
+// (and only when something was recorded)
+#define METRICS_FILE "ticket_engine.prom"
+#define METRICS_EXPORT_SECONDS 15
+
+// Async logger: ring slots (power of two), max message length, longest a
+// written line waits for its flush, and size-based rotation (file.1 ... file.KEEP)
+#define LOG_RING_SIZE 4096
+#define LOG_MESSAGE_MAX 512
+#define LOG_FLUSH_INTERVAL_MS 50
+#define LOG_ROTATE_BYTES (5L * 1024 * 1024)
+#define LOG_ROTATE_KEEP 3
 
 // Template files
 #define ADMIN_TEMPLATE "templates/admin_view.html"
 #define ADMIN_TEMPLATE_TMP "templates/admin_view.html.tmp"
 
+/* ==================== ENGINE SOCKET ==================== */
+
+// Unix domain socket for synchronous requests from Flask (Linux only).
+// Frames are a 4-byte big-endian length followed by tab-separated fields:
+//   SUBMIT <id> <name> <email> <product> <date> <issue> [submitted_ns]
+//   RESOLVE <id> <admin>
+//   RESOLVE_IDS <admin> <id>[,<id>...]                        -> OK <resolved>
+//   RESOLVE_MATCHING <admin> <priority|*> <min age hours> <product|*>  -> OK <resolved>
+//   RESOLVE_FIRST <count> <admin>                              -> OK <resolved>
+//   SET_PRIORITY <id> <priority> <admin>
+//   STATS                        -> OK total=.. avg_wait_hours=.. ... wait_<priority>=<p50>,<p90>,<p99> (s)
+//   QUERY <id> <email>
+//   DUPCHECK <email> <issue>
+//   ALLOC [count]                -> OK <first id> <count>
+//   METRICS                      -> OK <stage> <count> <p50 us> <p99 us> <max us> ...
+//   REPORT <priority|product|admin|day> [days, at most REPORT_MAX_DAYS]
+//                                -> OK <count> <p50 s> <p90 s> <p99 s> <group> ...
+// Replies start with OK, DUPLICATE, UNAUTHORIZED, NOT_FOUND or ERR.
+// submitted_ns is CLOCK_MONOTONIC; it feeds the submit_to_queued histogram.
+#define ENGINE_SOCKET_PATH "ticket_engine.sock"
+
+// Simultaneous client connections and largest accepted frame (bytes)
+#define MAX_SOCKET_CLIENTS 64
+#define MAX_FRAME_SIZE 8192
+
 /* ==================== VALIDATION LIMITS ==================== */
 
 // Ticket field length limits
@@ -66,13 +233,19 @@
 #define MAX_EMAIL_LEN 99
 #define MAX_PRODUCT_LEN 99
 #define MAX_PURCHASE_DATE_LEN 49
-#define MAX_ISSUE_DESC_LEN 199
+#define MAX_ISSUE_DESC_LEN 2047   // Web form's 500 characters, UTF-8 encoded
 #define MAX_PRIORITY_LEN 19
 
 // Ticket ID validation range
 #define MIN_TICKET_ID 1
 #define MAX_TICKET_ID 999999
 
+// ID allocator: first ID handed out on an empty system, default and
+// largest block size per lease
+#define FIRST_ALLOCATED_TICKET_ID 1001
+#define TICKET_ID_LEASE_SIZE 50
+#define MAX_TICKET_ID_LEASE 100000
+
 // Email validation
 #define MIN_EMAIL_LEN 3
 
@@ -86,6 +259,8 @@
 #define TICKET_ERROR_INVALID_DATA -3
 #define TICKET_ERROR_QUEUE_FULL -4
 #define TICKET_ERROR_QUEUE_EMPTY -5
+#define TICKET_ERROR_DUPLICATE -6
+#define TICKET_ERROR_NOT_FOUND -7
 
 /* ==================== DUPLICATE DETECTION ==================== */
 
@@ -100,4 +275,7 @@
 // Maximum number of previous tickets to retrieve
 #define MAX_CUSTOMER_HISTORY 10
 
+// Initial slot count of the in-memory history index (power of two, grows x2)
+#define HISTORY_INDEX_INITIAL_CAPACITY 1024
+
 #endif /* CONFIG_H */
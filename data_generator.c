@@ -3,10 +3,44 @@
 #include <string.h>
 #include <time.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <math.h>
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <pthread.h>
+    #include <poll.h>
+    #include <sys/file.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+#endif
 
 // CONFIGURATION: Direct access to main database
 #define DB_FILE "customer_support_tickets_updated.csv"
 #define CONFIG_FILE "GENERATOR_CONFIG.json"
+#define ID_HWM_FILE "ticket_id.hwm"   // Same file as TICKET_ID_HWM_FILE in config.h
+#define MAX_TICKET_ID 999999          // Same limits as config.h
+#define MAX_TICKET_ID_LEASE 100000
+#define DB_HEADER "Ticket ID,Customer Name,Customer Email,Product,Purchase Date,Issue Description,Priority,Queue Entry Time\n"
+
+// Bulk mode: rows per independently seeded chunk, and worst-case bytes per row
+#define BULK_CHUNK_ROWS 16384
+#define BULK_MAX_ROW_BYTES 1024
+#define BULK_MAX_THREADS 64
+
+// Stream mode: engine socket (ENGINE_SOCKET_PATH in config.h), IDs leased
+// per block, bursty profile shape, and how long to wait for late replies
+#define ENGINE_SOCKET "ticket_engine.sock"
+#define ENGINE_MAX_FRAME 8192   // MAX_FRAME_SIZE in config.h
+#define STREAM_ID_BLOCK 1000
+#define STREAM_BURST_DUTY 0.2
+#define STREAM_DRAIN_SECONDS 10
+
+// Workload trace format, same as TRACE_* in config.h
+#define TRACE_MAGIC "STETRC1\n"
+#define TRACE_SUBMIT 1
+#define TRACE_RESOLVE 2
+#define TRACE_SET_PRIORITY 3
 
 // ==================== DATA STRUCTURES ====================
 
@@ -20,6 +54,8 @@ char first_names[MAX_NAMES][STR_LEN];
 int first_name_count = 0;
 char last_names[MAX_NAMES][STR_LEN];
 int last_name_count = 0;
+char first_names_lower[MAX_NAMES][STR_LEN];   // Email local parts, lowered once at load
+char last_names_lower[MAX_NAMES][STR_LEN];
 char domains[20][STR_LEN];
 int domain_count = 0;
 char suffixes[MAX_SENTENCES][STR_LEN];
@@ -37,12 +73,50 @@ int product_count = 0;
 
 const char *priorities[] = {"Low", "Medium", "High", "Critical"};
 
-// ==================== UTILS ====================
+// ==================== RANDOM NUMBERS ====================
+// DESIGN DECISION: xoshiro256** instead of rand()
+// rand() is slow, has one hidden global state and differs between libcs.
+// xoshiro256** is a few shifts per number and each stream is a plain struct,
+// so every bulk chunk gets its own stream derived from (seed, chunk) and the
+// output is identical for a given seed no matter how many threads run.
 
-int randomInt(int min, int max) {
-    return min + rand() % (max - min + 1);
+struct GenRng {
+    uint64_t s[4];
+};
+
+uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(struct GenRng *rng, uint64_t seed, uint64_t stream) {
+    uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    for (int i = 0; i < 4; i++) rng->s[i] = splitmix64(&x);
 }
 
+uint64_t rng_next(struct GenRng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = ((s[1] * 5) << 7 | (s[1] * 5) >> 57) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+    return result;
+}
+
+// Uniform-enough integer in [min, max] (multiply-shift, no modulo)
+int randomInt(struct GenRng *rng, int min, int max) {
+    uint64_t span = (uint64_t)(max - min + 1);
+    return min + (int)(((rng_next(rng) >> 32) * span) >> 32);
+}
+
+// ==================== UTILS ====================
+
 char* read_file(const char* filename) {
     FILE *f = fopen(filename, "rb");
     if (!f) return NULL;
@@ -58,6 +132,40 @@ char* read_file(const char* filename) {
     return buffer;
 }
 
+// String builders used instead of sprintf on the per-row path.
+// Each returns the new end of the output.
+char* append_text(char *out, const char *text) {
+    while (*text) *out++ = *text++;
+    return out;
+}
+
+char* append_long(char *out, long value) {
+    char digits[24];
+    int n = 0;
+    if (value < 0) { *out++ = '-'; value = -value; }
+    do { digits[n++] = (char)('0' + value % 10); value /= 10; } while (value);
+    while (n) *out++ = digits[--n];
+    return out;
+}
+
+char* append_quoted(char *out, const char *text) {
+    *out++ = '"';
+    out = append_text(out, text);
+    *out++ = '"';
+    return out;
+}
+
+// Like append_text, but never writes past `limit` (caller terminates)
+char* append_bounded(char *out, const char *limit, const char *text) {
+    while (*text && out < limit) *out++ = *text++;
+    return out;
+}
+
+char* append_padded(char *out, int value, int width) {
+    for (int div = (width == 4) ? 1000 : 10; div; div /= 10) *out++ = (char)('0' + (value / div) % 10);
+    return out;
+}
+
 // ==================== JSON PARSER ====================
 // (Simplified parser as provided before)
 
@@ -148,6 +256,13 @@ void init_data() {
     detail_count = parse_json_array(json, "details", details);
     load_products(json);
     free(json);
+
+    for (int i = 0; i < first_name_count; i++) {
+        for (int k = 0; (first_names_lower[i][k] = tolower((unsigned char)first_names[i][k])); k++);
+    }
+    for (int i = 0; i < last_name_count; i++) {
+        for (int k = 0; (last_names_lower[i][k] = tolower((unsigned char)last_names[i][k])); k++);
+    }
 }
 
 // ==================== LOGIC ====================
@@ -172,27 +287,1010 @@ int get_next_id() {
     return max_id + 1;
 }
 
-void get_product_and_issue(char *prod_buf, char *issue_buf) {
+// Reserve `count` consecutive IDs from the shared high-water mark.
+// Same protocol and limits as the engine's reserveTicketIDs(): flock, read
+// next ID, write next + count. Returns the first ID, or -1 (mark untouched)
+// if count is not 1..max_block or the block would pass MAX_TICKET_ID.
+long lease_ids(long count, long max_block) {
+    if (count < 1 || count > max_block) {
+        printf(" Error: cannot lease %ld ticket IDs at once (1-%ld)\n", count, max_block);
+        return -1;
+    }
+    char buf[32] = "";
+#ifndef _WIN32
+    int fd = open(ID_HWM_FILE, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return get_next_id();
+    flock(fd, LOCK_EX);
+    ssize_t got = pread(fd, buf, sizeof(buf) - 1, 0);
+    buf[got > 0 ? got : 0] = '\0';
+#else
+    FILE *in = fopen(ID_HWM_FILE, "r");
+    if (in) {
+        if (!fgets(buf, sizeof(buf), in)) buf[0] = '\0';
+        fclose(in);
+    }
+#endif
+
+    // No mark yet: seed it from the database once
+    long first = atol(buf);
+    if (first <= 0) first = get_next_id();
+
+    if (first + count - 1 > MAX_TICKET_ID) {
+        printf(" Error: ticket ID space exhausted (next #%ld, %ld requested, max #%d)\n",
+               first, count, MAX_TICKET_ID);
+#ifndef _WIN32
+        flock(fd, LOCK_UN);
+        close(fd);
+#endif
+        return -1;
+    }
+
+    int len = sprintf(buf, "%ld\n", first + count);
+#ifndef _WIN32
+    if (ftruncate(fd, 0) != 0 || pwrite(fd, buf, len, 0) != len || fsync(fd) != 0) {
+        printf(" Warning: could not update %s\n", ID_HWM_FILE);
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+#else
+    FILE *out = fopen(ID_HWM_FILE, "w");
+    if (out) { fwrite(buf, 1, len, out); fclose(out); }
+#endif
+    return first;
+}
+
+void get_product_and_issue(struct GenRng *rng, char *prod_buf, size_t prod_size, char *issue_buf, size_t issue_size) {
     if (product_count == 0) {
         strcpy(prod_buf, "Unknown");
         strcpy(issue_buf, "Unknown issue");
         return;
     }
-    int p_idx = randomInt(0, product_count - 1);
-    strcpy(prod_buf, products[p_idx].name);
+    int p_idx = randomInt(rng, 0, product_count - 1);
+    *append_bounded(prod_buf, prod_buf + prod_size - 1, products[p_idx].name) = '\0';
     
     const char *keyword = "issue";
     if (products[p_idx].keyword_count > 0) {
-        keyword = products[p_idx].keywords[randomInt(0, products[p_idx].keyword_count - 1)];
+        keyword = products[p_idx].keywords[randomInt(rng, 0, products[p_idx].keyword_count - 1)];
     }
-    const char *suf = (suffix_count > 0) ? suffixes[randomInt(0, suffix_count - 1)] : "broken";
-    const char *det = (detail_count > 0) ? details[randomInt(0, detail_count - 1)] : "help";
+    const char *suf = (suffix_count > 0) ? suffixes[randomInt(rng, 0, suffix_count - 1)] : "broken";
+    const char *det = (detail_count > 0) ? details[randomInt(rng, 0, detail_count - 1)] : "help";
     
-    sprintf(issue_buf, "%s %s ; %s", keyword, suf, det);
+    // "<keyword> <suffix> ; <detail>"
+    const char *limit = issue_buf + issue_size - 1;
+    char *p = append_bounded(issue_buf, limit, keyword);
+    p = append_bounded(p, limit, " ");
+    p = append_bounded(p, limit, suf);
+    p = append_bounded(p, limit, " ; ");
+    *append_bounded(p, limit, det) = '\0';
+}
+
+// One synthetic ticket, as written to the database
+struct GeneratedTicket {
+    int id;
+    char name[100];
+    char email[100];
+    char product[50];
+    char date[20];
+    char issue[256];
+    const char *priority;
+    long entry_time;
+};
+
+// Fills `g` with a random but realistic ticket (call init_data() first)
+void generate_ticket(struct GenRng *rng, struct GeneratedTicket *g, int id, long current_time) {
+    g->id = id;
+
+    int f = randomInt(rng, 0, first_name_count - 1);
+    int l = randomInt(rng, 0, last_name_count - 1);
+    const char *limit = g->name + sizeof(g->name) - 1;
+    char *p = append_bounded(g->name, limit, first_names[f]);
+    p = append_bounded(p, limit, " ");
+    *append_bounded(p, limit, last_names[l]) = '\0';
+
+    // first.last<1-999>@domain, lowercase
+    char number[8];
+    *append_long(number, randomInt(rng, 1, 999)) = '\0';
+    limit = g->email + sizeof(g->email) - 1;
+    p = append_bounded(g->email, limit, first_names_lower[f]);
+    p = append_bounded(p, limit, ".");
+    p = append_bounded(p, limit, last_names_lower[l]);
+    p = append_bounded(p, limit, number);
+    p = append_bounded(p, limit, "@");
+    *append_bounded(p, limit, domains[randomInt(rng, 0, domain_count - 1)]) = '\0';
+
+    get_product_and_issue(rng, g->product, sizeof(g->product), g->issue, sizeof(g->issue));
+
+    // YYYY-MM-DD
+    p = append_padded(g->date, randomInt(rng, 2023, 2025), 4);
+    *p++ = '-';
+    p = append_padded(p, randomInt(rng, 1, 12), 2);
+    *p++ = '-';
+    *append_padded(p, randomInt(rng, 1, 28), 2) = '\0';
+    g->priority = priorities[randomInt(rng, 0, 3)];
+
+    // Spread timestamps slightly into the past (e.g., last 10 mins) so they don't look instant
+    g->entry_time = current_time - randomInt(rng, 0, 600);
+}
+
+// ==================== BULK MODE ====================
+// Rows are formatted by hand into per-thread blocks (no printf per field)
+// and each finished block goes out in a single fwrite.
+
+// One CSV row in the same layout as the interactive fprintf
+char* format_ticket_row(char *out, const struct GeneratedTicket *g) {
+    out = append_long(out, g->id);              *out++ = ',';
+    out = append_quoted(out, g->name);          *out++ = ',';
+    out = append_quoted(out, g->email);         *out++ = ',';
+    out = append_quoted(out, g->product);       *out++ = ',';
+    out = append_text(out, g->date);            *out++ = ',';
+    out = append_quoted(out, g->issue);         *out++ = ',';
+    out = append_text(out, g->priority);        *out++ = ',';
+    out = append_long(out, g->entry_time);      *out++ = '\n';
+    return out;
+}
+
+struct BulkJob {
+    uint64_t seed;
+    long now;
+    long first_id;
+    long total_rows;
+    long chunk;          // Rows [chunk * BULK_CHUNK_ROWS, +BULK_CHUNK_ROWS)
+    char *buffer;        // BULK_CHUNK_ROWS * BULK_MAX_ROW_BYTES bytes
+    size_t length;       // Bytes produced
+};
+
+void* generate_chunk(void *arg) {
+    struct BulkJob *job = arg;
+    struct GenRng rng;
+    rng_seed(&rng, job->seed, (uint64_t)job->chunk);
+
+    long start = job->chunk * BULK_CHUNK_ROWS;
+    long end = start + BULK_CHUNK_ROWS;
+    if (end > job->total_rows) end = job->total_rows;
+
+    char *p = job->buffer;
+    for (long row = start; row < end; row++) {
+        struct GeneratedTicket g;
+        generate_ticket(&rng, &g, (int)(job->first_id + row), job->now);
+        p = format_ticket_row(p, &g);
+    }
+    job->length = (size_t)(p - job->buffer);
+    return NULL;
+}
+
+/*
+ * Generates `count` rows starting at `first_id` and appends them to `path`.
+ * Work is cut into BULK_CHUNK_ROWS chunks; each wave hands one chunk to each
+ * thread, then writes the finished blocks in chunk order. Because every
+ * chunk has its own RNG stream, the bytes depend only on seed/now/first_id.
+ */
+int generate_bulk(const char *path, long count, uint64_t seed, int threads, long now, long first_id) {
+    FILE *fp = fopen(path, "ab");
+    if (!fp) {
+        printf(" Error opening %s!\n", path);
+        return 1;
+    }
+    fseek(fp, 0, SEEK_END);
+    if (ftell(fp) == 0) fputs(DB_HEADER, fp);
+
+    size_t chunkBytes = (size_t)BULK_CHUNK_ROWS * BULK_MAX_ROW_BYTES;
+    long chunks = (count + BULK_CHUNK_ROWS - 1) / BULK_CHUNK_ROWS;
+    if (threads > chunks) threads = (int)chunks;
+    if (threads > BULK_MAX_THREADS) threads = BULK_MAX_THREADS;
+    if (threads < 1) threads = 1;
+
+    char *buffers = malloc(chunkBytes * threads);
+    if (!buffers) {
+        printf(" Error: out of memory for %d generation buffers\n", threads);
+        fclose(fp);
+        return 1;
+    }
+
+    int status = 0;
+    for (long wave = 0; wave < chunks && status == 0; wave += threads) {
+        int active = (int)(chunks - wave < threads ? chunks - wave : threads);
+        struct BulkJob jobs[BULK_MAX_THREADS];
+        for (int t = 0; t < active; t++) {
+            jobs[t] = (struct BulkJob){seed, now, first_id, count, wave + t, buffers + t * chunkBytes, 0};
+        }
+
+#ifndef _WIN32
+        pthread_t workers[BULK_MAX_THREADS];
+        int started[BULK_MAX_THREADS];
+        for (int t = 0; t < active; t++) {
+            started[t] = pthread_create(&workers[t], NULL, generate_chunk, &jobs[t]) == 0;
+            if (!started[t]) generate_chunk(&jobs[t]);
+        }
+        for (int t = 0; t < active; t++) {
+            if (started[t]) pthread_join(workers[t], NULL);
+        }
+#else
+        for (int t = 0; t < active; t++) generate_chunk(&jobs[t]);
+#endif
+
+        for (int t = 0; t < active; t++) {
+            if (fwrite(jobs[t].buffer, 1, jobs[t].length, fp) != jobs[t].length) {
+                printf(" Error writing %s\n", path);
+                status = 1;
+                break;
+            }
+        }
+    }
+
+    free(buffers);
+    if (fclose(fp) != 0 && status == 0) {
+        printf(" Error writing %s\n", path);
+        status = 1;
+    }
+    return status;
 }
 
-int main() {
-    srand(time(NULL));
+// ==================== STREAM MODE ====================
+/*
+ * DESIGN DECISION: Open-loop load through the engine socket
+ * Bulk mode appends straight to the database and skips ingestion. Stream
+ * mode sends SUBMIT frames to the running engine, so every ticket goes
+ * through duplicate detection, auto-priority and enqueue. Arrivals follow
+ * a precomputed schedule and are never held back waiting for replies
+ * (open loop): a slow engine shows up as latency, not as a lower offered
+ * rate. Latency runs from the scheduled send time to the reply, and the
+ * same timestamp travels in the frame for the engine's own histogram.
+ * Replay mode drives the same loop from a captured trace.
+ */
+
+#ifndef _WIN32
+
+#define LAT_SUB_BITS 3
+#define LAT_SUB_BUCKETS (1 << LAT_SUB_BITS)
+#define LAT_BUCKETS ((64 - LAT_SUB_BITS) * LAT_SUB_BUCKETS)
+
+enum RequestKind { REQ_SUBMIT, REQ_RESOLVE, REQ_SET_PRIORITY, REQ_KIND_COUNT };
+
+const char *request_kind_names[REQ_KIND_COUNT] = {"submit", "resolve", "set_priority"};
+
+struct StreamConfig {
+    double rate;            // Mean arrivals per second
+    double duration;        // Seconds of arrivals
+    int bursty;             // 0 = Poisson, 1 = on/off modulated Poisson
+    double burst_factor;    // Peak rate = rate * burst_factor
+    double burst_period;    // Seconds per on/off cycle
+    uint64_t seed;
+    const char *socket_path;
+};
+
+struct LatencyHist {
+    uint64_t counts[LAT_BUCKETS];
+    uint64_t max_ns;
+};
+
+struct LoadStats {
+    long sent[REQ_KIND_COUNT], ok[REQ_KIND_COUNT], failed[REQ_KIND_COUNT];
+    long duplicates, queue_full;                  // SUBMIT rejections
+    struct LatencyHist latency[REQ_KIND_COUNT];   // Successful requests only
+};
+
+uint64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Log-linear bucket, same layout as the engine's latency histograms
+int latency_bucket(uint64_t ns) {
+    if (ns < LAT_SUB_BUCKETS) return (int)ns;
+    int msb = 63 - __builtin_clzll(ns);
+    int shift = msb - LAT_SUB_BITS;
+    int index = (shift + 1) * LAT_SUB_BUCKETS + (int)((ns >> shift) & (LAT_SUB_BUCKETS - 1));
+    return index < LAT_BUCKETS ? index : LAT_BUCKETS - 1;
+}
+
+uint64_t latency_bucket_high(int index) {
+    int major = index / LAT_SUB_BUCKETS;
+    uint64_t sub = (uint64_t)(index % LAT_SUB_BUCKETS);
+    if (major == 0) return sub;
+    return ((LAT_SUB_BUCKETS + sub + 1) << (major - 1)) - 1;
+}
+
+uint64_t latency_quantile(const struct LatencyHist *h, double q) {
+    uint64_t total = 0;
+    for (int i = 0; i < LAT_BUCKETS; i++) total += h->counts[i];
+    if (total == 0) return 0;
+    uint64_t rank = (uint64_t)(q * (double)total);
+    if (rank >= total) rank = total - 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen > rank) return latency_bucket_high(i) < h->max_ns ? latency_bucket_high(i) : h->max_ns;
+    }
+    return h->max_ns;
+}
+
+// Arrival rate at `t` seconds into the run
+double stream_rate_at(const struct StreamConfig *cfg, double t) {
+    if (!cfg->bursty) return cfg->rate;
+    double phase = fmod(t, cfg->burst_period) / cfg->burst_period;
+    if (phase < STREAM_BURST_DUTY) return cfg->rate * cfg->burst_factor;
+    // Quiet part carries the rest, so the mean stays at cfg->rate
+    return cfg->rate * (1.0 - cfg->burst_factor * STREAM_BURST_DUTY) / (1.0 - STREAM_BURST_DUTY);
+}
+
+// Next arrival after `t` (seconds), by thinning a Poisson process at the peak rate
+double stream_next_arrival(struct GenRng *rng, const struct StreamConfig *cfg, double t) {
+    double peak = cfg->bursty ? cfg->rate * cfg->burst_factor : cfg->rate;
+    while (1) {
+        double u = ((double)(rng_next(rng) >> 11) + 1.0) / 9007199254740993.0;   // (0, 1]
+        t += -log(u) / peak;
+        if (!cfg->bursty) return t;
+        double accept = (double)(rng_next(rng) >> 11) / 9007199254740992.0;
+        if (accept * peak < stream_rate_at(cfg, t)) return t;
+    }
+}
+
+// Growable byte buffer for frames not yet accepted by the socket
+struct Outbox {
+    char *data;
+    size_t len, sent, cap;
+};
+
+int outbox_reserve(struct Outbox *o, size_t extra) {
+    if (o->sent > 0 && o->sent == o->len) o->len = o->sent = 0;
+    if (o->len + extra <= o->cap) return 1;
+    if (o->sent > 0) {
+        memmove(o->data, o->data + o->sent, o->len - o->sent);
+        o->len -= o->sent;
+        o->sent = 0;
+        if (o->len + extra <= o->cap) return 1;
+    }
+    size_t cap = o->cap ? o->cap : 65536;
+    while (o->len + extra > cap) cap *= 2;
+    char *data = realloc(o->data, cap);
+    if (!data) return 0;
+    o->data = data;
+    o->cap = cap;
+    return 1;
+}
+
+// Opens a length-prefixed frame; returns where its payload starts
+char* frame_begin(struct Outbox *o) {
+    if (!outbox_reserve(o, 4 + ENGINE_MAX_FRAME)) return NULL;
+    return o->data + o->len + 4;
+}
+
+// Closes the frame whose payload runs from frame_begin() to `end`
+void frame_end(struct Outbox *o, const char *end) {
+    size_t len = (size_t)(end - (o->data + o->len + 4));
+    unsigned char *header = (unsigned char *)o->data + o->len;
+    header[0] = (unsigned char)(len >> 24);
+    header[1] = (unsigned char)(len >> 16);
+    header[2] = (unsigned char)(len >> 8);
+    header[3] = (unsigned char)len;
+    o->len += 4 + len;
+}
+
+// Requests still waiting for a reply, in send order (FIFO ring)
+struct InFlightEntry {
+    uint64_t due;           // Scheduled send time
+    int kind;
+};
+
+struct InFlight {
+    struct InFlightEntry *entries;
+    size_t head, count, cap;
+};
+
+int inflight_push(struct InFlight *f, uint64_t due, int kind) {
+    if (f->count == f->cap) {
+        size_t cap = f->cap ? f->cap * 2 : 4096;
+        struct InFlightEntry *entries = malloc(cap * sizeof(struct InFlightEntry));
+        if (!entries) return 0;
+        for (size_t i = 0; i < f->count; i++) entries[i] = f->entries[(f->head + i) % f->cap];
+        free(f->entries);
+        f->entries = entries;
+        f->head = 0;
+        f->cap = cap;
+    }
+    f->entries[(f->head + f->count) % f->cap] = (struct InFlightEntry){due, kind};
+    f->count++;
+    return 1;
+}
+
+struct InFlightEntry inflight_pop(struct InFlight *f) {
+    struct InFlightEntry e = f->entries[f->head];
+    f->head = (f->head + 1) % f->cap;
+    f->count--;
+    return e;
+}
+
+// SUBMIT frame carrying `submitted_ns` for the engine's histogram
+int queue_submit_frame(struct Outbox *o, long id, const char *name, const char *email,
+                       const char *product, const char *date, const char *issue, uint64_t submitted_ns) {
+    char *p = frame_begin(o);
+    if (!p) return 0;
+    p = append_text(p, "SUBMIT\t");
+    p = append_long(p, id);               *p++ = '\t';
+    p = append_text(p, name);             *p++ = '\t';
+    p = append_text(p, email);            *p++ = '\t';
+    p = append_text(p, product);          *p++ = '\t';
+    p = append_text(p, date);             *p++ = '\t';
+    p = append_text(p, issue);            *p++ = '\t';
+    p = append_long(p, (long)submitted_ns);
+    frame_end(o, p);
+    return 1;
+}
+
+void record_reply(struct LoadStats *st, int kind, const char *reply, uint64_t latency_ns) {
+    if (strncmp(reply, "OK", 2) == 0) {
+        struct LatencyHist *h = &st->latency[kind];
+        st->ok[kind]++;
+        h->counts[latency_bucket(latency_ns)]++;
+        if (latency_ns > h->max_ns) h->max_ns = latency_ns;
+        return;
+    }
+    st->failed[kind]++;
+    if (kind != REQ_SUBMIT) return;
+    if (strncmp(reply, "DUPLICATE", 9) == 0) st->duplicates++;
+    else if (strstr(reply, "Queue full")) st->queue_full++;
+}
+
+// Parses every complete reply frame in `in`; returns 0 on a protocol error
+int consume_replies(char *in, size_t *in_len, struct InFlight *pending, struct LoadStats *st, uint64_t now) {
+    size_t pos = 0;
+    while (*in_len - pos >= 4) {
+        const unsigned char *h = (const unsigned char *)in + pos;
+        size_t len = ((size_t)h[0] << 24) | ((size_t)h[1] << 16) | ((size_t)h[2] << 8) | (size_t)h[3];
+        if (len >= 1024 || pending->count == 0) return 0;
+        if (*in_len - pos < 4 + len) break;
+
+        char reply[1024];
+        memcpy(reply, in + pos + 4, len);
+        reply[len] = '\0';
+        struct InFlightEntry e = inflight_pop(pending);
+        record_reply(st, e.kind, reply, now - e.due);
+        pos += 4 + len;
+    }
+    memmove(in, in + pos, *in_len - pos);
+    *in_len -= pos;
+    return 1;
+}
+
+int connect_engine(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+/*
+ * A request schedule for drive_engine(). next() returns the send offset
+ * (ns after start) of the following request, or -1 when there are no
+ * more; emit() then appends that request's frame and returns its kind
+ * (-1 on failure).
+ */
+struct LoadSource {
+    void *ctx;
+    int64_t (*next)(void *ctx);
+    int (*emit)(void *ctx, struct Outbox *out, uint64_t due_ns);
+};
+
+/*
+ * Sends every request of `src` at its scheduled time, never waiting for
+ * replies, then waits up to STREAM_DRAIN_SECONDS for the remaining ones.
+ * Prints a progress line per second. *elapsed_ns covers the schedule and
+ * the last reply. Returns 0 on success.
+ */
+int drive_engine(int fd, struct LoadSource *src, struct LoadStats *st, uint64_t *elapsed_ns) {
+    struct Outbox out = {NULL, 0, 0, 0};
+    struct InFlight pending = {NULL, 0, 0, 0};
+    char in[8192];
+    size_t in_len = 0;
+    int status = 0;
+
+    uint64_t start = monotonic_ns();
+    int64_t offset = src->next(src->ctx);
+    uint64_t last_event = start, deadline = 0, next_report = start + 1000000000ULL;
+
+    while (1) {
+        uint64_t now = monotonic_ns();
+
+        // Everything scheduled up to now goes out, however far behind we are
+        while (offset >= 0 && start + (uint64_t)offset <= now) {
+            uint64_t due = start + (uint64_t)offset;
+            int kind = src->emit(src->ctx, &out, due);
+            if (kind < 0 || !inflight_push(&pending, due, kind)) {
+                printf(" Error: cannot queue a request with %zu in flight\n", pending.count);
+                status = 1;
+                break;
+            }
+            st->sent[kind]++;
+            last_event = due;
+            offset = src->next(src->ctx);
+        }
+        if (status) break;
+        if (offset < 0 && deadline == 0) deadline = now + (uint64_t)STREAM_DRAIN_SECONDS * 1000000000ULL;
+
+        while (out.sent < out.len) {
+            ssize_t w = send(fd, out.data + out.sent, out.len - out.sent, MSG_NOSIGNAL);
+            if (w <= 0) break;
+            out.sent += (size_t)w;
+        }
+
+        while (1) {
+            ssize_t r = recv(fd, in + in_len, sizeof(in) - in_len, 0);
+            if (r == 0) {
+                printf(" Error: engine closed the connection\n");
+                status = 1;
+                break;
+            }
+            if (r < 0) break;   // EAGAIN: nothing more for now
+            in_len += (size_t)r;
+            now = monotonic_ns();
+            if (!consume_replies(in, &in_len, &pending, st, now)) {
+                printf(" Error: unexpected reply from engine\n");
+                status = 1;
+                break;
+            }
+            last_event = now;
+        }
+        if (status) break;
+
+        if (now >= next_report && offset >= 0) {
+            long sent = 0, ok = 0;
+            for (int k = 0; k < REQ_KIND_COUNT; k++) { sent += st->sent[k]; ok += st->ok[k]; }
+            printf("  t=%3.0fs  sent %-8ld ok %-8ld in flight %zu\n",
+                   (now - start) / 1e9, sent, ok, pending.count);
+            fflush(stdout);
+            next_report += 1000000000ULL;
+        }
+
+        if (offset < 0 && out.sent == out.len && pending.count == 0) break;
+        if (deadline && now >= deadline) {
+            printf(" Warning: %zu replies still outstanding after %ds\n", pending.count, STREAM_DRAIN_SECONDS);
+            break;
+        }
+
+        uint64_t wake = offset >= 0 ? start + (uint64_t)offset : deadline;
+        if (offset >= 0 && next_report < wake) wake = next_report;
+        int timeout_ms = wake > now ? (int)((wake - now + 999999) / 1000000) : 0;
+        struct pollfd pfd = {fd, POLLIN | (out.sent < out.len ? POLLOUT : 0), 0};
+        poll(&pfd, 1, timeout_ms);
+    }
+
+    *elapsed_ns = last_event - start;
+    free(out.data);
+    free(pending.entries);
+    return status;
+}
+
+// Random tickets at the configured arrival profile
+struct StreamSource {
+    const struct StreamConfig *cfg;
+    struct GenRng rng;
+    double arrival;         // Seconds after start of the next ticket
+    int next_id, ids_left;
+};
+
+int64_t stream_next(void *ctx) {
+    struct StreamSource *s = ctx;
+    double t = s->arrival;
+    if (t >= s->cfg->duration) return -1;
+    s->arrival = stream_next_arrival(&s->rng, s->cfg, t);
+    return (int64_t)(t * 1e9);
+}
+
+int stream_emit(void *ctx, struct Outbox *out, uint64_t due_ns) {
+    struct StreamSource *s = ctx;
+    if (s->ids_left == 0) {
+        long first = lease_ids(STREAM_ID_BLOCK, MAX_TICKET_ID_LEASE);
+        if (first < 0) return -1;
+        s->next_id = (int)first;
+        s->ids_left = STREAM_ID_BLOCK;
+    }
+    struct GeneratedTicket g;
+    generate_ticket(&s->rng, &g, s->next_id++, (long)time(NULL));
+    s->ids_left--;
+    return queue_submit_frame(out, g.id, g.name, g.email, g.product, g.date, g.issue, due_ns) ? REQ_SUBMIT : -1;
+}
+
+void print_stream_report(const struct StreamConfig *cfg, const struct LoadStats *st, double elapsed) {
+    const struct LatencyHist *h = &st->latency[REQ_SUBMIT];
+    long sent = st->sent[REQ_SUBMIT], queued = st->ok[REQ_SUBMIT], failed = st->failed[REQ_SUBMIT];
+
+    printf("\n Stream finished: %.1fs, %s profile, target %.1f tickets/s\n",
+           elapsed, cfg->bursty ? "bursty" : "poisson", cfg->rate);
+    printf("   Submitted:   %ld (%.1f/s)\n", sent, sent / cfg->duration);
+    printf("   Queued:      %ld (%.1f/s sustained)\n", queued, elapsed > 0 ? queued / elapsed : 0.0);
+    printf("   Duplicates:  %ld   Queue full: %ld   Errors: %ld   No reply: %ld\n",
+           st->duplicates, st->queue_full, failed - st->duplicates - st->queue_full,
+           sent - queued - failed);
+    printf("   Submit-to-queued latency (ms): p50 %.3f  p90 %.3f  p99 %.3f  p99.9 %.3f  max %.3f\n",
+           latency_quantile(h, 0.5) / 1e6, latency_quantile(h, 0.9) / 1e6,
+           latency_quantile(h, 0.99) / 1e6, latency_quantile(h, 0.999) / 1e6, h->max_ns / 1e6);
+}
+
+/*
+ * Submits tickets to the engine at the configured arrival profile for
+ * cfg->duration seconds and prints a summary.
+ */
+int run_stream_load(const struct StreamConfig *cfg) {
+    int fd = connect_engine(cfg->socket_path);
+    if (fd < 0) {
+        printf(" Error: cannot connect to %s - is the engine running?\n", cfg->socket_path);
+        return 1;
+    }
+
+    struct StreamSource source = {cfg, {{0}}, 0.0, 0, 0};
+    rng_seed(&source.rng, cfg->seed, 0);
+    source.arrival = stream_next_arrival(&source.rng, cfg, 0.0);
+    struct LoadSource src = {&source, stream_next, stream_emit};
+
+    struct LoadStats *st = calloc(1, sizeof(struct LoadStats));
+    if (!st) {
+        close(fd);
+        return 1;
+    }
+    uint64_t elapsed_ns = 0;
+    int status = drive_engine(fd, &src, st, &elapsed_ns);
+
+    double elapsed = elapsed_ns / 1e9;
+    print_stream_report(cfg, st, elapsed > cfg->duration ? elapsed : cfg->duration);
+
+    close(fd);
+    free(st);
+    return status;
+}
+
+// ==================== TRACE REPLAY ====================
+// Reads a trace captured with `main --trace <file>` (format in config.h)
+// and sends its requests at the recorded pace divided by `speed`
+// (0 = as fast as possible).
+
+// Field sizes match struct Ticket in main.c
+struct TraceRecord {
+    int type;
+    long id;
+    char name[100], email[100], product[100], date[50], issue[2048];
+    char priority[20], admin[100];
+};
+
+struct ReplaySource {
+    FILE *trace;
+    double speed;
+    uint64_t trace_us;      // Recorded time of the current record
+    struct TraceRecord rec;
+};
+
+int trace_varint(FILE *f, uint64_t *value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(f);
+        if (c == EOF) return 0;
+        *value |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) return 1;
+    }
+    return 0;
+}
+
+int trace_string(FILE *f, char *buf, size_t size) {
+    uint64_t len;
+    if (!trace_varint(f, &len) || len >= size) return 0;
+    if (fread(buf, 1, (size_t)len, f) != len) return 0;
+    buf[len] = '\0';
+    for (char *p = buf; *p; p++) if (*p == '\t' || *p == '\n') *p = ' ';
+    return 1;
+}
+
+// Reads the next record; 0 at end of trace (or at the first damaged record)
+int read_trace_record(FILE *f, struct TraceRecord *rec, uint64_t *delta_us) {
+    uint64_t id;
+    rec->type = fgetc(f);
+    if (rec->type == EOF || !trace_varint(f, delta_us) || !trace_varint(f, &id)) return 0;
+    rec->id = (long)id;
+
+    switch (rec->type) {
+    case TRACE_SUBMIT:
+        return trace_string(f, rec->name, sizeof(rec->name)) &&
+               trace_string(f, rec->email, sizeof(rec->email)) &&
+               trace_string(f, rec->product, sizeof(rec->product)) &&
+               trace_string(f, rec->date, sizeof(rec->date)) &&
+               trace_string(f, rec->issue, sizeof(rec->issue));
+    case TRACE_RESOLVE:
+        return trace_string(f, rec->admin, sizeof(rec->admin));
+    case TRACE_SET_PRIORITY:
+        return trace_string(f, rec->priority, sizeof(rec->priority)) &&
+               trace_string(f, rec->admin, sizeof(rec->admin));
+    default:
+        return 0;
+    }
+}
+
+int64_t replay_next(void *ctx) {
+    struct ReplaySource *r = ctx;
+    uint64_t delta_us;
+    if (!read_trace_record(r->trace, &r->rec, &delta_us)) return -1;
+    r->trace_us += delta_us;
+    return r->speed > 0 ? (int64_t)(r->trace_us * 1000.0 / r->speed) : 0;
+}
+
+int replay_emit(void *ctx, struct Outbox *out, uint64_t due_ns) {
+    struct ReplaySource *r = ctx;
+    const struct TraceRecord *rec = &r->rec;
+
+    if (rec->type == TRACE_SUBMIT) {
+        int ok = queue_submit_frame(out, rec->id, rec->name, rec->email, rec->product,
+                                    rec->date, rec->issue, due_ns);
+        return ok ? REQ_SUBMIT : -1;
+    }
+
+    char *p = frame_begin(out);
+    if (!p) return -1;
+    if (rec->type == TRACE_RESOLVE) {
+        p = append_text(p, "RESOLVE\t");
+        p = append_long(p, rec->id);      *p++ = '\t';
+        p = append_text(p, rec->admin);
+        frame_end(out, p);
+        return REQ_RESOLVE;
+    }
+
+    p = append_text(p, "SET_PRIORITY\t");
+    p = append_long(p, rec->id);          *p++ = '\t';
+    p = append_text(p, rec->priority);    *p++ = '\t';
+    p = append_text(p, rec->admin);
+    frame_end(out, p);
+    return REQ_SET_PRIORITY;
+}
+
+// One synchronous request on a non-blocking connection (all replies drained)
+int engine_request(int fd, const char *payload, char *reply, size_t reply_size) {
+    struct Outbox out = {NULL, 0, 0, 0};
+    char *p = frame_begin(&out);
+    if (!p) return 0;
+    frame_end(&out, append_text(p, payload));
+
+    unsigned char buf[4 + 1024];
+    size_t got = 0, want = 4;
+    int ok = 1;
+    while (ok && (out.sent < out.len || got < want)) {
+        struct pollfd pfd = {fd, out.sent < out.len ? POLLOUT : POLLIN, 0};
+        if (poll(&pfd, 1, 5000) <= 0) { ok = 0; break; }
+        if (out.sent < out.len) {
+            ssize_t w = send(fd, out.data + out.sent, out.len - out.sent, MSG_NOSIGNAL);
+            if (w > 0) out.sent += (size_t)w;
+            continue;
+        }
+        ssize_t r = recv(fd, buf + got, want - got, 0);
+        if (r <= 0) { ok = 0; break; }
+        got += (size_t)r;
+        if (got == 4) {
+            want = 4 + (((size_t)buf[0] << 24) | ((size_t)buf[1] << 16) | ((size_t)buf[2] << 8) | buf[3]);
+            if (want > sizeof(buf) || want - 4 >= reply_size) ok = 0;
+        }
+    }
+    free(out.data);
+    if (!ok) return 0;
+    memcpy(reply, buf + 4, want - 4);
+    reply[want - 4] = '\0';
+    return 1;
+}
+
+// Engine-side stage latencies (METRICS request), one line per stage
+void print_engine_stages(int fd) {
+    char reply[1024];
+    if (!engine_request(fd, "METRICS", reply, sizeof(reply)) || strncmp(reply, "OK", 2) != 0) {
+        printf("   (engine did not answer METRICS)\n");
+        return;
+    }
+    printf("\n   %-20s %10s %10s %10s %10s   (engine, ms)\n", "stage", "count", "p50", "p99", "max");
+    for (char *field = strtok(reply + 2, "\t"); field; field = strtok(NULL, "\t")) {
+        char stage[64];
+        unsigned long long count, p50, p99, max;
+        if (sscanf(field, "%63s %llu %llu %llu %llu", stage, &count, &p50, &p99, &max) != 5 || count == 0) continue;
+        printf("   %-20s %10llu %10.3f %10.3f %10.3f\n", stage, count, p50 / 1e3, p99 / 1e3, max / 1e3);
+    }
+}
+
+/*
+ * Replays `path` against the engine at `speed` x the recorded pace and
+ * reports client-side latency per request type plus the engine's own
+ * per-stage timings.
+ */
+int run_replay(const char *path, double speed, const char *socket_path) {
+    FILE *trace = fopen(path, "rb");
+    if (!trace) {
+        printf(" Error: cannot open trace %s\n", path);
+        return 1;
+    }
+    char magic[sizeof(TRACE_MAGIC)] = "";
+    if (fread(magic, 1, strlen(TRACE_MAGIC), trace) != strlen(TRACE_MAGIC) || strcmp(magic, TRACE_MAGIC) != 0) {
+        printf(" Error: %s is not a ticket engine trace\n", path);
+        fclose(trace);
+        return 1;
+    }
+
+    int fd = connect_engine(socket_path);
+    struct LoadStats *st = calloc(1, sizeof(struct LoadStats));
+    struct ReplaySource replay;
+    if (fd < 0 || !st) {
+        printf(" Error: cannot connect to %s - is the engine running?\n", socket_path);
+        if (fd >= 0) close(fd);
+        free(st);
+        fclose(trace);
+        return 1;
+    }
+    memset(&replay, 0, sizeof(replay));
+    replay.trace = trace;
+    replay.speed = speed;
+    struct LoadSource src = {&replay, replay_next, replay_emit};
+
+    uint64_t elapsed_ns = 0;
+    int status = drive_engine(fd, &src, st, &elapsed_ns);
+
+    printf("\n Replay finished: %.3fs of trace in %.3fs\n", replay.trace_us / 1e6, elapsed_ns / 1e9);
+    printf("   %-20s %8s %8s %8s %10s %10s %10s   (client, ms)\n", "request", "sent", "ok", "failed", "p50", "p99", "max");
+    for (int k = 0; k < REQ_KIND_COUNT; k++) {
+        if (st->sent[k] == 0) continue;
+        const struct LatencyHist *h = &st->latency[k];
+        printf("   %-20s %8ld %8ld %8ld %10.3f %10.3f %10.3f\n", request_kind_names[k],
+               st->sent[k], st->ok[k], st->failed[k],
+               latency_quantile(h, 0.5) / 1e6, latency_quantile(h, 0.99) / 1e6, h->max_ns / 1e6);
+    }
+    if (st->duplicates || st->queue_full) {
+        printf("   (submit failures: %ld duplicates, %ld queue full)\n", st->duplicates, st->queue_full);
+    }
+    if (status == 0) print_engine_stages(fd);
+
+    close(fd);
+    free(st);
+    fclose(trace);
+    return status;
+}
+
+#endif /* _WIN32 */
+
+#ifndef GENERATOR_LIBRARY
+void print_usage(const char *prog) {
+    printf("Usage: %s                       (interactive, appends to %s)\n", prog, DB_FILE);
+    printf("       %s --count N [--seed S] [--output PATH] [--threads T] [--now EPOCH] [--first-id ID]\n", prog);
+    printf("\n  Bulk mode. Same --seed, --now and --first-id give byte-identical output\n");
+    printf("  for any --threads. IDs are leased from %s when writing to %s.\n", ID_HWM_FILE, DB_FILE);
+    printf("\n       %s --stream --rate R --duration SECONDS [--profile poisson|bursty]\n", prog);
+    printf("          [--burst-factor F] [--burst-period SECONDS] [--seed S] [--socket PATH]\n");
+    printf("\n  Stream mode. Submits tickets to the running engine through %s at\n", ENGINE_SOCKET);
+    printf("  R tickets/s on average and reports throughput and submit-to-queued latency.\n");
+    printf("  Bursty runs F x R for %.0f%% of each period (default 4 x, 10 s).\n", STREAM_BURST_DUTY * 100);
+    printf("\n       %s --replay TRACE [--speed X] [--socket PATH]\n", prog);
+    printf("\n  Replay mode. Sends a trace captured with `main --trace TRACE` to the engine\n");
+    printf("  at X times the recorded pace (default 1, 0 = as fast as possible) and\n");
+    printf("  reports per-request and per-stage timing. Use a fresh engine directory.\n");
+}
+
+#ifndef _WIN32
+// Open-loop load against the engine from command-line options
+int run_stream(int argc, char *argv[]) {
+    struct StreamConfig cfg = {0, 0, 0, 4.0, 10.0, (uint64_t)time(NULL), ENGINE_SOCKET};
+
+    for (int i = 2; i < argc; i++) {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!val) { print_usage(argv[0]); return 1; }
+        if (strcmp(opt, "--rate") == 0) cfg.rate = atof(val);
+        else if (strcmp(opt, "--duration") == 0) cfg.duration = atof(val);
+        else if (strcmp(opt, "--profile") == 0 && strcmp(val, "poisson") == 0) cfg.bursty = 0;
+        else if (strcmp(opt, "--profile") == 0 && strcmp(val, "bursty") == 0) cfg.bursty = 1;
+        else if (strcmp(opt, "--burst-factor") == 0) cfg.burst_factor = atof(val);
+        else if (strcmp(opt, "--burst-period") == 0) cfg.burst_period = atof(val);
+        else if (strcmp(opt, "--seed") == 0) cfg.seed = strtoull(val, NULL, 10);
+        else if (strcmp(opt, "--socket") == 0) cfg.socket_path = val;
+        else { print_usage(argv[0]); return 1; }
+        i++;
+    }
+    if (cfg.rate <= 0 || cfg.duration <= 0 || cfg.burst_period <= 0 ||
+        cfg.burst_factor < 1 || cfg.burst_factor * STREAM_BURST_DUTY > 1) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    init_data();
+    printf("Streaming %.1f tickets/s (%s) for %.0fs to %s (seed %llu)...\n",
+           cfg.rate, cfg.bursty ? "bursty" : "poisson", cfg.duration, cfg.socket_path,
+           (unsigned long long)cfg.seed);
+    return run_stream_load(&cfg);
+}
+
+// Trace replay from command-line options
+int run_replay_command(int argc, char *argv[]) {
+    const char *socket_path = ENGINE_SOCKET;
+    double speed = 1.0;
+    if (argc < 3) { print_usage(argv[0]); return 1; }
+
+    for (int i = 3; i < argc; i++) {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!val) { print_usage(argv[0]); return 1; }
+        if (strcmp(opt, "--speed") == 0) speed = atof(val);
+        else if (strcmp(opt, "--socket") == 0) socket_path = val;
+        else { print_usage(argv[0]); return 1; }
+        i++;
+    }
+    if (speed < 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (speed > 0) printf("Replaying %s at %gx to %s...\n", argv[2], speed, socket_path);
+    else printf("Replaying %s as fast as possible to %s...\n", argv[2], socket_path);
+    return run_replay(argv[2], speed, socket_path);
+}
+#endif
+
+// Non-interactive bulk generation from command-line options
+int run_bulk(int argc, char *argv[]) {
+    long count = 0, now = (long)time(NULL), first_id = 0;
+    uint64_t seed = (uint64_t)time(NULL);
+    const char *output = DB_FILE;
+    int threads = 1;
+#ifndef _WIN32
+    threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    for (int i = 1; i < argc; i++) {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!val) { print_usage(argv[0]); return 1; }
+        if (strcmp(opt, "--count") == 0) count = atol(val);
+        else if (strcmp(opt, "--seed") == 0) seed = strtoull(val, NULL, 10);
+        else if (strcmp(opt, "--output") == 0) output = val;
+        else if (strcmp(opt, "--threads") == 0) threads = atoi(val);
+        else if (strcmp(opt, "--now") == 0) now = atol(val);
+        else if (strcmp(opt, "--first-id") == 0) first_id = atol(val);
+        else { print_usage(argv[0]); return 1; }
+        i++;
+    }
+    if (count <= 0 || count > 2000000000L || threads <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    init_data();
+
+    // Only the live database shares the engine's ID space. Seeding leases
+    // its whole range at once; the per-lease cap is for ALLOC-sized blocks.
+    if (first_id <= 0) {
+        first_id = (strcmp(output, DB_FILE) == 0) ? lease_ids(count, MAX_TICKET_ID) : 1001;
+        if (first_id < 0) return 1;
+    }
+    // Rows above MAX_TICKET_ID would be dropped by the engine's loader
+    if (first_id + count - 1 > MAX_TICKET_ID) {
+        printf(" Error: IDs #%ld - #%ld pass the largest ticket ID #%d\n",
+               first_id, first_id + count - 1, MAX_TICKET_ID);
+        return 1;
+    }
+
+    printf("Generating %ld tickets into %s (seed %llu, %d threads, IDs #%ld - #%ld)...\n",
+           count, output, (unsigned long long)seed, threads, first_id, first_id + count - 1);
+    time_t start = time(NULL);
+    if (generate_bulk(output, count, seed, threads, now, first_id) != 0) return 1;
+    printf(" Success! Wrote %ld tickets in %lds\n", count, (long)(time(NULL) - start));
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+#ifndef _WIN32
+    if (argc > 1 && strcmp(argv[1], "--stream") == 0) return run_stream(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--replay") == 0) return run_replay_command(argc, argv);
+#endif
+    if (argc > 1) return run_bulk(argc, argv);
+
+    struct GenRng rng;
+    rng_seed(&rng, (uint64_t)time(NULL), 0);
     init_data();
 
     int n;
@@ -200,12 +1298,16 @@ int main() {
     printf("-------------------------------------------\n");
     printf("Target Database: %s\n", DB_FILE);
     
-    // Auto-detect next ID
-    int next_id = get_next_id();
-    printf("Starting Ticket ID: #%d (Auto-detected)\n", next_id);
-    
     printf("\nHow many tickets to generate? ");
-    scanf("%d", &n);
+    if (scanf("%d", &n) != 1 || n <= 0) {
+        printf(" Invalid count.\n");
+        return 1;
+    }
+
+    // Lease the whole ID range up front so concurrent producers never collide
+    int next_id = (int)lease_ids(n, MAX_TICKET_ID_LEASE);
+    if (next_id < 0) return 1;
+    printf("Starting Ticket ID: #%d (Leased %d IDs)\n", next_id, n);
 
     // Append mode "a" is critical here!
     FILE *fp = fopen(DB_FILE, "a");
@@ -217,36 +1319,14 @@ int main() {
     printf("\nGenerating %d tickets...\n", n);
     
     long current_time = time(NULL);
+    char row[BULK_MAX_ROW_BYTES];
 
     for (int i = 0; i < n; i++) {
-        int id = next_id + i;
-        
-        // Generate fields
-        const char *fname = first_names[randomInt(0, first_name_count - 1)];
-        const char *lname = last_names[randomInt(0, last_name_count - 1)];
-        char full_name[100];
-        sprintf(full_name, "%s %s", fname, lname);
-
-        char email[100];
-        char f_lower[50], l_lower[50];
-        strcpy(f_lower, fname); strcpy(l_lower, lname);
-        for(int k=0; f_lower[k]; k++) f_lower[k] = tolower(f_lower[k]);
-        for(int k=0; l_lower[k]; k++) l_lower[k] = tolower(l_lower[k]);
-        sprintf(email, "%s.%s%d@%s", f_lower, l_lower, randomInt(1, 999), domains[randomInt(0, domain_count - 1)]);
-
-        char product[50], issue[256];
-        get_product_and_issue(product, issue);
-
-        char date[20];
-        sprintf(date, "%04d-%02d-%02d", randomInt(2023, 2025), randomInt(1, 12), randomInt(1, 28));
-        const char *prio = priorities[randomInt(0, 3)];
-        
-        // Spread timestamps slightly into the past (e.g., last 10 mins) so they don't look instant
-        long ticket_time = current_time - randomInt(0, 600); 
+        struct GeneratedTicket g;
+        generate_ticket(&rng, &g, next_id + i, current_time);
 
         // Write directly to CSV
-        fprintf(fp, "%d,\"%s\",\"%s\",\"%s\",%s,\"%s\",%s,%ld\n",
-            id, full_name, email, product, date, issue, prio, ticket_time);
+        fwrite(row, 1, (size_t)(format_ticket_row(row, &g) - row), fp);
             
         if (i % 50 == 0) { printf("."); fflush(stdout); }
     }
@@ -257,4 +1337,5 @@ int main() {
     printf("   Refresh your Admin Dashboard to see them!\n");
 
     return 0;
-}
\ No newline at end of file
+}
+#endif /* GENERATOR_LIBRARY */
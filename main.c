@@ -1,8 +1,12 @@
+#ifdef __linux__
+    #define _GNU_SOURCE   // accept4() and friends
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <time.h>
+#include <math.h>
 #include <signal.h>
 #include <errno.h>
 #ifdef _WIN32
@@ -10,7 +14,27 @@
 #else
     #include <unistd.h>   // Linux
 #endif
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/file.h>  // flock()
+    #include <sys/mman.h>
+#endif
+#ifdef __linux__
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <sys/epoll.h>
+    #include <sys/inotify.h>
+    #include <sys/signalfd.h>
+    #include <sys/eventfd.h>
+#endif
+#ifndef _WIN32
+    #include <pthread.h>
+#endif
+#include <stdarg.h>
+#include <stdint.h>
 #include <strings.h>
+#include <sys/stat.h>
+#include <dirent.h>
 #include "config.h"
 
 #define MAX MAX_QUEUE_SIZE
@@ -44,1146 +68,6348 @@ void setupSignalHandlers() {
  * Auto-escalation handles urgency while maintaining queue order.
  */
 
+// One ticket by value: parsing, archive rows, socket requests, callers' copies
 struct Ticket {
     int ticketID;
-    char customerName[100];
-    char email[100];
-    char product[100];
-    char purchaseDate[50];
-    char issueDescription[200];
-    char priority[20];
+    char customerName[MAX_CUSTOMER_NAME_LEN + 1];
+    char email[MAX_EMAIL_LEN + 1];
+    char product[MAX_PRODUCT_LEN + 1];
+    char purchaseDate[MAX_PURCHASE_DATE_LEN + 1];
+    char issueDescription[MAX_ISSUE_DESC_LEN + 1];
+    char priority[MAX_PRIORITY_LEN + 1];
     time_t queueEntryTime;
 };
 
-/* ==================== CIRCULAR QUEUE OPERATIONS ==================== */
+// Text fields of a queued ticket, in arena order
+enum TicketField { FIELD_NAME, FIELD_EMAIL, FIELD_PRODUCT, FIELD_DATE, FIELD_ISSUE, TICKET_TEXT_FIELDS };
 
-struct Ticket queue[MAX];
-int front = -1;
-int rear = -1;
+// What the queue holds per ticket (text lives in the arena, see TICKET TEXT ARENA)
+struct QueuedTicket {
+    int ticketID;
+    uint32_t text;                              // Arena offset of the packed text fields
+    time_t queueEntryTime;
+    unsigned long long dupKey;                  // duplicateKey(email, issue)
+    long row;                                   // Active-database row with the cold fields, or -1
+    uint16_t fieldEnd[TICKET_TEXT_FIELDS];      // Offset of each field's NUL within the block
+    uint8_t priority;                           // PRIORITY_* (priorityRank order)
+};
 
-int isEmpty() {
-    return front == -1;
+enum { PRIORITY_CRITICAL, PRIORITY_HIGH, PRIORITY_MEDIUM, PRIORITY_LOW };
+
+const char *priorityNames[4] = {"Critical", "High", "Medium", "Low"};
+
+// Longest text block, active-database row (every field full) and archive row
+#define TICKET_TEXT_MAX (MAX_CUSTOMER_NAME_LEN + MAX_EMAIL_LEN + MAX_PRODUCT_LEN + \
+                         MAX_PURCHASE_DATE_LEN + MAX_ISSUE_DESC_LEN + TICKET_TEXT_FIELDS)
+#define TICKET_RECORD_MAX (TICKET_TEXT_MAX + MAX_PRIORITY_LEN + 64)
+#define ARCHIVE_RECORD_MAX (TICKET_RECORD_MAX + 160)
+
+// Forward declarations (defined further below)
+void saveQueueToFile();
+void maybeCompactDatabase();
+void abandonCompaction();
+void markDashboardDirty();
+void indexQueuedTicket(int slot);
+void reindexMovedTicket(int slot);
+void unindexQueuedTicket(const struct QueuedTicket *q);
+void clearQueueIndexes();
+int lookupQueuedTicket(int id);
+int priorityRank(const char *priority);
+void applyPriorityLog();
+void logError(const char *message);
+void refreshDashboard();
+int splitCSVLine(char *line, char **fields, int maxFields);
+unsigned long long duplicateKey(const char *email, const char *issue);
+void copyText(char *dst, size_t size, const char *src);
+struct DatabaseMap;
+int readTicketRow(const struct DatabaseMap *map, long row, int id, struct Ticket *t);
+const struct Ticket *coldTicketFields(const struct QueuedTicket *q);
+void forgetColdFields(int id);
+void clearColdFieldCache();
+int replaceFile(const char *from, const char *to);
+int syncDatabase(FILE *db);
+int makeSpoolDirectory(const char *path);
+void indexResolvedTicket(int id, long long location);
+void forgetResolvedTicket(int id, int period);
+int isArchivedTicket(int id);
+void recordCustomerResolution(const char *email, time_t resolvedAt);
+void forgetCustomerResolution(const char *email);
+void seedWaitSketches();
+
+/* ==================== ASYNC LOGGING ==================== */
+
+/*
+ * DESIGN DECISION: Diagnostics go through an in-memory ring
+ * Every log line used to fopen/localtime/fprintf/fclose on the calling
+ * path - one syscall pair per malformed CSV row during loadFromFile().
+ * Now callers format into a slot of a bounded lock-free ring (Vyukov
+ * MPSC: a CAS on the head, a per-slot sequence number) and return.
+ * A background thread drains it into long-lived, size-rotated files,
+ * formatting timestamps once per second. When the ring is full the
+ * message is dropped and counted rather than blocking the caller.
+ * An idle writer sleeps on a condvar; a producer takes the lock only
+ * to wake it, when it has flagged itself asleep. Written records are
+ * flushed within LOG_FLUSH_INTERVAL_MS.
+ * Before startLogger() (unit tests, tools) messages are written inline.
+ */
+
+enum LogTarget { LOG_ERROR, LOG_OVERFLOW, LOG_ESCALATION, LOG_DUPLICATE, LOG_ARCHIVE, LOG_TARGET_COUNT };
+
+const char *logFileNames[LOG_TARGET_COUNT] = {
+    ERROR_LOG_FILE, OVERFLOW_LOG_FILE, ESCALATION_LOG_FILE, DUPLICATE_LOG_FILE, ARCHIVE_LOG_FILE
+};
+
+struct LogRecord {
+    unsigned long seq;              // Ring position this slot is ready for
+    int target;
+    time_t when;
+    char text[LOG_MESSAGE_MAX];
+};
+
+struct LogRecord logRing[LOG_RING_SIZE];
+unsigned long logHead = 0;          // Next position producers claim
+unsigned long logTail = 0;          // Next position the writer drains
+unsigned long logDropped = 0;       // Messages lost to a full ring
+int loggerRunning = 0;
+int loggerSleeping = 0;             // Writer is (about to be) waiting on logWake
+
+FILE *logFiles[LOG_TARGET_COUNT];
+long logFileBytes[LOG_TARGET_COUNT];
+
+// "[YYYY-mm-dd HH:MM:SS] " for `when`; localtime runs once per second
+const char *logTimestamp(time_t when) {
+    static time_t cachedSecond = (time_t)-1;
+    static char cached[32];
+    if (when != cachedSecond) {
+        struct tm tmBuf;
+#ifdef _WIN32
+        tmBuf = *localtime(&when);
+#else
+        localtime_r(&when, &tmBuf);
+#endif
+        strftime(cached, sizeof(cached), "[%Y-%m-%d %H:%M:%S] ", &tmBuf);
+        cachedSecond = when;
+    }
+    return cached;
 }
 
-int isFull() {
-    return (rear + 1) % MAX == front;
+// name -> name.1 -> ... -> name.LOG_ROTATE_KEEP (oldest dropped)
+void rotateLogFile(int target) {
+    char from[128], to[128];
+    const char *name = logFileNames[target];
+
+    fclose(logFiles[target]);
+    logFiles[target] = NULL;
+
+    for (int i = LOG_ROTATE_KEEP - 1; i >= 1; i--) {
+        snprintf(from, sizeof(from), "%s.%d", name, i);
+        snprintf(to, sizeof(to), "%s.%d", name, i + 1);
+        rename(from, to);
+    }
+    snprintf(to, sizeof(to), "%s.1", name);
+    rename(name, to);
 }
 
-int enqueue(struct Ticket t) {
-    if (isFull()) {
-        // Log overflow for monitoring
-        FILE *overflow = fopen("overflow_log.txt", "a");
-        if (overflow) {
-            char timeBuf[50];
-            time_t now = time(NULL);
-            strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S", localtime(&now));
-            fprintf(overflow, "[%s] QUEUE FULL - Ticket #%d rejected\n", timeBuf, t.ticketID);
-            fclose(overflow);
+void writeLogRecord(int target, time_t when, const char *text) {
+    if (!logFiles[target]) {
+        logFiles[target] = fopen(logFileNames[target], "a");
+        if (!logFiles[target]) return;
+        fseek(logFiles[target], 0, SEEK_END);
+        logFileBytes[target] = ftell(logFiles[target]);
+    }
+
+    const char *stamp = logTimestamp(when);
+    fputs(stamp, logFiles[target]);
+    fputs(text, logFiles[target]);
+    fputc('\n', logFiles[target]);
+    logFileBytes[target] += (long)(strlen(stamp) + strlen(text) + 1);
+
+    if (logFileBytes[target] >= LOG_ROTATE_BYTES) rotateLogFile(target);
+}
+
+void flushLogFiles(int closeFiles) {
+    for (int i = 0; i < LOG_TARGET_COUNT; i++) {
+        if (!logFiles[i]) continue;
+        if (closeFiles) {
+            fclose(logFiles[i]);
+            logFiles[i] = NULL;
+        } else {
+            fflush(logFiles[i]);
         }
-        return 0;
     }
-    if (front == -1) front = 0;
-    rear = (rear + 1) % MAX;
-    queue[rear] = t;
-    return 1;
 }
 
-int dequeue(struct Ticket *t) {
-    if (isEmpty()) return 0;
+#ifndef _WIN32
+pthread_mutex_t logWakeLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t logWake = PTHREAD_COND_INITIALIZER;
 
-    *t = queue[front];
+// Wakes the writer if it has gone to sleep on an empty ring
+void wakeLogger() {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);   // Publish before reading the flag
+    if (!__atomic_load_n(&loggerSleeping, __ATOMIC_RELAXED)) return;
+    pthread_mutex_lock(&logWakeLock);
+    pthread_cond_signal(&logWake);
+    pthread_mutex_unlock(&logWakeLock);
+}
+#else
+void wakeLogger() {}
+#endif
 
-    if (front == rear)
-        front = rear = -1;
-    else
-        front = (front + 1) % MAX;
+void logEvent(int target, const char *fmt, ...) {
+    va_list args;
 
-    return 1;
+    if (!__atomic_load_n(&loggerRunning, __ATOMIC_ACQUIRE)) {
+        // No writer thread: write inline, as before
+        char text[LOG_MESSAGE_MAX];
+        va_start(args, fmt);
+        vsnprintf(text, sizeof(text), fmt, args);
+        va_end(args);
+        writeLogRecord(target, time(NULL), text);
+        flushLogFiles(1);
+        return;
+    }
+
+    unsigned long pos = __atomic_load_n(&logHead, __ATOMIC_RELAXED);
+    struct LogRecord *rec;
+    while (1) {
+        rec = &logRing[pos & (LOG_RING_SIZE - 1)];
+        long diff = (long)(__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&logHead, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+            __atomic_fetch_add(&logDropped, 1, __ATOMIC_RELAXED);   // Ring full
+            return;
+        } else {
+            pos = __atomic_load_n(&logHead, __ATOMIC_RELAXED);
+        }
+    }
+
+    rec->target = target;
+    rec->when = time(NULL);
+    va_start(args, fmt);
+    vsnprintf(rec->text, sizeof(rec->text), fmt, args);
+    va_end(args);
+    __atomic_store_n(&rec->seq, pos + 1, __ATOMIC_RELEASE);           // Publish to the writer
+    wakeLogger();
 }
 
-/* ==================== UTILITY FUNCTIONS ==================== */
+// Writes everything published so far; returns the number of records
+int drainLogRing() {
+    int drained = 0;
+    while (1) {
+        struct LogRecord *rec = &logRing[logTail & (LOG_RING_SIZE - 1)];
+        if (__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) != logTail + 1) break;
 
-void removeNewline(char *str) {
-    size_t len = strlen(str);
-    if (len > 0 && str[len - 1] == '\n')
-        str[len - 1] = '\0';
+        writeLogRecord(rec->target, rec->when, rec->text);
+        __atomic_store_n(&rec->seq, logTail + LOG_RING_SIZE, __ATOMIC_RELEASE);   // Free the slot
+        logTail++;
+        drained++;
+    }
+    return drained;
 }
 
-void getSystemTime(char *buffer) {
-    time_t t = time(NULL);
-    struct tm *tm_info = localtime(&t);
-    strftime(buffer, 30, "%Y-%m-%d %H:%M:%S", tm_info);
+#ifndef _WIN32
+
+pthread_t loggerThread;
+
+// True if the writer has a published record to take
+int logRingReady() {
+    const struct LogRecord *rec = &logRing[logTail & (LOG_RING_SIZE - 1)];
+    return __atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) == logTail + 1;
 }
 
-void logError(const char *message) {
-    FILE *err = fopen("error_log.txt", "a");
-    if (err) {
-        char timeBuf[50];
-        getSystemTime(timeBuf);
-        fprintf(err, "[%s] ERROR: %s\n", timeBuf, message);
-        fclose(err);
+void *loggerMain(void *arg) {
+    (void)arg;
+    unsigned long reportedDrops = 0;
+    int unflushed = 0;
+    struct timespec flushBy = {0, 0};   // Deadline for unflushed records
+
+    while (1) {
+        int running = __atomic_load_n(&loggerRunning, __ATOMIC_ACQUIRE);
+        int drained = drainLogRing();
+
+        unsigned long dropped = __atomic_load_n(&logDropped, __ATOMIC_RELAXED);
+        if (dropped != reportedDrops) {
+            char text[96];
+            snprintf(text, sizeof(text), "ERROR: Log ring full - %lu messages dropped", dropped - reportedDrops);
+            writeLogRecord(LOG_ERROR, time(NULL), text);
+            reportedDrops = dropped;
+            drained++;
+        }
+        if (!running) break;                 // Final drain done above
+
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        if (drained > 0 && !unflushed) {
+            unflushed = 1;
+            flushBy = now;
+            flushBy.tv_nsec += LOG_FLUSH_INTERVAL_MS * 1000000L;
+            if (flushBy.tv_nsec >= 1000000000L) {
+                flushBy.tv_sec++;
+                flushBy.tv_nsec -= 1000000000L;
+            }
+        }
+        if (unflushed && (now.tv_sec > flushBy.tv_sec ||
+                          (now.tv_sec == flushBy.tv_sec && now.tv_nsec >= flushBy.tv_nsec))) {
+            flushLogFiles(0);
+            unflushed = 0;
+        }
+        if (drained > 0) continue;           // Keep draining while producers are busy
+
+        // Sleep until a producer publishes, stopLogger(), or the flush deadline
+        pthread_mutex_lock(&logWakeLock);
+        __atomic_store_n(&loggerSleeping, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);   // Flag before re-checking the ring
+        if (!logRingReady() && __atomic_load_n(&loggerRunning, __ATOMIC_ACQUIRE)) {
+            if (unflushed) pthread_cond_timedwait(&logWake, &logWakeLock, &flushBy);
+            else pthread_cond_wait(&logWake, &logWakeLock);
+        }
+        __atomic_store_n(&loggerSleeping, 0, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&logWakeLock);
     }
+
+    flushLogFiles(1);
+    return NULL;
 }
 
-/* 
- * Auto-priority detection based on keywords in issue description.
- * NOTE: These keywords are NOT shown to users to prevent gaming the system.
- */
-const char* getAutoPriority(const char* desc) {
-    char d[300];
-    strncpy(d, desc, 299);
-    d[299] = '\0';
-    for (int i = 0; d[i]; i++) d[i] = tolower(d[i]);
+int startLogger() {
+    for (unsigned long i = 0; i < LOG_RING_SIZE; i++) logRing[i].seq = i;
+    logHead = logTail = 0;
+    flushLogFiles(1);
 
-    // Critical: Security, financial, data loss
-    if (strstr(d, "hack") || strstr(d, "security") || strstr(d, "money") || 
-        strstr(d, "payment") || strstr(d, "fraud") || strstr(d, "stolen"))
-        return "Critical";
-    
-    // High: System failures, urgent issues
-    if (strstr(d, "urgent") || strstr(d, "fail") || strstr(d, "error") || 
-        strstr(d, "crash") || strstr(d, "broke") || strstr(d, "not working"))
-        return "High";
-    
-    // Medium: Performance issues, bugs
-    if (strstr(d, "bug") || strstr(d, "slow") || strstr(d, "delay") || 
-        strstr(d, "glitch") || strstr(d, "issue"))
-        return "Medium";
-    
-    return "Low";
+    // The writer inherits a fully blocked signal mask, so SIGINT/SIGTERM
+    // always reach the main thread (and its signalfd)
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &previous);
+
+    __atomic_store_n(&loggerRunning, 1, __ATOMIC_RELEASE);
+    int rc = pthread_create(&loggerThread, NULL, loggerMain, NULL);
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+    if (rc != 0) {
+        __atomic_store_n(&loggerRunning, 0, __ATOMIC_RELEASE);
+        return 0;
+    }
+    return 1;
 }
 
-/* ==================== INPUT VALIDATION FUNCTIONS ==================== */
+// Drains what is left and closes the log files
+void stopLogger() {
+    if (!__atomic_load_n(&loggerRunning, __ATOMIC_ACQUIRE)) return;
+    pthread_mutex_lock(&logWakeLock);
+    __atomic_store_n(&loggerRunning, 0, __ATOMIC_RELEASE);
+    pthread_cond_signal(&logWake);
+    pthread_mutex_unlock(&logWakeLock);
+    pthread_join(loggerThread, NULL);
+}
+
+#else /* _WIN32 */
+
+int startLogger() { return 0; }
+void stopLogger() {}
+
+#endif /* _WIN32 */
+
+/* ==================== METRICS ==================== */
 
 /*
- * PRODUCTION-GRADE VALIDATION:
- * Validates all input data to prevent crashes from malformed CSV or corrupt data.
- * Returns 1 if valid, 0 if invalid.
+ * DESIGN DECISION: HDR-style latency histograms per engine stage
+ * Each stage records its duration into log-linear buckets: 8 linear
+ * sub-buckets per power of two, so any quantile is within 12.5% while
+ * recording is a bit scan and one add. Counts are relaxed atomics so any
+ * thread may record. writeMetricsFile() exports everything in Prometheus
+ * text format, replaced atomically (tmp + rename) for a node_exporter
+ * textfile collector or any scraper.
  */
 
-int isValidTicketID(int id) {
-    return (id >= MIN_TICKET_ID && id <= MAX_TICKET_ID);
+enum EngineStage {
+    STAGE_PROCESS_PENDING, STAGE_ESCALATE, STAGE_ADMIN_COMMANDS, STAGE_DASHBOARD,
+    STAGE_ARCHIVE, STAGE_LOAD, STAGE_CYCLE, STAGE_SUBMIT_TO_QUEUED, STAGE_COUNT
+};
+
+const char *stageNames[STAGE_COUNT] = {
+    "process_pending", "escalate", "admin_commands", "generate_dashboard",
+    "archive_and_remove", "load_from_file", "loop_cycle", "submit_to_queued"
+};
+
+#define HIST_SUB_BITS 3
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS (48 * HIST_SUB_BUCKETS)    // Up to 2^47 ns (~39 hours)
+
+struct LatencyHistogram {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+    uint64_t sumNs;
+    uint64_t maxNs;
+};
+
+struct LatencyHistogram stageLatency[STAGE_COUNT];
+
+// Event counters
+uint64_t metricTicketsIngested = 0;
+uint64_t metricDuplicatesRejected = 0;
+uint64_t metricQueueOverflows = 0;
+uint64_t metricTicketsResolved = 0;
+
+void countMetric(uint64_t *counter) {
+    __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
 }
 
-int isValidEmail(const char *email) {
-    if (!email || strlen(email) < MIN_EMAIL_LEN || strlen(email) > MAX_EMAIL_LEN) {
-        return 0;
+uint64_t metricsNow() {
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64() * 1000000ULL;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+int histogramBucket(uint64_t ns) {
+    if (ns < HIST_SUB_BUCKETS) return (int)ns;
+    int msb = 63 - __builtin_clzll(ns);
+    int shift = msb - HIST_SUB_BITS;
+    int index = (shift + 1) * HIST_SUB_BUCKETS + (int)((ns >> shift) & (HIST_SUB_BUCKETS - 1));
+    return index < HIST_BUCKETS ? index : HIST_BUCKETS - 1;
+}
+
+// Largest value (ns) that falls into `index`
+uint64_t histogramBucketHigh(int index) {
+    int major = index / HIST_SUB_BUCKETS;
+    uint64_t sub = (uint64_t)(index % HIST_SUB_BUCKETS);
+    if (major == 0) return sub;
+    int shift = major - 1;
+    return ((HIST_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+void recordStageLatency(int stage, uint64_t startNs) {
+    uint64_t ns = metricsNow() - startNs;
+    struct LatencyHistogram *h = &stageLatency[stage];
+
+    __atomic_fetch_add(&h->counts[histogramBucket(ns)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->total, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->sumNs, ns, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&h->maxNs, __ATOMIC_RELAXED);
+    while (ns > max && !__atomic_compare_exchange_n(&h->maxNs, &max, ns, 1,
+                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+}
+
+// Upper bound (ns) of the bucket holding quantile q (0..1)
+uint64_t histogramQuantile(const struct LatencyHistogram *h, double q) {
+    uint64_t total = __atomic_load_n(&h->total, __ATOMIC_RELAXED);
+    if (total == 0) return 0;
+
+    uint64_t rank = (uint64_t)(q * (double)total);
+    if (rank >= total) rank = total - 1;
+
+    uint64_t max = __atomic_load_n(&h->maxNs, __ATOMIC_RELAXED);
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += __atomic_load_n(&h->counts[i], __ATOMIC_RELAXED);
+        if (seen > rank) return histogramBucketHigh(i) < max ? histogramBucketHigh(i) : max;
     }
-    
-    // Email must contain @ and . in correct order
-    const char *at = strchr(email, '@');
-    const char *dot = strrchr(email, '.');
-    
-    if (!at || !dot || dot <= at) {
+    return max;
+}
+
+/*
+ * Writes METRICS_FILE in Prometheus text format. Queue gauges are passed
+ * in by the caller. Returns 1 on success.
+ */
+int writeMetricsFile(int queueDepth, const int priorities[4], unsigned long logDroppedCount) {
+    static const double bounds[] = {0.00001, 0.0001, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5};
+    static const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    const int boundCount = (int)(sizeof(bounds) / sizeof(bounds[0]));
+    const int quantileCount = (int)(sizeof(quantiles) / sizeof(quantiles[0]));
+
+    char tmpPath[256];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", METRICS_FILE);
+    FILE *f = fopen(tmpPath, "w");
+    if (!f) {
+        logError("Cannot write metrics file");
         return 0;
     }
-    
-    // There should be characters after the last dot (domain extension)
-    if (strlen(dot) < 2) {
+
+    fprintf(f, "# HELP ticket_engine_stage_duration_seconds Time spent in each engine stage.\n");
+    fprintf(f, "# TYPE ticket_engine_stage_duration_seconds histogram\n");
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        const struct LatencyHistogram *h = &stageLatency[s];
+        uint64_t cumulative = 0;
+        int bucket = 0;
+        for (int b = 0; b < boundCount; b++) {
+            uint64_t limitNs = (uint64_t)(bounds[b] * 1e9);
+            while (bucket < HIST_BUCKETS && histogramBucketHigh(bucket) <= limitNs) {
+                cumulative += __atomic_load_n(&h->counts[bucket], __ATOMIC_RELAXED);
+                bucket++;
+            }
+            fprintf(f, "ticket_engine_stage_duration_seconds_bucket{stage=\"%s\",le=\"%g\"} %llu\n",
+                    stageNames[s], bounds[b], (unsigned long long)cumulative);
+        }
+        uint64_t total = __atomic_load_n(&h->total, __ATOMIC_RELAXED);
+        fprintf(f, "ticket_engine_stage_duration_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %llu\n",
+                stageNames[s], (unsigned long long)total);
+        fprintf(f, "ticket_engine_stage_duration_seconds_sum{stage=\"%s\"} %.9f\n",
+                stageNames[s], (double)__atomic_load_n(&h->sumNs, __ATOMIC_RELAXED) / 1e9);
+        fprintf(f, "ticket_engine_stage_duration_seconds_count{stage=\"%s\"} %llu\n",
+                stageNames[s], (unsigned long long)total);
+    }
+
+    fprintf(f, "# HELP ticket_engine_stage_duration_quantile_seconds Stage latency quantiles since start (HDR, <=12.5%% error).\n");
+    fprintf(f, "# TYPE ticket_engine_stage_duration_quantile_seconds gauge\n");
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        for (int q = 0; q < quantileCount; q++) {
+            fprintf(f, "ticket_engine_stage_duration_quantile_seconds{stage=\"%s\",quantile=\"%g\"} %.9f\n",
+                    stageNames[s], quantiles[q], (double)histogramQuantile(&stageLatency[s], quantiles[q]) / 1e9);
+        }
+        fprintf(f, "ticket_engine_stage_duration_quantile_seconds{stage=\"%s\",quantile=\"1\"} %.9f\n",
+                stageNames[s], (double)__atomic_load_n(&stageLatency[s].maxNs, __ATOMIC_RELAXED) / 1e9);
+    }
+
+    fprintf(f, "# TYPE ticket_engine_tickets_ingested_total counter\n");
+    fprintf(f, "ticket_engine_tickets_ingested_total %llu\n",
+            (unsigned long long)__atomic_load_n(&metricTicketsIngested, __ATOMIC_RELAXED));
+    fprintf(f, "# TYPE ticket_engine_duplicates_rejected_total counter\n");
+    fprintf(f, "ticket_engine_duplicates_rejected_total %llu\n",
+            (unsigned long long)__atomic_load_n(&metricDuplicatesRejected, __ATOMIC_RELAXED));
+    fprintf(f, "# TYPE ticket_engine_queue_overflows_total counter\n");
+    fprintf(f, "ticket_engine_queue_overflows_total %llu\n",
+            (unsigned long long)__atomic_load_n(&metricQueueOverflows, __ATOMIC_RELAXED));
+    fprintf(f, "# TYPE ticket_engine_tickets_resolved_total counter\n");
+    fprintf(f, "ticket_engine_tickets_resolved_total %llu\n",
+            (unsigned long long)__atomic_load_n(&metricTicketsResolved, __ATOMIC_RELAXED));
+    fprintf(f, "# TYPE ticket_engine_log_messages_dropped_total counter\n");
+    fprintf(f, "ticket_engine_log_messages_dropped_total %lu\n", logDroppedCount);
+
+    fprintf(f, "# TYPE ticket_engine_queue_depth gauge\n");
+    fprintf(f, "ticket_engine_queue_depth %d\n", queueDepth);
+    fprintf(f, "# TYPE ticket_engine_queue_tickets gauge\n");
+    const char *names[4] = {"critical", "high", "medium", "low"};
+    for (int i = 0; i < 4; i++) {
+        fprintf(f, "ticket_engine_queue_tickets{priority=\"%s\"} %d\n", names[i], priorities[i]);
+    }
+
+    if (fclose(f) != 0 || rename(tmpPath, METRICS_FILE) != 0) {
+        logError("Cannot publish metrics file");
+        remove(tmpPath);
         return 0;
     }
-    
     return 1;
 }
 
-int isValidString(const char *str, int minLen, int maxLen) {
-    if (!str) return 0;
-    
-    int len = strlen(str);
-    if (len < minLen || len > maxLen) {
-        return 0;
-    }
-    
-    // Check for at least one non-whitespace character
-    int hasContent = 0;
-    for (int i = 0; str[i]; i++) {
-        if (!isspace((unsigned char)str[i])) {
-            hasContent = 1;
-            break;
-        }
-    }
-    
-    return hasContent;
+/* ==================== WORKLOAD TRACE ==================== */
+
+/*
+ * DESIGN DECISION: Capture requests, not effects
+ * With --trace, every submission that reaches ingestTicket() and every
+ * RESOLVE / SET_PRIORITY (socket or journal) is appended to a compact
+ * binary trace before it is applied, with the gap since the previous
+ * record. Replaying the trace (data_generator --replay) reproduces the
+ * same request sequence and pacing against any engine build.
+ * Records go through a large stdio buffer, flushed with the metrics.
+ */
+
+FILE *traceFile = NULL;
+uint64_t traceLastNs = 0;
+
+void traceVarint(uint64_t value) {
+    unsigned char buf[10];
+    int n = 0;
+    do {
+        buf[n] = (unsigned char)(value & 0x7F);
+        value >>= 7;
+        if (value) buf[n] |= 0x80;
+        n++;
+    } while (value);
+    fwrite(buf, 1, (size_t)n, traceFile);
 }
 
-int isValidPriority(const char *priority) {
-    if (!priority) return 0;
-    
-    return (strcmp(priority, "Low") == 0 ||
-            strcmp(priority, "Medium") == 0 ||
-            strcmp(priority, "High") == 0 ||
-            strcmp(priority, "Critical") == 0);
+void traceString(const char *s) {
+    size_t len = strlen(s);
+    traceVarint(len);
+    fwrite(s, 1, len, traceFile);
 }
 
-/* ==================== DUPLICATE DETECTION ==================== */
+// Starts a record: type byte + microseconds since the previous record
+void traceBegin(int type) {
+    uint64_t now = metricsNow();
+    fputc(type, traceFile);
+    traceVarint((now - traceLastNs) / 1000);
+    traceLastNs = now - (now - traceLastNs) % 1000;   // Keep rounding from drifting
+}
+
+int openTrace(const char *path) {
+    traceFile = fopen(path, "wb");
+    if (!traceFile) return 0;
+    setvbuf(traceFile, NULL, _IOFBF, 1 << 16);
+    fwrite(TRACE_MAGIC, 1, strlen(TRACE_MAGIC), traceFile);
+    traceLastNs = metricsNow();
+    return 1;
+}
+
+void traceSubmit(const struct Ticket *t) {
+    if (!traceFile) return;
+    traceBegin(TRACE_SUBMIT);
+    traceVarint((uint64_t)t->ticketID);
+    traceString(t->customerName);
+    traceString(t->email);
+    traceString(t->product);
+    traceString(t->purchaseDate);
+    traceString(t->issueDescription);
+}
+
+// RESOLVE <id> <admin> / SET_PRIORITY <id> <priority> <admin>
+void traceCommand(int type, int id, const char *priority, const char *admin) {
+    if (!traceFile) return;
+    traceBegin(type);
+    traceVarint((uint64_t)(id > 0 ? id : 0));
+    if (type == TRACE_SET_PRIORITY) traceString(priority);
+    traceString(admin);
+}
+
+void closeTrace() {
+    if (!traceFile) return;
+    fclose(traceFile);
+    traceFile = NULL;
+}
+
+/* ==================== TICKET TEXT ARENA ==================== */
 
 /*
- * SMART DUPLICATE DETECTION:
- * - Prevents spam from impatient users resubmitting same issue
- * - Allows legitimate recurring issues (check resolved tickets)
- * - Compares: same email + similar issue text (first 30 chars)
+ * DESIGN DECISION: Queued text lives in a packed string arena
+ * A queued struct Ticket reserved fixed arrays for every field (over
+ * 550 bytes) while real tickets carry ~150 bytes of text, and anything
+ * longer than its array was cut off. The queue now holds a 48-byte
+ * QueuedTicket; its five text fields sit back to back, NUL-terminated,
+ * in one block of a growable arena, referenced by offset so growing the
+ * arena never invalidates a ticket. Blocks are rounded up to
+ * ARENA_GRANULE bytes, and a freed block goes onto the free list of its
+ * size class, which is drawn from before the arena grows. The arena is
+ * touched by the owner thread only: views and snapshots for other
+ * threads carry their own copy of it.
  */
 
-int isDuplicateInQueue(const char *email, const char *issue) {
-    if (isEmpty()) return 0;
-    
-    char issuePrefix[31];
-    strncpy(issuePrefix, issue, 30);
-    issuePrefix[30] = '\0';
-    
-    // Convert to lowercase for comparison
-    for (int i = 0; issuePrefix[i]; i++) {
-        issuePrefix[i] = tolower(issuePrefix[i]);
-    }
-    
-    int i = front;
-    while (1) {
-        // Check if same email
-        if (strcasecmp(queue[i].email, email) == 0) {
-            // Check if similar issue (first 30 chars match)
-            char queueIssuePrefix[31];
-            strncpy(queueIssuePrefix, queue[i].issueDescription, 30);
-            queueIssuePrefix[30] = '\0';
-            
-            for (int j = 0; queueIssuePrefix[j]; j++) {
-                queueIssuePrefix[j] = tolower(queueIssuePrefix[j]);
-            }
-            
-            if (strcmp(issuePrefix, queueIssuePrefix) == 0) {
-                return queue[i].ticketID; // Found duplicate - return existing ticket ID
-            }
+#define ARENA_CLASSES (TICKET_TEXT_MAX / ARENA_GRANULE + 2)
+
+char *textArena = NULL;
+size_t textArenaSize = 0;               // Bytes handed out so far (offset 0 is never used)
+size_t textArenaCapacity = 0;
+size_t textArenaLive = 0;               // Bytes in blocks held by queued tickets
+uint32_t arenaFreeLists[ARENA_CLASSES]; // First free block per size class, 0 = none
+
+size_t arenaBlockSize(size_t length) {
+    return (length + ARENA_GRANULE - 1) / ARENA_GRANULE * ARENA_GRANULE;
+}
+
+// Offset of a block of at least `length` bytes, or 0 if the arena cannot grow
+uint32_t arenaAlloc(size_t length) {
+    size_t size = arenaBlockSize(length);
+    uint32_t *freeList = &arenaFreeLists[size / ARENA_GRANULE];
+    uint32_t offset = *freeList;
+
+    if (offset) {
+        memcpy(freeList, textArena + offset, sizeof(uint32_t));   // Pop
+    } else {
+        if (textArenaSize == 0) textArenaSize = ARENA_GRANULE;
+        if (textArenaSize + size > textArenaCapacity) {
+            size_t grown = textArenaCapacity ? textArenaCapacity * 2 : ARENA_INITIAL_BYTES;
+            while (grown < textArenaSize + size) grown *= 2;
+            if (grown > UINT32_MAX) return 0;
+            char *arena = realloc(textArena, grown);
+            if (!arena) return 0;
+            textArena = arena;
+            textArenaCapacity = grown;
         }
-        
-        if (i == rear) break;
-        i = (i + 1) % MAX;
+        offset = (uint32_t)textArenaSize;
+        textArenaSize += size;
     }
-    
-    return 0; // Not a duplicate
+    textArenaLive += size;
+    return offset;
 }
 
-int isDuplicateInResolved(const char *email, const char *issue, int maxDaysBack) {
-    FILE *f = fopen("resolved_tickets.csv", "r");
-    if (!f) return 0;
-    
-    char issuePrefix[31];
-    strncpy(issuePrefix, issue, 30);
-    issuePrefix[30] = '\0';
-    for (int i = 0; issuePrefix[i]; i++) {
-        issuePrefix[i] = tolower(issuePrefix[i]);
-    }
-    
-    char line[1024];
-    fgets(line, sizeof(line), f); // Skip header
-    
-    time_t now = time(NULL);
-    time_t cutoffTime = now - (maxDaysBack * 24 * 3600);
-    
-    while (fgets(line, sizeof(line), f)) {
-        char lineCopy[1024];
-        strncpy(lineCopy, line, 1023);
-        lineCopy[1023] = '\0';
-        
-        // Parse: Ticket ID, Name, Email, Product, Date, Issue, Priority, Entry Time, Resolved Time
-        char *tok = strtok(lineCopy, ",");
-        if (!tok) continue;
-        
-        tok = strtok(NULL, ","); // name
-        if (!tok) continue;
-        
-        char *csvEmail = strtok(NULL, ",");
-        if (!csvEmail) continue;
-        
-        // Strip quotes
-        if (csvEmail[0] == '"') csvEmail++;
-        if (csvEmail[strlen(csvEmail)-1] == '"') csvEmail[strlen(csvEmail)-1] = '\0';
-        
-        if (strcasecmp(csvEmail, email) != 0) continue;
-        
-        tok = strtok(NULL, ","); // product
-        tok = strtok(NULL, ","); // date
-        
-        char *csvIssue = strtok(NULL, ",");
-        if (!csvIssue) continue;
-        
-        // Strip quotes
-        if (csvIssue[0] == '"') csvIssue++;
-        
-        char csvIssuePrefix[31];
-        strncpy(csvIssuePrefix, csvIssue, 30);
-        csvIssuePrefix[30] = '\0';
-        for (int i = 0; csvIssuePrefix[i]; i++) {
-            csvIssuePrefix[i] = tolower(csvIssuePrefix[i]);
-        }
-        
-        if (strcmp(issuePrefix, csvIssuePrefix) == 0) {
-            // Found similar issue - check if within time window
-            tok = strtok(NULL, ","); // priority
-            tok = strtok(NULL, ","); // entry time
-            
-            if (tok) {
-                time_t resolvedTime = (time_t)atol(tok);
-                if (resolvedTime > cutoffTime) {
-                    fclose(f);
-                    return 1; // Recent duplicate found
-                }
-            }
-        }
-    }
-    
-    fclose(f);
-    return 0; // No recent duplicate
+void arenaFree(uint32_t offset, size_t length) {
+    size_t size = arenaBlockSize(length);
+    uint32_t *freeList = &arenaFreeLists[size / ARENA_GRANULE];
+    memcpy(textArena + offset, freeList, sizeof(uint32_t));       // Push
+    *freeList = offset;
+    textArenaLive -= size;
 }
 
-/* ==================== CUSTOMER HISTORY ==================== */
-
-int getCustomerHistory(const char *email, char history[][512], int maxHistory) {
-    FILE *f = fopen("resolved_tickets.csv", "r");
-    if (!f) return 0;
-    
-    int count = 0;
-    char line[1024];
-    fgets(line, sizeof(line), f); // Skip header
-    
-    while (fgets(line, sizeof(line), f) && count < maxHistory) {
-        char lineCopy[1024];
-        strncpy(lineCopy, line, 1023);
-        lineCopy[1023] = '\0';
-        
-        // Parse to get email (3rd field)
-        char *tok = strtok(lineCopy, ",");
-        if (!tok) continue;
-        tok = strtok(NULL, ","); // name
-        if (!tok) continue;
-        
-        char *csvEmail = strtok(NULL, ",");
-        if (!csvEmail) continue;
-        
-        // Strip quotes
-        if (csvEmail[0] == '"') csvEmail++;
-        if (csvEmail[strlen(csvEmail)-1] == '"') csvEmail[strlen(csvEmail)-1] = '\0';
-        
-        if (strcasecmp(csvEmail, email) == 0) {
-            removeNewline(line);
-            strncpy(history[count], line, 511);
-            history[count][511] = '\0';
-            count++;
-        }
-    }
-    
-    fclose(f);
-    return count;
+// Forgets every block (the queue is being emptied); keeps the memory
+void arenaReset() {
+    textArenaSize = 0;
+    textArenaLive = 0;
+    memset(arenaFreeLists, 0, sizeof(arenaFreeLists));
 }
 
-/* ==================== QUEUE STATISTICS ==================== */
+// Field `field` of `q`, in `arena` (the live arena or a copy of it)
+const char *ticketTextIn(const char *arena, const struct QueuedTicket *q, int field) {
+    return arena + q->text + (field == 0 ? 0 : q->fieldEnd[field - 1] + 1);
+}
 
-void getQueueStats(int *total, double *avgWaitHours, int *oldestHours, int priorities[4]) {
-    *total = 0;
-    *avgWaitHours = 0.0;
-    *oldestHours = 0;
-    priorities[0] = priorities[1] = priorities[2] = priorities[3] = 0; // Critical, High, Medium, Low
-    
-    if (isEmpty()) return;
-    
-    time_t now = time(NULL);
-    double totalWait = 0.0;
-    
-    int i = front;
-    while (1) {
-        (*total)++;
-        
-        // Calculate wait time
-        double hours = difftime(now, queue[i].queueEntryTime) / 3600.0;
-        totalWait += hours;
-        
-        if (hours > *oldestHours) {
-            *oldestHours = (int)hours;
+/*
+ * Field `field` of a queued ticket (owner thread). A cold ticket's fields
+ * other than the email come from the cold field cache and stay valid
+ * until the next cold read.
+ */
+const char *ticketText(const struct QueuedTicket *q, int field) {
+    if (q->row >= 0 && field != FIELD_EMAIL) {
+        const struct Ticket *cold = coldTicketFields(q);
+        switch (field) {
+            case FIELD_NAME: return cold->customerName;
+            case FIELD_PRODUCT: return cold->product;
+            case FIELD_DATE: return cold->purchaseDate;
+            default: return cold->issueDescription;
         }
-        
-        // Count priorities
-        if (strcmp(queue[i].priority, "Critical") == 0) priorities[0]++;
-        else if (strcmp(queue[i].priority, "High") == 0) priorities[1]++;
-        else if (strcmp(queue[i].priority, "Medium") == 0) priorities[2]++;
-        else priorities[3]++;
-        
-        if (i == rear) break;
-        i = (i + 1) % MAX;
-    }
-    
-    if (*total > 0) {
-        *avgWaitHours = totalWait / (*total);
     }
+    return ticketTextIn(textArena, q, field);
 }
 
-/* ==================== AUTO-ESCALATION (24H CYCLES) ==================== */
+// Bytes in q's text block
+size_t ticketTextLength(const struct QueuedTicket *q) {
+    return (size_t)q->fieldEnd[TICKET_TEXT_FIELDS - 1] + 1;
+}
 
 /*
- * DESIGN DECISION: 24-hour escalation cycles
- * 
- * Why 24h instead of 48h/72h?
- * - Faster response to aging tickets
- * - Prevents tickets from languishing
- * - Creates urgency for support team
- * 
- * Escalation timeline:
- * Low: 0-24h Low, 24-48h Medium, 48h+ High
- * Medium: 0-24h Medium, 24h+ High
- * High: 0-24h High, 24h+ Critical
- * Critical: Always Critical
+ * Packs `t` into `q`, copying its text into a new arena block. With a
+ * database `row` (>= 0) only the email is kept; the other fields are
+ * cold (see COLD TICKET FIELDS). Returns 0 (q untouched) if the arena
+ * cannot grow.
  */
+int storeTicket(struct QueuedTicket *q, const struct Ticket *t, unsigned long long dupKey, long row) {
+    const char *fields[TICKET_TEXT_FIELDS] = {
+        t->customerName, t->email, t->product, t->purchaseDate, t->issueDescription
+    };
+    size_t lengths[TICKET_TEXT_FIELDS];
+    size_t total = 0;
+    for (int i = 0; i < TICKET_TEXT_FIELDS; i++) {
+        lengths[i] = (row >= 0 && i != FIELD_EMAIL) ? 0 : strlen(fields[i]);
+        total += lengths[i] + 1;
+    }
 
-void escalateOldTickets() {
-    if (isEmpty()) return;
-    
-    time_t now = time(NULL);
-    int i = front;
-    int escalated = 0;
-    
-    while (1) {
-        double hours = difftime(now, queue[i].queueEntryTime) / 3600.0;
-        char oldPriority[20];
-        strcpy(oldPriority, queue[i].priority);
-        
-        // FIXED: Complete 24-hour escalation with 72h Critical safety net
-        // Rule: Every 24 hours, priority increases one step
-        // Low → (24h) → Medium → (24h) → High → (24h) → Critical
-        // Safety: ANY ticket ≥72h is forced to Critical
-        
-        if (strcmp(queue[i].priority, "Critical") != 0) {
-            // SAFETY NET: Force any ticket ≥72 hours to Critical
-            if (hours >= 72) {
-                strcpy(queue[i].priority, "Critical");
-                escalated++;
-            }
-            // Low priority escalation
-            else if (strcmp(queue[i].priority, "Low") == 0) {
-                if (hours >= 48) {
-                    strcpy(queue[i].priority, "High");
-                    escalated++;
-                } else if (hours >= 24) {
-                    strcpy(queue[i].priority, "Medium");
-                    escalated++;
-                }
-            }
-            // Medium priority escalation
-            else if (strcmp(queue[i].priority, "Medium") == 0) {
-                if (hours >= 24) {
-                    strcpy(queue[i].priority, "High");
-                    escalated++;
-                }
-            }
-            // High priority escalation - FIXED: High → Critical after 24h
-            else if (strcmp(queue[i].priority, "High") == 0) {
-                if (hours >= 24) {
-                    strcpy(queue[i].priority, "Critical");
-                    escalated++;
-                }
-            }
-        }
-        
-        if (i == rear) break;
-        i = (i + 1) % MAX;
+    uint32_t offset = arenaAlloc(total);
+    if (!offset) {
+        logEvent(LOG_ERROR, "ERROR: Out of memory for ticket text - Ticket #%d not queued", t->ticketID);
+        return 0;
     }
-    
-    if (escalated > 0) {
-        FILE *log = fopen("escalation_log.txt", "a");
-        if (log) {
-            char timeBuf[50];
-            getSystemTime(timeBuf);
-            fprintf(log, "[%s] Auto-escalated %d tickets\n", timeBuf, escalated);
-            fclose(log);
-        }
+
+    size_t end = 0;
+    for (int i = 0; i < TICKET_TEXT_FIELDS; i++) {
+        memcpy(textArena + offset + end, fields[i], lengths[i]);
+        end += lengths[i];
+        textArena[offset + end] = '\0';
+        q->fieldEnd[i] = (uint16_t)end;
+        end++;
     }
+    q->ticketID = t->ticketID;
+    q->text = offset;
+    q->queueEntryTime = t->queueEntryTime;
+    q->dupKey = dupKey;
+    q->row = row;
+    q->priority = (uint8_t)priorityRank(t->priority);
+    return 1;
 }
 
-/* ==================== CSV FILE OPERATIONS ==================== */
-
 /*
- * SIMPLIFIED CSV STRUCTURE (removed unnecessary columns):
- * Old: 11 fields (including status, responseTime, resolveTime)
- * New: 8 fields (essential only)
- * Benefits: Cleaner data, fixes #### in Excel, easier to maintain
+ * Unpacks `q` (text in `arena`, cold fields in `map`) into a full struct
+ * Ticket. Returns 0 if the cold fields could not be read (left empty).
  */
-
-void loadFromFile() {
-    FILE *f = fopen("customer_support_tickets_updated.csv", "r");
-    if (!f) {
-        f = fopen("customer_support_tickets_updated.csv", "w");
-        if (!f) {
-            logError("Cannot create customer_support_tickets_updated.csv");
-            return;
+int expandTicketFrom(const char *arena, const struct DatabaseMap *map,
+                     const struct QueuedTicket *q, struct Ticket *t) {
+    int ok = 1;
+    if (q->row >= 0) {
+        ok = readTicketRow(map, q->row, q->ticketID, t);
+        copyText(t->email, sizeof(t->email), ticketTextIn(arena, q, FIELD_EMAIL));
+    } else {
+        char *fields[TICKET_TEXT_FIELDS] = {
+            t->customerName, t->email, t->product, t->purchaseDate, t->issueDescription
+        };
+        for (int i = 0; i < TICKET_TEXT_FIELDS; i++) {
+            const char *text = ticketTextIn(arena, q, i);
+            memcpy(fields[i], text, (size_t)(arena + q->text + q->fieldEnd[i] - text) + 1);
         }
-        fprintf(f, "Ticket ID,Customer Name,Customer Email,Product,Purchase Date,Issue Description,Priority,Queue Entry Time\n");
-        fclose(f);
+    }
+    t->ticketID = q->ticketID;
+    strcpy(t->priority, priorityNames[q->priority]);
+    t->queueEntryTime = q->queueEntryTime;
+    return ok;
+}
+
+// expandTicketFrom() for the live queue (owner thread; cold fields via the cache)
+void expandTicket(const struct QueuedTicket *q, struct Ticket *t) {
+    if (q->row < 0) {
+        expandTicketFrom(textArena, NULL, q, t);
         return;
     }
+    const struct Ticket *cold = coldTicketFields(q);
+    copyText(t->customerName, sizeof(t->customerName), cold->customerName);
+    copyText(t->email, sizeof(t->email), ticketTextIn(textArena, q, FIELD_EMAIL));
+    copyText(t->product, sizeof(t->product), cold->product);
+    copyText(t->purchaseDate, sizeof(t->purchaseDate), cold->purchaseDate);
+    copyText(t->issueDescription, sizeof(t->issueDescription), cold->issueDescription);
+    t->ticketID = q->ticketID;
+    strcpy(t->priority, priorityNames[q->priority]);
+    t->queueEntryTime = q->queueEntryTime;
+}
 
-    char line[1024];
-    fgets(line, sizeof(line), f); // Skip header
+// Returns q's text block to the arena (q must already be unindexed)
+void releaseTicketText(const struct QueuedTicket *q) {
+    if (q->row >= 0) forgetColdFields(q->ticketID);
+    arenaFree(q->text, ticketTextLength(q));
+}
 
-    front = rear = -1;
-    int lineNumber = 1;  // Track line numbers for error reporting
-    int validTickets = 0;
-    int invalidTickets = 0;
+/* ==================== CIRCULAR QUEUE OPERATIONS ==================== */
 
-    while (fgets(line, sizeof(line), f)) {
-        lineNumber++;
-        struct Ticket t;
-        removeNewline(line);
+struct QueuedTicket queue[MAX];
+int front = -1;
+int rear = -1;
 
-        // Simple CSV parser that handles quoted fields
-        char *fields[8];
-        int fieldIndex = 0;
-        char *ptr = line;
-        char fieldBuffer[512];
-        int bufferIndex = 0;
-        int inQuotes = 0;
-
-        while (*ptr && fieldIndex < 8) {
-            if (*ptr == '"') {
-                inQuotes = !inQuotes;
-                ptr++;
-                continue;
-            }
-            
-            if (*ptr == ',' && !inQuotes) {
-                fieldBuffer[bufferIndex] = '\0';
-                fields[fieldIndex] = strdup(fieldBuffer);
-                
-                // ENHANCEMENT: NULL check for strdup
-                if (!fields[fieldIndex]) {
-                    char errMsg[256];
-                    snprintf(errMsg, sizeof(errMsg), 
-                             "Memory allocation failed at line %d - skipping", lineNumber);
-                    logError(errMsg);
-                    
-                    // Free previously allocated fields
-                    for (int j = 0; j < fieldIndex; j++) {
-                        if (fields[j]) free(fields[j]);
-                    }
-                    goto next_line;  // Skip this line
-                }
-                
-                fieldIndex++;
-                bufferIndex = 0;
-                ptr++;
-                continue;
-            }
-            
-            if (bufferIndex < 511) fieldBuffer[bufferIndex++] = *ptr;
-            ptr++;
-        }
-        
-        // Last field
-        fieldBuffer[bufferIndex] = '\0';
-        fields[fieldIndex] = strdup(fieldBuffer);
-        
-        // ENHANCEMENT: NULL check for last field
-        if (!fields[fieldIndex]) {
-            char errMsg[256];
-            snprintf(errMsg, sizeof(errMsg), 
-                     "Memory allocation failed at line %d - skipping", lineNumber);
-            logError(errMsg);
-            
-            for (int j = 0; j < fieldIndex; j++) {
-                if (fields[j]) free(fields[j]);
-            }
-            goto next_line;
-        }
-        
-        fieldIndex++;
-
-        // ENHANCEMENT: Better error message for malformed lines
-        if (fieldIndex < 8) {
-            char errMsg[256];
-            snprintf(errMsg, sizeof(errMsg), 
-                     "Line %d: Malformed CSV - %d fields (expected 8) - skipping", 
-                     lineNumber, fieldIndex);
-            logError(errMsg);
-            
-            // Free any allocated fields and skip malformed line
-            for (int i = 0; i < fieldIndex; i++) {
-                if (fields[i]) free(fields[i]);
-            }
-            invalidTickets++;
-            continue;
-        }
+// Bumped on every queue mutation; lets publishers skip unchanged state
+unsigned long queueVersion = 0;
 
-        // Parse fields
-        t.ticketID = atoi(fields[0]);
-        strncpy(t.customerName, fields[1], 99);
-        t.customerName[99] = '\0';
-        strncpy(t.email, fields[2], 99);
-        t.email[99] = '\0';
-        strncpy(t.product, fields[3], 99);
-        t.product[99] = '\0';
-        strncpy(t.purchaseDate, fields[4], 49);
-        t.purchaseDate[49] = '\0';
-        strncpy(t.issueDescription, fields[5], 199);
-        t.issueDescription[199] = '\0';
-        strncpy(t.priority, fields[6], 19);
-        t.priority[19] = '\0';
-        
-        if (strlen(fields[7]) > 0) {
-            t.queueEntryTime = (time_t)atol(fields[7]);
-        } else {
-            t.queueEntryTime = time(NULL);
-        }
+// Queued tickets per priority (Critical, High, Medium, Low), kept in step
+// with every queue mutation so statistics never rescan for them
+int priorityCounts[4] = {0, 0, 0, 0};
 
-        // ENHANCEMENT: Validate parsed ticket data
-        int validationFailed = 0;
-        char validationMsg[256];
-        
-        if (!isValidTicketID(t.ticketID)) {
-            snprintf(validationMsg, sizeof(validationMsg), 
-                     "Line %d: Invalid ticket ID %d - skipping", lineNumber, t.ticketID);
-            logError(validationMsg);
-            validationFailed = 1;
-        }
-        
-        if (!validationFailed && !isValidEmail(t.email)) {
-            snprintf(validationMsg, sizeof(validationMsg), 
-                     "Line %d: Invalid email '%s' for ticket #%d - skipping", 
-                     lineNumber, t.email, t.ticketID);
-            logError(validationMsg);
-            validationFailed = 1;
-        }
-        
-        if (!validationFailed && !isValidString(t.customerName, 2, MAX_CUSTOMER_NAME_LEN)) {
-            snprintf(validationMsg, sizeof(validationMsg), 
-                     "Line %d: Invalid customer name for ticket #%d - skipping", 
-                     lineNumber, t.ticketID);
-            logError(validationMsg);
-            validationFailed = 1;
-        }
-        
-        if (!validationFailed && !isValidPriority(t.priority)) {
-            // Auto-correct invalid priority instead of failing
-            snprintf(validationMsg, sizeof(validationMsg), 
-                     "Line %d: Invalid priority '%s' for ticket #%d - defaulting to Low", 
-                     lineNumber, t.priority, t.ticketID);
-            logError(validationMsg);
-            strcpy(t.priority, "Low");
-        }
-        
-        if (validationFailed) {
-            invalidTickets++;
-        } else {
-            enqueue(t);
-            validTickets++;
-        }
+void countPriority(int rank, int delta) {
+    priorityCounts[rank] += delta;
+}
 
-        // Free allocated strings
-        for (int i = 0; i < fieldIndex; i++) {
-            if (fields[i]) free(fields[i]);
-        }
-        
-        next_line:
-        continue;  // Label for goto in error handling
-    }
-    
-    fclose(f);
-    
-    // Log loading summary
-    if (invalidTickets > 0) {
-        char summaryMsg[256];
-        snprintf(summaryMsg, sizeof(summaryMsg), 
-                 "CSV Load Summary: %d valid tickets loaded, %d invalid tickets skipped", 
-                 validTickets, invalidTickets);
-        logError(summaryMsg);
-        printf("⚠️  Warning: %d invalid tickets skipped (check error_log.txt)\n", invalidTickets);
-    }
+// Sum of the queued tickets' entry times, for the average wait
+long long queuedEntryTimeSum = 0;
+
+// A ticket entering (+1) or leaving (-1) the queue
+void countQueuedTicket(const struct QueuedTicket *q, int delta) {
+    countPriority(q->priority, delta);
+    queuedEntryTimeSum += delta * (long long)q->queueEntryTime;
 }
 
-/* ==================== ADMIN DASHBOARD GENERATION ==================== */
+int isEmpty() {
+    return front == -1;
+}
 
-void generateAdminHTML() {
-    // Write to temporary file first to prevent race conditions
-    FILE *file = fopen("templates/admin_view.html.tmp", "w"); 
-    if (!file) {
-        logError("Cannot create admin_view.html.tmp");
-        return;
+int isFull() {
+    return (rear + 1) % MAX == front;
+}
+
+// enqueue() without the by-value copy of the ticket; `row` as for storeTicket()
+int enqueueTicket(const struct Ticket *t, long row) {
+    if (isFull()) {
+        // Log overflow for monitoring
+        logEvent(LOG_OVERFLOW, "QUEUE FULL - Ticket #%d rejected", t->ticketID);
+        countMetric(&metricQueueOverflows);
+        return 0;
     }
+    int slot = (rear + 1) % MAX;
+    if (!storeTicket(&queue[slot], t, duplicateKey(t->email, t->issueDescription), row)) return 0;
+    if (front == -1) front = 0;
+    rear = slot;
+    indexQueuedTicket(rear);
+    countQueuedTicket(&queue[rear], 1);
+    queueVersion++;
+    return 1;
+}
 
-    // Get queue statistics
-    int total = 0, oldestHours = 0;
-    double avgWait = 0.0;
-    int priorities[4] = {0, 0, 0, 0};
-    getQueueStats(&total, &avgWait, &oldestHours, priorities);
+int enqueue(struct Ticket t) {
+    return enqueueTicket(&t, -1);
+}
 
-    fprintf(file, "<!DOCTYPE html><html><head><title>Admin Dashboard</title>");
-    fprintf(file, "<meta charset='UTF-8'>");
-    fprintf(file, "<style>");
-    fprintf(file, "body { font-family: 'Segoe UI', sans-serif; background: #f4f6f9; padding: 20px; margin: 0; }");
-    
-    fprintf(file, ".resolve-btn-top { position: sticky; top: 0; z-index: 1000; background: #27ae60; color: white; padding: 15px; text-align: center; margin: -20px -20px 20px -20px; box-shadow: 0 2px 10px rgba(0,0,0,0.2); }");
-    fprintf(file, ".resolve-btn-top a { color: white; text-decoration: none; font-size: 16px; font-weight: bold; }");
-    fprintf(file, ".resolve-btn-top a:hover { text-decoration: underline; }");
-    
-    // Stats card styling
-    fprintf(file, ".stats-container { display: grid; grid-template-columns: repeat(auto-fit, minmax(200px, 1fr)); gap: 15px; margin-bottom: 25px; }");
-    fprintf(file, ".stat-card { background: white; padding: 20px; border-radius: 8px; box-shadow: 0 2px 4px rgba(0,0,0,0.1); }");
-    fprintf(file, ".stat-card h3 { margin: 0 0 5px 0; font-size: 14px; color: #7f8c8d; text-transform: uppercase; }");
-    fprintf(file, ".stat-card .value { font-size: 32px; font-weight: bold; color: #2c3e50; }");
-    fprintf(file, ".stat-card .subtext { font-size: 12px; color: #95a5a6; margin-top: 5px; }");
-    fprintf(file, ".stat-card.critical { border-left: 4px solid #e74c3c; }");
-    fprintf(file, ".stat-card.warning { border-left: 4px solid #f39c12; }");
-    fprintf(file, ".stat-card.info { border-left: 4px solid #3498db; }");
-    fprintf(file, ".stat-card.success { border-left: 4px solid #27ae60; }");
-    
-    fprintf(file, "table { width: 100%%; border-collapse: collapse; background: white; box-shadow: 0 4px 8px rgba(0,0,0,0.1); border-radius: 8px; overflow: hidden; }");
-    fprintf(file, "th, td { padding: 15px; text-align: left; border-bottom: 1px solid #ddd; vertical-align: middle; }");
-    fprintf(file, "th { background-color: #2c3e50; color: white; text-transform: uppercase; font-size: 13px; letter-spacing: 0.5px; }");
-    fprintf(file, "tr:hover { background-color: #f8f9fa; }");
-    
-    // Age-based row highlighting
-    fprintf(file, ".age-critical { background-color: #fadbd8 !important; }");
-    fprintf(file, ".age-warning { background-color: #fdebd0 !important; }");
-    fprintf(file, ".age-caution { background-color: #fff9e6 !important; }");
-    
-    fprintf(file, ".Critical { color: #c0392b; font-weight: bold; background: #fadbd8; padding: 4px 8px; border-radius: 4px; font-size: 12px; }");
-    fprintf(file, ".High { color: #e67e22; font-weight: bold; background: #fdebd0; padding: 4px 8px; border-radius: 4px; font-size: 12px; }");
-    fprintf(file, ".Medium { color: #2980b9; background: #d6eaf8; padding: 4px 8px; border-radius: 4px; font-size: 12px; }");
-    fprintf(file, ".Low { color: #27ae60; background: #d5f5e3; padding: 4px 8px; border-radius: 4px; font-size: 12px; }");
-    fprintf(file, ".logout-btn { float: right; background: #e74c3c; color: white; padding: 10px 20px; text-decoration: none; border-radius: 30px; font-weight: bold; font-size: 14px; box-shadow: 0 2px 5px rgba(231, 76, 60, 0.3); }");
-    fprintf(file, ".logout-btn:hover { background: #c0392b; transform: translateY(-2px); }");
-    fprintf(file, ".subtext { display: block; font-size: 12px; color: #7f8c8d; margin-top: 4px; }");
-    fprintf(file, ".age-badge { font-size: 11px; padding: 3px 6px; border-radius: 3px; font-weight: 600; }");
-    fprintf(file, ".age-critical-badge { background: #e74c3c; color: white; }");
-    fprintf(file, ".age-warning-badge { background: #f39c12; color: white; }");
-    fprintf(file, ".age-caution-badge { background: #f1c40f; color: #333; }");
-    fprintf(file, ".history-tooltip { font-size: 11px; color: #3498db; margin-left: 8px; cursor: help; }");
-    fprintf(file, ".priority-select { padding: 5px 8px; border: 1px solid #ddd; border-radius: 4px; background: white; font-size: 12px; cursor: pointer; font-weight: 600; }");
-    fprintf(file, ".priority-select:hover { border-color: #3498db; }");
-    fprintf(file, ".priority-Critical { background: #fadbd8; color: #c0392b; border-color: #c0392b; }");
-    fprintf(file, ".priority-High { background: #fdebd0; color: #e67e22; border-color: #e67e22; }");
-    fprintf(file, ".priority-Medium { background: #d6eaf8; color: #2980b9; border-color: #2980b9; }");
-    fprintf(file, ".priority-Low { background: #d5f5e3; color: #27ae60; border-color: #27ae60; }");
-    fprintf(file, "</style>");
-    fprintf(file, "</head><body>");
-    
-    if (!isEmpty()) {
-        fprintf(file, "<div class='resolve-btn-top'>");
-        fprintf(file, "<a href='/resolve/%d'>⚡ Resolve Next Ticket (FIFO) - #%d ✅</a>", queue[front].ticketID, queue[front].ticketID);
-        fprintf(file, "</div>");
-    }
-    
-    fprintf(file, "<div style='overflow: hidden; margin-bottom: 20px;'>");
-    fprintf(file, "<a href='/' class='logout-btn'>Logout</a>");
-    fprintf(file, "<h2 style='color: #2c3e50; margin: 0;'>🚀 Live Support Dashboard</h2>");
-    fprintf(file, "<p style='color: #7f8c8d; margin: 5px 0 0 0;'>Real-time ticket monitoring system (FIFO Circular Queue)</p>");
-    fprintf(file, "</div>");
+int dequeue(struct Ticket *t) {
+    if (isEmpty()) return 0;
 
-    // Statistics Dashboard
-    fprintf(file, "<div class='stats-container'>");
-    
-    // Total Tickets
-    fprintf(file, "<div class='stat-card info'>");
-    fprintf(file, "<h3>📊 Total in Queue</h3>");
-    fprintf(file, "<div class='value'>%d</div>", total);
-    fprintf(file, "<div class='subtext'>Capacity: %d/%d (%.1f%%)</div>", total, MAX, (total * 100.0) / MAX);
-    fprintf(file, "</div>");
-    
-    // Average Wait Time
-    char waitClass[20] = "success";
-    if (avgWait > 48) strcpy(waitClass, "critical");
-    else if (avgWait > 24) strcpy(waitClass, "warning");
-    fprintf(file, "<div class='stat-card %s'>", waitClass);
-    fprintf(file, "<h3>⏱️ Avg Wait Time</h3>");
-    fprintf(file, "<div class='value'>%.1fh</div>", avgWait);
-    fprintf(file, "<div class='subtext'>Average across all tickets</div>");
-    fprintf(file, "</div>");
-    
-    // Oldest Ticket
-    char oldestClass[20] = "success";
-    if (oldestHours > 72) strcpy(oldestClass, "critical");
-    else if (oldestHours > 48) strcpy(oldestClass, "warning");
-    fprintf(file, "<div class='stat-card %s'>", oldestClass);
-    fprintf(file, "<h3>⚠️ Oldest Ticket</h3>");
-    fprintf(file, "<div class='value'>%dh</div>", oldestHours);
-    fprintf(file, "<div class='subtext'>Waiting time of longest ticket</div>");
-    fprintf(file, "</div>");
-    
-    // Priority Breakdown
-    fprintf(file, "<div class='stat-card info'>");
-    fprintf(file, "<h3>🎯 Priority Distribution</h3>");
-    fprintf(file, "<div style='font-size: 14px; margin-top: 10px;'>");
-    fprintf(file, "<span class='Critical' style='margin-right: 8px;'>Critical: %d</span>", priorities[0]);
-    fprintf(file, "<span class='High' style='margin-right: 8px;'>High: %d</span>", priorities[1]);
-    fprintf(file, "<br><span class='Medium' style='margin-right: 8px; margin-top: 5px; display: inline-block;'>Medium: %d</span>", priorities[2]);
-    fprintf(file, "<span class='Low'>Low: %d</span>", priorities[3]);
-    fprintf(file, "</div></div>");
-    
-    fprintf(file, "</div>"); // End stats-container
+    if (t) expandTicket(&queue[front], t);
+    unindexQueuedTicket(&queue[front]);
+    countQueuedTicket(&queue[front], -1);
+    releaseTicketText(&queue[front]);
 
-    fprintf(file, "<table>");
-    fprintf(file, "<tr><th width='5%%'>ID</th><th width='20%%'>Customer Details</th><th width='20%%'>Product Info</th><th width='25%%'>Issue Description</th><th width='12%%'>Priority</th><th width='10%%'>Wait Time</th><th width='8%%'>History</th></tr>");
+    if (front == rear)
+        front = rear = -1;
+    else
+        front = (front + 1) % MAX;
 
-    if (!isEmpty()) {
-        time_t now = time(NULL);
-        int i = front;
-        while (1) {
-            double hours = difftime(now, queue[i].queueEntryTime) / 3600.0;
-            
-            // Determine row class based on age
-            char rowClass[50] = "";
-            if (hours > 72) strcpy(rowClass, "class='age-critical'");
-            else if (hours > 48) strcpy(rowClass, "class='age-warning'");
-            else if (hours > 24) strcpy(rowClass, "class='age-caution'");
-            
-            fprintf(file, "<tr %s>", rowClass);
-            fprintf(file, "<td><strong>#%d</strong></td>", queue[i].ticketID);
-            
-            fprintf(file, "<td><span style='font-weight:600; color:#2c3e50;'>%s</span><span class='subtext'>✉️ %s</span></td>", 
-                    queue[i].customerName, queue[i].email);
+    queueVersion++;
+    return 1;
+}
 
-            fprintf(file, "<td><span style='font-weight:600; color:#2c3e50;'>%s</span><span class='subtext'>📅 %s</span></td>", 
-                    queue[i].product, queue[i].purchaseDate);
+// Returns the array slot holding ticket `id`, or -1 if it is not queued
+int findTicketSlot(int id) {
+    return lookupQueuedTicket(id);
+}
 
-            fprintf(file, "<td>%s</td>", queue[i].issueDescription);
-            
-            // Priority dropdown for editing with color coding
-            fprintf(file, "<td>");
-            fprintf(file, "<select class='priority-select priority-%s' onchange='updatePriority(%d, this.value)'>", 
-                    queue[i].priority, queue[i].ticketID);
-            fprintf(file, "<option value='Low' %s>Low</option>", strcmp(queue[i].priority, "Low") == 0 ? "selected" : "");
-            fprintf(file, "<option value='Medium' %s>Medium</option>", strcmp(queue[i].priority, "Medium") == 0 ? "selected" : "");
-            fprintf(file, "<option value='High' %s>High</option>", strcmp(queue[i].priority, "High") == 0 ? "selected" : "");
-            fprintf(file, "<option value='Critical' %s>Critical</option>", strcmp(queue[i].priority, "Critical") == 0 ? "selected" : "");
-            fprintf(file, "</select>");
-            fprintf(file, "</td>");
-            
-            // Wait time with badges
-            char ageBadgeClass[50] = "";
-            if (hours > 72) strcpy(ageBadgeClass, "age-critical-badge");
-            else if (hours > 48) strcpy(ageBadgeClass, "age-warning-badge");
-            else if (hours > 24) strcpy(ageBadgeClass, "age-caution-badge");
-            
-            if (strlen(ageBadgeClass) > 0) {
-                fprintf(file, "<td><span class='age-badge %s'>%.1fh</span></td>", ageBadgeClass, hours);
+// Empties the queue and everything derived from it
+void resetQueue() {
+    front = rear = -1;
+    clearQueueIndexes();
+    clearColdFieldCache();
+    arenaReset();
+    memset(priorityCounts, 0, sizeof(priorityCounts));
+    queuedEntryTimeSum = 0;
+    queueVersion++;
+}
+
+// 1-based position of the ticket in `slot`, counted from the front
+int queuePosition(int slot) {
+    return (slot - front + MAX) % MAX + 1;
+}
+
+// Copies the ticket in `slot` out of the queue (it stays queued)
+void copyQueuedTicket(int slot, struct Ticket *t) {
+    expandTicket(&queue[slot], t);
+}
+
+// Text field `field` (FIELD_*) of the ticket in `slot`; valid until the next enqueue
+const char *queuedTicketText(int slot, int field) {
+    return ticketText(&queue[slot], field);
+}
+
+/*
+ * Takes the tickets at the flagged queue positions (0 = front) out of the
+ * queue. marked[i] flags position first + i, for i in 0..last - first.
+ * The gaps close in FIFO order by shifting whichever side of the queue is
+ * shorter, so removing near either end moves only a few tickets. Removed
+ * tickets are copied to `removed` (if not NULL), front first.
+ */
+void removeMarkedPositions(const unsigned char *marked, int first, int last, int count,
+                           struct Ticket *removed) {
+    if (isEmpty() || count <= 0) return;
+    int size = (rear - front + MAX) % MAX + 1;
+    int taken = 0;
+    if (last + 1 < size - first) {
+        // Cheaper to shift the tickets in front of `last` towards the rear
+        int write = last;
+        for (int p = last; p >= 0; p--) {
+            int slot = (front + p) % MAX;
+            if (p >= first && marked[p - first]) {
+                if (removed) expandTicket(&queue[slot], &removed[count - 1 - taken]);
+                taken++;
+                unindexQueuedTicket(&queue[slot]);
+                countQueuedTicket(&queue[slot], -1);
+                releaseTicketText(&queue[slot]);
             } else {
-                fprintf(file, "<td>%.1fh</td>", hours);
+                if (write != p) {
+                    int to = (front + write) % MAX;
+                    queue[to] = queue[slot];
+                    reindexMovedTicket(to);
+                }
+                write--;
             }
-            
-            // Customer history count
-            char historyLines[10][512];
-            int historyCount = getCustomerHistory(queue[i].email, historyLines, 10);
-            if (historyCount > 0) {
-                fprintf(file, "<td><span class='history-tooltip' title='%d previous tickets'>📋 %d</span></td>", 
-                        historyCount, historyCount);
+        }
+        front = (front + count) % MAX;
+    } else {
+        // Shift the tickets behind `first` towards the front
+        int write = first;
+        for (int p = first; p < size; p++) {
+            int slot = (front + p) % MAX;
+            if (p <= last && marked[p - first]) {
+                if (removed) expandTicket(&queue[slot], &removed[taken]);
+                taken++;
+                unindexQueuedTicket(&queue[slot]);
+                countQueuedTicket(&queue[slot], -1);
+                releaseTicketText(&queue[slot]);
             } else {
-                fprintf(file, "<td style='color: #bdc3c7;'>-</td>");
+                int to = (front + write) % MAX;
+                if (to != slot) {
+                    queue[to] = queue[slot];
+                    reindexMovedTicket(to);
+                }
+                write++;
             }
-            
-            fprintf(file, "</tr>");
+        }
+        rear = (rear - count + MAX) % MAX;
+    }
+    if (count == size) front = rear = -1;
+    queueVersion++;
+}
 
-            if (i == rear) break;
-            i = (i + 1) % MAX;
+// Removes the ticket at `slot` (used for out-of-order resolves); FIFO order holds
+int removeTicketAt(int slot, struct Ticket *t) {
+    if (isEmpty() || slot < 0 || slot >= MAX) return 0;
+    int p = (slot - front + MAX) % MAX;
+    if (p > (rear - front + MAX) % MAX) return 0;
+
+    static const unsigned char one = 1;
+    removeMarkedPositions(&one, p, p, 1, t);
+    return 1;
+}
+
+/* ==================== UTILITY FUNCTIONS ==================== */
+
+void removeNewline(char *str) {
+    size_t len = strlen(str);
+    if (len > 0 && str[len - 1] == '\n')
+        str[len - 1] = '\0';
+}
+
+// Copies `src` into the `size`-byte buffer `dst`, truncating (no strncpy padding)
+void copyText(char *dst, size_t size, const char *src) {
+    size_t len = strlen(src);
+    if (len >= size) len = size - 1;
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+void getSystemTime(char *buffer) {
+    time_t t = time(NULL);
+    struct tm tm_info;
+#ifdef _WIN32
+    tm_info = *localtime(&t);
+#else
+    localtime_r(&t, &tm_info);   // Renderer and logger threads format times too
+#endif
+    strftime(buffer, 30, "%Y-%m-%d %H:%M:%S", &tm_info);
+}
+
+/*
+ * In-place CSV splitter: handles quoted fields, strips the quotes and
+ * points fields[] into the (modified) line. Returns the number of fields.
+ */
+int splitCSVLine(char *line, char **fields, int maxFields) {
+    int count = 0;
+    char *src = line;
+    char *dst = line;
+    int inQuotes = 0;
+
+    if (maxFields <= 0) return 0;
+    fields[count++] = dst;
+
+    while (*src && *src != '\n' && *src != '\r') {
+        if (*src == '"') {
+            inQuotes = !inQuotes;
+            src++;
+            continue;
         }
-    } else {
-        fprintf(file, "<tr><td colspan='7' style='text-align:center; padding: 40px; color: #95a5a6;'><h3>No Pending Tickets! 🎉</h3><p>Good job team, all caught up.</p></td></tr>");
+        if (*src == ',' && !inQuotes) {
+            *dst++ = '\0';
+            src++;
+            if (count == maxFields) return count;
+            fields[count++] = dst;
+            continue;
+        }
+        *dst++ = *src++;
     }
+    *dst = '\0';
+    return count;
+}
 
-    fprintf(file, "</table>");
+/*
+ * Normalizes an email for index lookups: trims whitespace/quotes and
+ * lowercases, so "John@Mail.com " and "john@mail.com" share one key.
+ */
+void normalizeEmail(const char *email, char *out, size_t outSize) {
+    size_t n = 0;
+    if (outSize == 0) return;
+    if (!email) { out[0] = '\0'; return; }
 
-    fprintf(file, "<div style='text-align:center; margin-top:20px; color:#bdc3c7; font-size:12px;'>");
-    fprintf(file, "System Auto-Refreshes every 15s | Auto-escalation: Low→Medium (24h), Medium→High (24h), High→Critical (24h)");
-    fprintf(file, "</div>");
-    // JavaScript for priority update
-    fprintf(file, "<script>");
-    fprintf(file, "function updatePriority(ticketId, newPriority) {");
-    fprintf(file, "  fetch('/update_priority/' + ticketId + '/' + newPriority, { method: 'POST' })");
-    fprintf(file, "    .then(res => res.json())");
-    fprintf(file, "    .then(data => {");
-    fprintf(file, "      if (data.success) {");
-    fprintf(file, "        alert('Priority updated to ' + newPriority);");
-    fprintf(file, "        location.reload();");
-    fprintf(file, "      } else {");
-    fprintf(file, "        alert('Error: ' + data.error);");
-    fprintf(file, "      }");
-    fprintf(file, "    });");
-    fprintf(file, "}");
-    
-    fprintf(file, "var isRefreshing = false;");
-    fprintf(file, "var hasClickedResolve = false;");
+    while (*email && (isspace((unsigned char)*email) || *email == '"')) email++;
+    while (*email && n < outSize - 1) {
+        out[n++] = (char)tolower((unsigned char)*email);
+        email++;
+    }
+    while (n > 0 && (isspace((unsigned char)out[n - 1]) || out[n - 1] == '"')) n--;
+    out[n] = '\0';
+}
+
+// FNV-1a 64-bit hash, used by the in-memory indexes
+unsigned long long hashString(const char *s) {
+    unsigned long long h = 1469598103934665603ULL;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/*
+ * Key for duplicate detection: normalized email + first
+ * DUPLICATE_CHECK_PREFIX_LEN characters of the issue, lowercased.
+ * Mirrored in server.py (duplicate_key) - keep the two in sync.
+ */
+unsigned long long duplicateKey(const char *email, const char *issue) {
+    char key[MAX_EMAIL_LEN + 1 + DUPLICATE_CHECK_PREFIX_LEN + 1];
+    normalizeEmail(email, key, MAX_EMAIL_LEN + 1);
+
+    size_t n = strlen(key);
+    key[n++] = '\x1f';
+    for (int i = 0; issue[i] && i < DUPLICATE_CHECK_PREFIX_LEN; i++) {
+        key[n++] = (char)tolower((unsigned char)issue[i]);
+    }
+    key[n] = '\0';
+    return hashString(key);
+}
+
+// Parses "YYYY-MM-DD HH:MM:SS" (local time) as written by getSystemTime()
+time_t parseSystemTime(const char *str) {
+    struct tm tm_info;
+    memset(&tm_info, 0, sizeof(tm_info));
+    if (!str || sscanf(str, "%d-%d-%d %d:%d:%d",
+                       &tm_info.tm_year, &tm_info.tm_mon, &tm_info.tm_mday,
+                       &tm_info.tm_hour, &tm_info.tm_min, &tm_info.tm_sec) != 6) {
+        return 0;
+    }
+    tm_info.tm_year -= 1900;
+    tm_info.tm_mon -= 1;
+    tm_info.tm_isdst = -1;
+    return mktime(&tm_info);
+}
+
+void logError(const char *message) {
+    logEvent(LOG_ERROR, "ERROR: %s", message);
+}
+
+/* 
+ * Auto-priority detection based on keywords in issue description.
+ * NOTE: These keywords are NOT shown to users to prevent gaming the system.
+ */
+const char* getAutoPriority(const char* desc) {
+    char d[MAX_ISSUE_DESC_LEN + 1];
+    snprintf(d, sizeof(d), "%s", desc);
+    for (int i = 0; d[i]; i++) d[i] = tolower(d[i]);
+
+    // Critical: Security, financial, data loss
+    if (strstr(d, "hack") || strstr(d, "security") || strstr(d, "money") || 
+        strstr(d, "payment") || strstr(d, "fraud") || strstr(d, "stolen"))
+        return "Critical";
     
-    fprintf(file, "document.addEventListener('DOMContentLoaded', function() {");
-    fprintf(file, "  var resolveLinks = document.querySelectorAll('a[href*=\"/resolve/\"]');");
-    fprintf(file, "  resolveLinks.forEach(function(link) {");
-    fprintf(file, "    link.addEventListener('click', function(e) {");
-    fprintf(file, "      if (hasClickedResolve) {");
-    fprintf(file, "        e.preventDefault();");
-    fprintf(file, "        return false;");
-    fprintf(file, "      }");
-    fprintf(file, "      hasClickedResolve = true;");
-    fprintf(file, "    });");
-    fprintf(file, "  });");
-    fprintf(file, "});");
+    // High: System failures, urgent issues
+    if (strstr(d, "urgent") || strstr(d, "fail") || strstr(d, "error") || 
+        strstr(d, "crash") || strstr(d, "broke") || strstr(d, "not working"))
+        return "High";
     
-    fprintf(file, "setTimeout(function() {");
-    fprintf(file, "  if (!isRefreshing && !hasClickedResolve) {");
-    fprintf(file, "    isRefreshing = true;");
-    fprintf(file, "    location.reload();");
-    fprintf(file, "  }");
-    fprintf(file, "}, 5000);");
+    // Medium: Performance issues, bugs
+    if (strstr(d, "bug") || strstr(d, "slow") || strstr(d, "delay") || 
+        strstr(d, "glitch") || strstr(d, "issue"))
+        return "Medium";
     
-    fprintf(file, "</script>");
-    fprintf(file, "</body></html>");
-    fclose(file);
+    return "Low";
+}
+
+/* ==================== INPUT VALIDATION FUNCTIONS ==================== */
+
+/*
+ * PRODUCTION-GRADE VALIDATION:
+ * Validates all input data to prevent crashes from malformed CSV or corrupt data.
+ * Returns 1 if valid, 0 if invalid.
+ */
+
+int isValidTicketID(int id) {
+    return (id >= MIN_TICKET_ID && id <= MAX_TICKET_ID);
+}
+
+int isValidEmail(const char *email) {
+    if (!email || strlen(email) < MIN_EMAIL_LEN || strlen(email) > MAX_EMAIL_LEN) {
+        return 0;
+    }
     
-    // Atomic rename - prevents race conditions with Flask reading file
-    remove("templates/admin_view.html");
-    rename("templates/admin_view.html.tmp", "templates/admin_view.html");
+    // Email must contain @ and . in correct order
+    const char *at = strchr(email, '@');
+    const char *dot = strrchr(email, '.');
+    
+    if (!at || !dot || dot <= at) {
+        return 0;
+    }
+    
+    // There should be characters after the last dot (domain extension)
+    if (strlen(dot) < 2) {
+        return 0;
+    }
+    
+    return 1;
+}
+
+int isValidString(const char *str, int minLen, int maxLen) {
+    if (!str) return 0;
+    
+    int len = strlen(str);
+    if (len < minLen || len > maxLen) {
+        return 0;
+    }
+    
+    // Check for at least one non-whitespace character
+    int hasContent = 0;
+    for (int i = 0; str[i]; i++) {
+        if (!isspace((unsigned char)str[i])) {
+            hasContent = 1;
+            break;
+        }
+    }
+    
+    return hasContent;
+}
+
+// 0 = Critical ... 3 = Low (same order as getQueueStats' priorities[])
+int priorityRank(const char *priority) {
+    if (strcmp(priority, "Critical") == 0) return 0;
+    if (strcmp(priority, "High") == 0) return 1;
+    if (strcmp(priority, "Medium") == 0) return 2;
+    return 3;
+}
+
+int isValidPriority(const char *priority) {
+    if (!priority) return 0;
+    
+    return (strcmp(priority, "Low") == 0 ||
+            strcmp(priority, "Medium") == 0 ||
+            strcmp(priority, "High") == 0 ||
+            strcmp(priority, "Critical") == 0);
+}
+
+/* ==================== RESOLVED ARCHIVE PARTITIONS ==================== */
+
+/*
+ * DESIGN DECISION: Time-partitioned resolved archive
+ * resolved_tickets.csv only ever grew, and every lookback read it from
+ * the first row. Resolved tickets now go to one file per
+ * ARCHIVE_PARTITION_MONTHS of resolve time under ARCHIVE_DIR. A small
+ * manifest records each partition's first and last resolve time and its
+ * row count. Duplicate lookbacks, history lookups and retention choose
+ * partitions from the in-memory copy of the manifest, so they open only
+ * the files that overlap their window. The manifest is rewritten (temp
+ * file + rename) after every archive append. The startup index pass
+ * reads every partition anyway, so it recounts the manifest; it also
+ * moves rows left in the old single-file archive into their partitions,
+ * skipping tickets already archived (a move cut short by a crash).
+ */
+
+const char archiveHeader[] =
+    "Ticket ID,Customer Name,Customer Email,Product,Purchase Date,Issue Description,Priority,Queue Entry Time,Resolved At,Resolved By\n";
+
+struct ArchivePartition {
+    int period;      // archivePeriod() of its rows
+    time_t first;    // Resolve time of its oldest row (0 = none yet)
+    time_t last;     // Resolve time of its newest row
+    long rows;
+};
+
+struct ArchivePartition *archivePartitions = NULL;   // Ordered by period
+int archivePartitionCount = 0;
+int archivePartitionCapacity = 0;
+
+// resolvedIdIndex values: partition period above, row offset in its file below
+#define ARCHIVE_OFFSET_BITS 40
+
+long long archiveLocation(int period, long offset) {
+    return ((long long)period << ARCHIVE_OFFSET_BITS) | offset;
+}
+
+// Partition of a resolve time: months since 1970 (local calendar, like
+// the Resolved At column) / ARCHIVE_PARTITION_MONTHS
+int archivePeriod(time_t when) {
+    struct tm tmBuf;
+#ifdef _WIN32
+    tmBuf = *localtime(&when);
+#else
+    localtime_r(&when, &tmBuf);
+#endif
+    int months = (tmBuf.tm_year - 70) * 12 + tmBuf.tm_mon;
+    return months > 0 ? months / ARCHIVE_PARTITION_MONTHS : 0;
+}
+
+// "resolved-YYYY-MM<ext>", after the partition's first month
+void archivePartitionName(int period, const char *ext, char *name, size_t size) {
+    int months = period * ARCHIVE_PARTITION_MONTHS;
+    snprintf(name, size, "resolved-%04d-%02d%s", 1970 + months / 12, months % 12 + 1, ext);
+}
+
+// Partition file: ".csv" rows, ".cols" columnar sidecar (RESOLVED ANALYTICS)
+void archivePartitionPath(int period, const char *ext, char *path, size_t size) {
+    char name[32];
+    archivePartitionName(period, ext, name, sizeof(name));
+    snprintf(path, size, "%s/%s", ARCHIVE_DIR, name);
+}
+
+// The partition for `period`, or NULL
+struct ArchivePartition *findArchivePartition(int period) {
+    for (int i = 0; i < archivePartitionCount; i++) {
+        if (archivePartitions[i].period == period) return &archivePartitions[i];
+    }
+    return NULL;
+}
+
+// The partition for `period`, added (empty) if new; NULL if out of memory.
+// Pointers into archivePartitions are invalidated by the next addition.
+struct ArchivePartition *addArchivePartition(int period) {
+    struct ArchivePartition *p = findArchivePartition(period);
+    if (p) return p;
+
+    if (archivePartitionCount == archivePartitionCapacity) {
+        int grown = archivePartitionCapacity ? archivePartitionCapacity * 2 : 16;
+        struct ArchivePartition *larger = realloc(archivePartitions, (size_t)grown * sizeof(struct ArchivePartition));
+        if (!larger) return NULL;
+        archivePartitions = larger;
+        archivePartitionCapacity = grown;
+    }
+    int i = archivePartitionCount;
+    while (i > 0 && archivePartitions[i - 1].period > period) {
+        archivePartitions[i] = archivePartitions[i - 1];
+        i--;
+    }
+    archivePartitionCount++;
+    p = &archivePartitions[i];
+    p->period = period;
+    p->first = p->last = 0;
+    p->rows = 0;
+    return p;
+}
+
+void countArchivedRows(struct ArchivePartition *p, time_t resolvedAt, long rows) {
+    if (p->rows == 0 || resolvedAt < p->first) p->first = resolvedAt;
+    if (p->rows == 0 || resolvedAt > p->last) p->last = resolvedAt;
+    p->rows += rows;
+}
+
+// Holds a row resolved inside [from, to]?
+int archivePartitionOverlaps(const struct ArchivePartition *p, time_t from, time_t to) {
+    return p->rows > 0 && p->last >= from && p->first <= to;
+}
+
+int writeArchiveManifest() {
+    FILE *f = fopen(ARCHIVE_MANIFEST_TMP, "w");
+    int ok = f != NULL;
+    if (f) {
+        fprintf(f, "# file first_resolved last_resolved rows\n");
+        for (int i = 0; i < archivePartitionCount; i++) {
+            const struct ArchivePartition *p = &archivePartitions[i];
+            char name[32];
+            archivePartitionName(p->period, ".csv", name, sizeof(name));
+            fprintf(f, "%s %lld %lld %ld\n", name, (long long)p->first, (long long)p->last, p->rows);
+        }
+        if (fclose(f) != 0) ok = 0;
+    }
+    if (!ok || !replaceFile(ARCHIVE_MANIFEST_TMP, ARCHIVE_MANIFEST_FILE)) {
+        logError("Cannot write the archive manifest");
+        return 0;
+    }
+    return 1;
+}
+
+void loadArchiveManifest() {
+    archivePartitionCount = 0;
+    FILE *f = fopen(ARCHIVE_MANIFEST_FILE, "r");
+    if (!f) return;
+
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        int year, month;
+        long long first, last;
+        long rows;
+        removeNewline(line);
+        if (sscanf(line, "resolved-%d-%d.csv %lld %lld %ld", &year, &month, &first, &last, &rows) != 5) continue;
+        int months = (year - 1970) * 12 + month - 1;
+        if (months < 0 || months % ARCHIVE_PARTITION_MONTHS != 0) {
+            logEvent(LOG_ERROR, "ERROR: Archive manifest entry %.40s does not match ARCHIVE_PARTITION_MONTHS - ignored", line);
+            continue;
+        }
+        struct ArchivePartition *p = addArchivePartition(months / ARCHIVE_PARTITION_MONTHS);
+        if (!p) break;
+        p->first = (time_t)first;
+        p->last = (time_t)last;
+        p->rows = rows;
+    }
+    fclose(f);
+}
+
+/*
+ * Opens the partition for resolve time `when` for appending (header
+ * written if new) and sets *period. A new partition is listed in the
+ * manifest before its file exists, so no file is ever unlisted.
+ */
+FILE *openArchivePartition(time_t when, int *period) {
+    *period = archivePeriod(when);
+    if (!findArchivePartition(*period)) {
+        if (!addArchivePartition(*period)) return NULL;
+        writeArchiveManifest();
+    }
+
+    char path[64];
+    archivePartitionPath(*period, ".csv", path, sizeof(path));
+    FILE *f = fopen(path, "a");
+    if (!f) {
+        makeSpoolDirectory(ARCHIVE_DIR);
+        f = fopen(path, "a");
+        if (!f) return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    if (ftell(f) == 0) fputs(archiveHeader, f);
+    return f;
+}
+
+// fsyncs and closes a partition opened by openArchivePartition(); 0 on failure
+int closeArchivePartition(FILE *f) {
+    int ok = syncDatabase(f);
+    if (fclose(f) != 0) ok = 0;
+    return ok;
+}
+
+// Opens partition `period` for reading, past its header; NULL if missing
+FILE *readArchivePartition(int period) {
+    char path[64];
+    archivePartitionPath(period, ".csv", path, sizeof(path));
+    FILE *f = fopen(path, "r");
+    char header[ARCHIVE_RECORD_MAX];
+    if (f && !fgets(header, sizeof(header), f)) {
+        fclose(f);
+        return NULL;
+    }
+    return f;
+}
+
+/*
+ * Moves the rows of the single-file archive (RESOLVED_TICKETS_FILE) into
+ * their partitions and indexes them, then leaves the file with just its
+ * header. Startup only, after the partitions have been indexed.
+ */
+void importLegacyArchive() {
+    FILE *in = fopen(RESOLVED_TICKETS_FILE, "r");
+    if (!in) return;
+
+    char line[ARCHIVE_RECORD_MAX];
+    char copy[ARCHIVE_RECORD_MAX];
+    if (!fgets(line, sizeof(line), in)) {
+        fclose(in);
+        return;
+    }
+
+    FILE *out = NULL;
+    int outPeriod = -1;
+    long rows = 0, moved = 0;
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), in)) {
+        size_t len = strlen(line);
+        if (len == 0 || line[0] == '\n') continue;
+        rows++;
+        memcpy(copy, line, len + 1);
+        char *fields[10];
+        int n = splitCSVLine(copy, fields, 10);
+        int id = n >= 1 ? atoi(fields[0]) : 0;
+        if (id > 0 && isArchivedTicket(id)) continue;   // Moved before a crash
+        time_t resolvedAt = n >= 9 ? parseSystemTime(fields[8]) : 0;
+
+        if (archivePeriod(resolvedAt) != outPeriod) {
+            if (out && !closeArchivePartition(out)) ok = 0;
+            out = ok ? openArchivePartition(resolvedAt, &outPeriod) : NULL;
+            if (!out) {
+                ok = 0;
+                break;
+            }
+        }
+        long offset = ftell(out);
+        fputs(line, out);
+        if (line[len - 1] != '\n') fputc('\n', out);
+
+        indexResolvedTicket(id, archiveLocation(outPeriod, offset));
+        if (n >= 3) recordCustomerResolution(fields[2], resolvedAt);
+        countArchivedRows(findArchivePartition(outPeriod), resolvedAt, 1);
+        moved++;
+    }
+    fclose(in);
+    if (out && !closeArchivePartition(out)) ok = 0;
+    if (rows == 0) return;
+
+    // Only once every row is durable in a listed partition
+    FILE *empty = NULL;
+    if (ok && writeArchiveManifest() && (empty = fopen(RESOLVED_TICKETS_FILE ".tmp", "w"))) {
+        fputs(archiveHeader, empty);
+        ok = fclose(empty) == 0 && replaceFile(RESOLVED_TICKETS_FILE ".tmp", RESOLVED_TICKETS_FILE);
+    } else {
+        ok = 0;
+    }
+    if (!ok) {
+        logError("Cannot move " RESOLVED_TICKETS_FILE " into archive partitions - will retry at next start");
+    } else if (moved > 0) {
+        printf(" Moved %ld archived tickets into %s/\n", moved, ARCHIVE_DIR);
+    }
+}
+
+// Drops the rows of the archive file at `path` (partition `period`) from
+// the resolved ID index and the customer history
+void forgetArchivedRows(const char *path, int period) {
+    FILE *f = fopen(path, "r");
+    if (!f) return;
+
+    char line[ARCHIVE_RECORD_MAX];
+    int header = 1;
+    while (fgets(line, sizeof(line), f)) {
+        if (header) {
+            header = 0;
+            continue;
+        }
+        char *fields[3];
+        int n = splitCSVLine(line, fields, 3);
+        if (n >= 1) forgetResolvedTicket(atoi(fields[0]), period);
+        if (n >= 3) forgetCustomerResolution(fields[2]);
+    }
+    fclose(f);
+}
+
+/*
+ * Deletes partitions with nothing resolved in the last ARCHIVE_RETENTION_DAYS.
+ * The CSV is first renamed aside, so a partition that cannot be deleted
+ * stays listed and indexed; once it is out of the way its rows leave the
+ * in-memory indexes before the file goes.
+ */
+void expireArchivePartitions() {
+    if (ARCHIVE_RETENTION_DAYS <= 0 || archivePartitionCount == 0) return;
+
+    time_t now = time(NULL);
+    time_t cutoff = now - (time_t)ARCHIVE_RETENTION_DAYS * 24 * 3600;
+    int current = archivePeriod(now);
+    int kept = 0;
+    for (int i = 0; i < archivePartitionCount; i++) {
+        struct ArchivePartition *p = &archivePartitions[i];
+        if (p->period != current && p->last < cutoff) {
+            char path[64], expired[64];
+            archivePartitionPath(p->period, ".csv", path, sizeof(path));
+            archivePartitionPath(p->period, ".expired", expired, sizeof(expired));
+            if (rename(path, expired) == 0 || errno == ENOENT) {
+                forgetArchivedRows(expired, p->period);
+                remove(expired);
+                archivePartitionPath(p->period, ".cols", expired, sizeof(expired));
+                remove(expired);
+                logEvent(LOG_ARCHIVE, "Archive retention: deleted %s (%ld tickets)", path, p->rows);
+                continue;
+            }
+            logEvent(LOG_ERROR, "ERROR: Archive retention cannot delete %s", path);
+        }
+        archivePartitions[kept++] = *p;
+    }
+    if (kept != archivePartitionCount) {
+        archivePartitionCount = kept;
+        writeArchiveManifest();
+    }
+}
+
+/* ==================== RESOLVED ANALYTICS ==================== */
+
+/*
+ * DESIGN DECISION: Columnar sidecar per archive partition
+ * Questions like "p90 wait of High tickets per product this year" had
+ * to parse every archived CSV row, issue text included. Each partition
+ * now has a .cols file beside it holding only what reports group and
+ * measure: entry time, resolve time, priority, product and resolving
+ * admin, one fixed-width array per column (32-bit times). archiveTickets() appends one
+ * chunk (header + arrays) per call, so a sidecar is always written
+ * after its rows. Product and admin names become 16-bit IDs through a
+ * small append-only dictionary. Reports read the sidecars of the
+ * partitions overlapping their window whole and run two tight loops per
+ * chunk: wait time and window filter over the plain arrays (the compiler
+ * vectorizes it), then histogram buckets per group. Quantiles come from
+ * the METRICS histograms, so they are bucket upper bounds (within 12.5%).
+ * At startup a sidecar whose row count differs from its partition (crash,
+ * legacy import, lost dictionary) is rebuilt from the CSV; past months
+ * are also rewritten as one chunk.
+ */
+
+#define COLUMN_CHUNK_MAGIC 0x31435453u   // "STC1"
+#define COLUMN_NO_ID 0xFFFF              // Dictionary full or unwritable
+
+struct ColumnChunkHeader {
+    uint32_t magic;
+    uint32_t rows;
+};
+
+// Chunk size: header, uint32 entry + resolve times (Unix seconds, 32 bits
+// so that SSE2 can compare them), uint16 product + admin, uint8 priority,
+// padded to 8 bytes so the next header stays aligned
+size_t columnChunkBytes(uint32_t rows) {
+    size_t bytes = sizeof(struct ColumnChunkHeader) + (size_t)rows * (4 + 4 + 2 + 2 + 1);
+    return (bytes + 7) & ~(size_t)7;
+}
+
+// One chunk being built
+struct ResolvedColumns {
+    uint32_t rows;
+    uint32_t capacity;
+    uint32_t *entryTime;
+    uint32_t *resolvedTime;
+    uint16_t *product;
+    uint16_t *admin;
+    uint8_t *priority;
+};
+
+void freeColumns(struct ResolvedColumns *cols) {
+    free(cols->entryTime);
+    free(cols->resolvedTime);
+    free(cols->product);
+    free(cols->admin);
+    free(cols->priority);
+    memset(cols, 0, sizeof(*cols));
+}
+
+int appendColumnRow(struct ResolvedColumns *cols, time_t entry, time_t resolved,
+                    int priority, uint16_t product, uint16_t admin) {
+    if (cols->rows == cols->capacity) {
+        uint32_t grown = cols->capacity ? cols->capacity * 2 : 256;
+        uint32_t *e = realloc(cols->entryTime, grown * sizeof(uint32_t));
+        if (e) cols->entryTime = e;
+        uint32_t *r = realloc(cols->resolvedTime, grown * sizeof(uint32_t));
+        if (r) cols->resolvedTime = r;
+        uint16_t *p = realloc(cols->product, grown * sizeof(uint16_t));
+        if (p) cols->product = p;
+        uint16_t *a = realloc(cols->admin, grown * sizeof(uint16_t));
+        if (a) cols->admin = a;
+        uint8_t *pr = realloc(cols->priority, grown);
+        if (pr) cols->priority = pr;
+        if (!e || !r || !p || !a || !pr) return 0;
+        cols->capacity = grown;
+    }
+    uint32_t i = cols->rows++;
+    cols->entryTime[i] = entry > 0 ? (uint32_t)entry : 0;
+    cols->resolvedTime[i] = resolved > 0 ? (uint32_t)resolved : 0;
+    cols->priority[i] = (uint8_t)priority;
+    cols->product[i] = product;
+    cols->admin[i] = admin;
+    return 1;
+}
+
+// Writes `cols` as one chunk at the end of `f`; 1 on success
+int writeColumnChunk(FILE *f, const struct ResolvedColumns *cols) {
+    static const char padding[8] = {0};
+    struct ColumnChunkHeader header = { COLUMN_CHUNK_MAGIC, cols->rows };
+    size_t n = cols->rows;
+    size_t written = sizeof(header) + n * (4 + 4 + 2 + 2 + 1);
+    size_t pad = columnChunkBytes(cols->rows) - written;
+
+    return fwrite(&header, sizeof(header), 1, f) == 1 &&
+           fwrite(cols->entryTime, sizeof(uint32_t), n, f) == n &&
+           fwrite(cols->resolvedTime, sizeof(uint32_t), n, f) == n &&
+           fwrite(cols->product, sizeof(uint16_t), n, f) == n &&
+           fwrite(cols->admin, sizeof(uint16_t), n, f) == n &&
+           fwrite(cols->priority, 1, n, f) == n &&
+           fwrite(padding, 1, pad, f) == pad;
+}
+
+// Appends `cols` to partition `period`'s sidecar
+void appendColumnChunk(int period, const struct ResolvedColumns *cols) {
+    if (cols->rows == 0) return;
+    char path[64];
+    archivePartitionPath(period, ".cols", path, sizeof(path));
+    FILE *f = fopen(path, "ab");
+    int ok = f && writeColumnChunk(f, cols);
+    if (f && fclose(f) != 0) ok = 0;
+    if (!ok) logEvent(LOG_ERROR, "ERROR: Cannot append to %s - rebuilt at next start", path);
+}
+
+/*
+ * Rows in partition `period`'s sidecar, walking the chunk headers;
+ * *chunks gets the chunk count. -1 if missing or damaged.
+ */
+long columnFileRows(int period, int *chunks) {
+    char path[64];
+    archivePartitionPath(period, ".cols", path, sizeof(path));
+    FILE *f = fopen(path, "rb");
+    *chunks = 0;
+    if (!f) return -1;
+
+    long size = fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+    long offset = 0, rows = 0;
+    struct ColumnChunkHeader header;
+    while (offset < size) {
+        if (fseek(f, offset, SEEK_SET) != 0 || fread(&header, sizeof(header), 1, f) != 1 ||
+            header.magic != COLUMN_CHUNK_MAGIC) break;
+        offset += (long)columnChunkBytes(header.rows);
+        rows += header.rows;
+        (*chunks)++;
+    }
+    fclose(f);
+    // A chunk cut short by a crash ends past the file
+    return offset == size ? rows : -1;
+}
+
+/* Product and admin dictionaries */
+
+enum ColumnDictionary { DICT_PRODUCT, DICT_ADMIN, COLUMN_DICTIONARIES };
+
+const char *columnDictionaryNames[COLUMN_DICTIONARIES] = {"product", "admin"};
+
+struct NameDictionary {
+    char **names;   // Index = ID
+    int count;
+    int capacity;
+};
+
+struct NameDictionary columnDictionaries[COLUMN_DICTIONARIES];
+
+int addDictionaryName(struct NameDictionary *d, const char *name) {
+    if (d->count >= COLUMN_NO_ID) return 0;
+    if (d->count == d->capacity) {
+        int grown = d->capacity ? d->capacity * 2 : 64;
+        char **larger = realloc(d->names, (size_t)grown * sizeof(char *));
+        if (!larger) return 0;
+        d->names = larger;
+        d->capacity = grown;
+    }
+    char *copy = strdup(name);
+    if (!copy) return 0;
+    d->names[d->count++] = copy;
+    return 1;
+}
+
+/*
+ * (Re)reads ANALYTICS_DICTIONARY_FILE. Returns 0 if there is none, in
+ * which case existing sidecars cannot be decoded and are rebuilt.
+ */
+int loadColumnDictionaries() {
+    for (int k = 0; k < COLUMN_DICTIONARIES; k++) {
+        struct NameDictionary *d = &columnDictionaries[k];
+        for (int i = 0; i < d->count; i++) free(d->names[i]);
+        d->count = 0;
+    }
+    FILE *f = fopen(ANALYTICS_DICTIONARY_FILE, "r");
+    if (!f) return 0;
+
+    char line[MAX_PRODUCT_LEN + 32];
+    while (fgets(line, sizeof(line), f)) {
+        removeNewline(line);
+        char *tab = strchr(line, '\t');
+        if (!tab) continue;
+        *tab = '\0';
+        for (int k = 0; k < COLUMN_DICTIONARIES; k++) {
+            if (strcmp(line, columnDictionaryNames[k]) == 0) addDictionaryName(&columnDictionaries[k], tab + 1);
+        }
+    }
+    fclose(f);
+    return 1;
+}
+
+// ID of `name` in dictionary `kind`, added (and appended to the file) if new
+uint16_t dictionaryID(int kind, const char *name) {
+    char clean[MAX_PRODUCT_LEN + 1];
+    copyText(clean, sizeof(clean), name);
+    for (char *c = clean; *c; c++) {
+        if (*c == '\t' || *c == '\n' || *c == '\r') *c = ' ';
+    }
+
+    struct NameDictionary *d = &columnDictionaries[kind];
+    for (int i = 0; i < d->count; i++) {
+        if (strcmp(d->names[i], clean) == 0) return (uint16_t)i;
+    }
+
+    FILE *f = fopen(ANALYTICS_DICTIONARY_FILE, "a");
+    int ok = f && fprintf(f, "%s\t%s\n", columnDictionaryNames[kind], clean) > 0;
+    if (f && fclose(f) != 0) ok = 0;
+    if (!ok || !addDictionaryName(d, clean)) {
+        logError("Cannot extend the analytics dictionary");
+        return COLUMN_NO_ID;
+    }
+    return (uint16_t)(d->count - 1);
+}
+
+// Adds archive row `fields` (CSV columns, see buildArchiveIndexes) to `cols`
+int appendArchivedRow(struct ResolvedColumns *cols, char **fields, int n) {
+    if (n < 10) return 1;
+    return appendColumnRow(cols, parseSystemTime(fields[7]), parseSystemTime(fields[8]),
+                           priorityRank(fields[6]), dictionaryID(DICT_PRODUCT, fields[3]),
+                           dictionaryID(DICT_ADMIN, fields[9]));
+}
+
+// Rewrites partition `period`'s sidecar from its CSV rows, as one chunk
+int rebuildArchiveColumns(int period) {
+    FILE *in = readArchivePartition(period);
+    if (!in) return 0;
+
+    struct ResolvedColumns cols;
+    memset(&cols, 0, sizeof(cols));
+    char line[ARCHIVE_RECORD_MAX];
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), in)) {
+        char *fields[10];
+        int n = splitCSVLine(line, fields, 10);
+        ok = appendArchivedRow(&cols, fields, n);
+    }
+    fclose(in);
+
+    char path[64], tmp[72];
+    archivePartitionPath(period, ".cols", path, sizeof(path));
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *out = ok ? fopen(tmp, "wb") : NULL;
+    ok = out && (cols.rows == 0 || writeColumnChunk(out, &cols));
+    if (out && fclose(out) != 0) ok = 0;
+    ok = ok && replaceFile(tmp, path);
+    if (!ok) logEvent(LOG_ERROR, "ERROR: Cannot rebuild %s", path);
+    freeColumns(&cols);
+    return ok;
+}
+
+/* Reports */
+
+enum ReportGroup { REPORT_PRIORITY, REPORT_PRODUCT, REPORT_ADMIN, REPORT_DAY, REPORT_GROUPS };
+
+const char *reportGroupNames[REPORT_GROUPS] = {"priority", "product", "admin", "day"};
+
+// One group of a report; wait quantiles in seconds
+struct ReportLine {
+    char name[MAX_PRODUCT_LEN + 1];
+    uint64_t count;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+};
+
+int reportGroupFromName(const char *name) {
+    for (int g = 0; g < REPORT_GROUPS; g++) {
+        if (strcasecmp(name, reportGroupNames[g]) == 0) return g;
+    }
+    return -1;
+}
+
+int compareReportCounts(const void *a, const void *b) {
+    const struct ReportLine *x = a, *y = b;
+    if (x->count != y->count) return x->count < y->count ? 1 : -1;
+    return strcmp(x->name, y->name);
+}
+
+// Reads a whole sidecar into memory; NULL if missing or empty
+unsigned char *readColumnFile(int period, size_t *size) {
+    char path[64];
+    archivePartitionPath(period, ".cols", path, sizeof(path));
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    unsigned char *data = NULL;
+    long len = fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+    if (len > 0 && fseek(f, 0, SEEK_SET) == 0 && (data = malloc((size_t)len))) {
+        if (fread(data, 1, (size_t)len, f) != (size_t)len) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(f);
+    *size = data ? (size_t)len : 0;
+    return data;
+}
+
+/*
+ * Resolve wait per `group` for tickets resolved in [from, to]: returns a
+ * malloc'd array of *count lines, NULL if out of memory. Priority and day
+ * lines come in their natural order, product and admin lines by count.
+ * Day groups are 24-hour days from local midnight of `from`.
+ */
+struct ReportLine *buildReport(int group, time_t from, time_t to, int *count) {
+    *count = 0;
+    if (to < from) return calloc(1, sizeof(struct ReportLine));
+    if (group == REPORT_DAY) {
+        struct tm tmBuf;
+#ifdef _WIN32
+        tmBuf = *localtime(&from);
+#else
+        localtime_r(&from, &tmBuf);
+#endif
+        tmBuf.tm_hour = tmBuf.tm_min = tmBuf.tm_sec = 0;
+        tmBuf.tm_isdst = -1;
+        from = mktime(&tmBuf);
+    }
+
+    int keys;
+    switch (group) {
+    case REPORT_PRIORITY: keys = 4; break;
+    case REPORT_PRODUCT: keys = COLUMN_NO_ID + 1; break;
+    case REPORT_ADMIN: keys = COLUMN_NO_ID + 1; break;
+    default: keys = (int)((to - from) / 86400) + 1; break;
+    }
+    uint32_t first = from > 0 ? (uint32_t)from : 0;
+    uint32_t last = (uint32_t)to;
+    struct LatencyHistogram **hist = calloc((size_t)keys, sizeof(*hist));
+    uint32_t batch = 0;
+    uint32_t *wait = NULL;
+    uint32_t *key = NULL;
+    uint8_t *keep = NULL;
+    int failed = hist == NULL;
+
+    for (int p = 0; p < archivePartitionCount && !failed; p++) {
+        if (!archivePartitionOverlaps(&archivePartitions[p], from, to)) continue;
+        size_t size;
+        unsigned char *data = readColumnFile(archivePartitions[p].period, &size);
+        if (!data) continue;
+
+        size_t pos = 0;
+        while (pos + sizeof(struct ColumnChunkHeader) <= size && !failed) {
+            const struct ColumnChunkHeader *header = (const void *)(data + pos);
+            uint32_t rows = header->rows;
+            if (header->magic != COLUMN_CHUNK_MAGIC || pos + columnChunkBytes(rows) > size) break;
+            const uint32_t *entry = (const void *)(data + pos + sizeof(*header));
+            const uint32_t *resolved = entry + rows;
+            const uint16_t *product = (const void *)(resolved + rows);
+            const uint16_t *admin = product + rows;
+            const uint8_t *priority = (const uint8_t *)(admin + rows);
+            pos += columnChunkBytes(rows);
+
+            if (rows > batch) {
+                free(wait);
+                free(key);
+                free(keep);
+                wait = malloc(rows * sizeof(uint32_t));
+                key = malloc(rows * sizeof(uint32_t));
+                keep = malloc(rows);
+                batch = rows;
+                if (!wait || !key || !keep) {
+                    failed = 1;
+                    break;
+                }
+            }
+
+            // Pass 1: straight-line arithmetic over whole columns (vectorized)
+            for (uint32_t i = 0; i < rows; i++) {
+                int32_t w = (int32_t)(resolved[i] - entry[i]);
+                wait[i] = (uint32_t)(w > 0 ? w : 0);
+                keep[i] = (uint8_t)((resolved[i] >= first) & (resolved[i] <= last));
+            }
+            switch (group) {
+            case REPORT_PRIORITY:
+                for (uint32_t i = 0; i < rows; i++) key[i] = priority[i] < 4 ? priority[i] : 3;
+                break;
+            case REPORT_PRODUCT:
+                for (uint32_t i = 0; i < rows; i++) key[i] = product[i];
+                break;
+            case REPORT_ADMIN:
+                for (uint32_t i = 0; i < rows; i++) key[i] = admin[i];
+                break;
+            default:
+                for (uint32_t i = 0; i < rows; i++) key[i] = (resolved[i] - first) / 86400;   // Earlier rows wrap past `keys`
+                break;
+            }
+
+            // Pass 2: histogram buckets of the kept rows
+            for (uint32_t i = 0; i < rows; i++) {
+                if (!keep[i] || key[i] >= (uint32_t)keys) continue;
+                struct LatencyHistogram *h = hist[key[i]];
+                if (!h && !(h = hist[key[i]] = calloc(1, sizeof(*h)))) {
+                    failed = 1;
+                    break;
+                }
+                h->counts[histogramBucket(wait[i])]++;
+                h->total++;
+                h->sumNs += wait[i];
+                if (wait[i] > h->maxNs) h->maxNs = wait[i];
+            }
+        }
+        free(data);
+    }
+    free(wait);
+    free(key);
+    free(keep);
+
+    int groups = 0;
+    for (int k = 0; k < keys && !failed; k++) groups += hist[k] != NULL;
+    struct ReportLine *lines = failed ? NULL : malloc((size_t)(groups ? groups : 1) * sizeof(*lines));
+    failed = lines == NULL;
+
+    for (int k = 0; k < keys && !failed; k++) {
+        struct LatencyHistogram *h = hist[k];
+        if (!h) continue;
+        struct ReportLine *line = &lines[(*count)++];
+        const struct NameDictionary *d = group == REPORT_PRODUCT ? &columnDictionaries[DICT_PRODUCT]
+                                       : group == REPORT_ADMIN ? &columnDictionaries[DICT_ADMIN] : NULL;
+        if (group == REPORT_PRIORITY) {
+            copyText(line->name, sizeof(line->name), priorityNames[k]);
+        } else if (group == REPORT_DAY) {
+            time_t noon = from + (time_t)k * 86400 + 12 * 3600;
+            struct tm tmBuf;
+#ifdef _WIN32
+            tmBuf = *localtime(&noon);
+#else
+            localtime_r(&noon, &tmBuf);
+#endif
+            strftime(line->name, sizeof(line->name), "%Y-%m-%d", &tmBuf);
+        } else if (k < d->count) {
+            copyText(line->name, sizeof(line->name), d->names[k]);
+        } else {
+            snprintf(line->name, sizeof(line->name), "#%d", k);
+        }
+        line->count = h->total;
+        line->p50 = histogramQuantile(h, 0.5);
+        line->p90 = histogramQuantile(h, 0.9);
+        line->p99 = histogramQuantile(h, 0.99);
+    }
+    for (int k = 0; hist && k < keys; k++) free(hist[k]);
+    free(hist);
+    if (failed) {
+        free(lines);
+        *count = 0;
+        return NULL;
+    }
+
+    if (group == REPORT_PRODUCT || group == REPORT_ADMIN) qsort(lines, (size_t)*count, sizeof(*lines), compareReportCounts);
+    return lines;
+}
+
+// Clamps a requested report window to what the archive can hold
+int clampReportDays(int days) {
+    if (days > REPORT_MAX_DAYS) days = REPORT_MAX_DAYS;
+    int retained = ARCHIVE_RETENTION_DAYS + ARCHIVE_PARTITION_MONTHS * 31;
+    if (ARCHIVE_RETENTION_DAYS > 0 && days > retained) days = retained;
+    return days;
+}
+
+// ./main --report: prints a report from the archive on disk and returns the exit code
+int printReport(int group, int days) {
+    days = clampReportDays(days);
+    loadArchiveManifest();
+    loadColumnDictionaries();
+
+    uint64_t startNs = metricsNow();
+    time_t now = time(NULL);
+    int count;
+    struct ReportLine *lines = buildReport(group, now - (time_t)days * 86400, now, &count);
+    if (!lines) {
+        printf("Out of memory building the report\n");
+        return 1;
+    }
+    double ms = (double)(metricsNow() - startNs) / 1e6;
+
+    uint64_t total = 0;
+    printf("Resolve wait by %s, last %d days (hours)\n", reportGroupNames[group], days);
+    printf("%-32s %10s %10s %10s %10s\n", reportGroupNames[group], "tickets", "p50", "p90", "p99");
+    for (int i = 0; i < count; i++) {
+        printf("%-32.32s %10llu %10.1f %10.1f %10.1f\n", lines[i].name, (unsigned long long)lines[i].count,
+               lines[i].p50 / 3600.0, lines[i].p90 / 3600.0, lines[i].p99 / 3600.0);
+        total += lines[i].count;
+    }
+    printf("%llu tickets in %.1f ms\n", (unsigned long long)total, ms);
+    free(lines);
+    return 0;
+}
+
+/* ==================== DUPLICATE DETECTION ==================== */
+
+/*
+ * SMART DUPLICATE DETECTION:
+ * - Prevents spam from impatient users resubmitting same issue
+ * - Allows legitimate recurring issues (check resolved tickets)
+ * - Compares: same email + similar issue text (first 30 chars)
+ */
+
+// Same rule the linear scan used: case-insensitive email + first 30 chars of issue
+int ticketMatchesIssue(const char *ticketEmail, const char *ticketIssue, const char *email, const char *issuePrefix) {
+    if (strcasecmp(ticketEmail, email) != 0) return 0;
+
+    char queueIssuePrefix[31];
+    strncpy(queueIssuePrefix, ticketIssue, 30);
+    queueIssuePrefix[30] = '\0';
+
+    for (int j = 0; queueIssuePrefix[j]; j++) {
+        queueIssuePrefix[j] = tolower(queueIssuePrefix[j]);
+    }
+    return strcmp(issuePrefix, queueIssuePrefix) == 0;
+}
+
+int findDuplicateInQueueIndex(const char *email, const char *issue, const char *issuePrefix);
+
+int isDuplicateInQueue(const char *email, const char *issue) {
+    if (isEmpty()) return 0;
+    
+    char issuePrefix[31];
+    strncpy(issuePrefix, issue, 30);
+    issuePrefix[30] = '\0';
+    
+    // Convert to lowercase for comparison
+    for (int i = 0; issuePrefix[i]; i++) {
+        issuePrefix[i] = tolower(issuePrefix[i]);
+    }
+    
+    // Hash probe on (email, issue prefix) instead of scanning the queue
+    return findDuplicateInQueueIndex(email, issue, issuePrefix);
+}
+
+int isDuplicateInResolved(const char *email, const char *issue, int maxDaysBack) {
+    char issuePrefix[31];
+    strncpy(issuePrefix, issue, 30);
+    issuePrefix[30] = '\0';
+    for (int i = 0; issuePrefix[i]; i++) {
+        issuePrefix[i] = tolower(issuePrefix[i]);
+    }
+    
+    time_t now = time(NULL);
+    time_t cutoffTime = now - (maxDaysBack * 24 * 3600);
+    char line[ARCHIVE_RECORD_MAX];
+    
+    // Only partitions holding tickets resolved inside the window, newest first
+    for (int p = archivePartitionCount - 1; p >= 0; p--) {
+        if (!archivePartitionOverlaps(&archivePartitions[p], cutoffTime, now)) continue;
+        FILE *f = readArchivePartition(archivePartitions[p].period);
+        if (!f) continue;
+        
+        while (fgets(line, sizeof(line), f)) {
+            // Ticket ID, Name, Email, Product, Date, Issue, Priority, Entry Time, Resolved At, Resolved By
+            char *fields[10];
+            if (splitCSVLine(line, fields, 10) < 9 || strcasecmp(fields[2], email) != 0) continue;
+            
+            char csvIssuePrefix[31];
+            strncpy(csvIssuePrefix, fields[5], 30);
+            csvIssuePrefix[30] = '\0';
+            for (int i = 0; csvIssuePrefix[i]; i++) {
+                csvIssuePrefix[i] = tolower(csvIssuePrefix[i]);
+            }
+            
+            if (strcmp(issuePrefix, csvIssuePrefix) == 0 && parseSystemTime(fields[8]) > cutoffTime) {
+                fclose(f);
+                return 1; // Recent duplicate found
+            }
+        }
+        fclose(f);
+    }
+    return 0; // No recent duplicate
+}
+
+/* ==================== CUSTOMER HISTORY ==================== */
+
+// Up to maxHistory archived rows for `email`, newest partitions first
+int getCustomerHistory(const char *email, char history[][512], int maxHistory) {
+    int count = 0;
+    char line[ARCHIVE_RECORD_MAX];
+    char lineCopy[ARCHIVE_RECORD_MAX];
+    
+    for (int p = archivePartitionCount - 1; p >= 0 && count < maxHistory; p--) {
+        FILE *f = readArchivePartition(archivePartitions[p].period);
+        if (!f) continue;
+        
+        while (count < maxHistory && fgets(line, sizeof(line), f)) {
+            removeNewline(line);
+            copyText(lineCopy, sizeof(lineCopy), line);
+            
+            // Email is the 3rd field
+            char *fields[3];
+            if (splitCSVLine(lineCopy, fields, 3) == 3 && strcasecmp(fields[2], email) == 0) {
+                copyText(history[count], 512, line);
+                count++;
+            }
+        }
+        fclose(f);
+    }
+    return count;
+}
+
+/*
+ * CUSTOMER HISTORY INDEX:
+ * The dashboard only needs "how many tickets has this customer had resolved",
+ * so instead of re-reading resolved_tickets.csv for every row we keep an
+ * open-addressing hash map: normalized email -> (resolved count, last resolved).
+ * Built once at startup, updated in archiveTickets().
+ */
+
+struct HistoryEntry {
+    char email[MAX_EMAIL_LEN + 1];   // Normalized key, "" = empty slot
+    unsigned long long hash;
+    int resolvedCount;
+    time_t lastResolved;
+};
+
+struct HistoryEntry *historyTable = NULL;
+int historyCapacity = 0;
+int historySize = 0;
+
+struct HistoryEntry *historyFindSlot(struct HistoryEntry *table, int capacity,
+                                     const char *key, unsigned long long hash) {
+    int mask = capacity - 1;
+    int i = (int)(hash & (unsigned long long)mask);
+    while (table[i].email[0] != '\0') {
+        if (table[i].hash == hash && strcmp(table[i].email, key) == 0) {
+            return &table[i];
+        }
+        i = (i + 1) & mask;
+    }
+    return &table[i];
+}
+
+int historyGrow() {
+    int newCapacity = historyCapacity ? historyCapacity * 2 : HISTORY_INDEX_INITIAL_CAPACITY;
+    struct HistoryEntry *newTable = calloc(newCapacity, sizeof(struct HistoryEntry));
+    if (!newTable) {
+        logError("Memory allocation failed while growing customer history index");
+        return 0;
+    }
+
+    for (int i = 0; i < historyCapacity; i++) {
+        if (historyTable[i].email[0] != '\0') {
+            struct HistoryEntry *slot = historyFindSlot(newTable, newCapacity,
+                                                        historyTable[i].email, historyTable[i].hash);
+            *slot = historyTable[i];
+        }
+    }
+
+    free(historyTable);
+    historyTable = newTable;
+    historyCapacity = newCapacity;
+    return 1;
+}
+
+void recordCustomerResolution(const char *email, time_t resolvedAt) {
+    char key[MAX_EMAIL_LEN + 1];
+    normalizeEmail(email, key, sizeof(key));
+    if (key[0] == '\0') return;
+
+    // Keep load factor under 70%
+    if ((historySize + 1) * 10 > historyCapacity * 7 && !historyGrow()) return;
+
+    unsigned long long hash = hashString(key);
+    struct HistoryEntry *slot = historyFindSlot(historyTable, historyCapacity, key, hash);
+    if (slot->email[0] == '\0') {
+        strcpy(slot->email, key);
+        slot->hash = hash;
+        slot->resolvedCount = 0;
+        slot->lastResolved = 0;
+        historySize++;
+    }
+    slot->resolvedCount++;
+    if (resolvedAt > slot->lastResolved) slot->lastResolved = resolvedAt;
+}
+
+// Undoes one recordCustomerResolution() (its partition was deleted). The
+// slot stays; a count of 0 reads as no history.
+void forgetCustomerResolution(const char *email) {
+    if (!historyTable) return;
+    char key[MAX_EMAIL_LEN + 1];
+    normalizeEmail(email, key, sizeof(key));
+    if (key[0] == '\0') return;
+
+    struct HistoryEntry *slot = historyFindSlot(historyTable, historyCapacity, key, hashString(key));
+    if (slot->email[0] == '\0' || slot->resolvedCount == 0) return;
+    if (--slot->resolvedCount == 0) slot->lastResolved = 0;
+}
+
+// Returns resolved-ticket count for the customer (0 if none); O(1) average
+int lookupCustomerHistory(const char *email, time_t *lastResolved) {
+    if (lastResolved) *lastResolved = 0;
+    if (!historyTable) return 0;
+
+    char key[MAX_EMAIL_LEN + 1];
+    normalizeEmail(email, key, sizeof(key));
+    if (key[0] == '\0') return 0;
+
+    struct HistoryEntry *slot = historyFindSlot(historyTable, historyCapacity, key, hashString(key));
+    if (slot->email[0] == '\0') return 0;
+    if (lastResolved) *lastResolved = slot->lastResolved;
+    return slot->resolvedCount;
+}
+
+void resetCustomerHistoryIndex() {
+    free(historyTable);
+    historyTable = NULL;
+    historyCapacity = 0;
+    historySize = 0;
+}
+
+/*
+ * One pass over the archive at startup: customer history + resolved ID
+ * index. Recounts the manifest from the partitions, moves the legacy
+ * single-file archive into them and brings their column files up to date.
+ */
+void buildArchiveIndexes() {
+    resetCustomerHistoryIndex();
+    if (!makeSpoolDirectory(ARCHIVE_DIR)) logError("Cannot create " ARCHIVE_DIR " directory");
+    loadArchiveManifest();
+    int haveDictionary = loadColumnDictionaries();
+
+    char line[ARCHIVE_RECORD_MAX];
+    for (int p = 0; p < archivePartitionCount; p++) {
+        struct ArchivePartition *part = &archivePartitions[p];
+        part->rows = 0;
+        FILE *f = readArchivePartition(part->period);
+        if (!f) continue;
+
+        long offset = ftell(f);
+        while (fgets(line, sizeof(line), f)) {
+            // Ticket ID, Name, Email, Product, Date, Issue, Priority, Entry Time, Resolved At, Resolved By
+            char *fields[10];
+            int n = splitCSVLine(line, fields, 10);
+            time_t resolvedAt = n >= 9 ? parseSystemTime(fields[8]) : 0;
+            if (n >= 1) indexResolvedTicket(atoi(fields[0]), archiveLocation(part->period, offset));
+            if (n >= 3) recordCustomerResolution(fields[2], resolvedAt);
+            countArchivedRows(part, resolvedAt, 1);
+            offset = ftell(f);
+        }
+        fclose(f);
+    }
+
+    importLegacyArchive();
+    writeArchiveManifest();
+
+    // Stale sidecars are rebuilt; past months' appended chunks merged into one
+    int current = archivePeriod(time(NULL));
+    for (int p = 0; p < archivePartitionCount; p++) {
+        int chunks;
+        long rows = columnFileRows(archivePartitions[p].period, &chunks);
+        if (!haveDictionary || rows != archivePartitions[p].rows ||
+            (chunks > 1 && archivePartitions[p].period != current)) {
+            rebuildArchiveColumns(archivePartitions[p].period);
+        }
+    }
+    seedWaitSketches();
+}
+
+/* ==================== TICKET INDEXES ==================== */
+
+/*
+ * DESIGN DECISION: Hash indexes for ticket lookups
+ * Status checks, resolves and duplicate probes used to walk the queue (or
+ * parse the CSVs). Three open-addressing tables answer them in O(1):
+ *   queueIdIndex        ticket ID -> queue slot
+ *   queueDuplicateIndex duplicateKey(email, issue) -> ticket ID (multi-valued)
+ *   resolvedIdIndex     ticket ID -> byte offset of its row in the archive
+ * The queue tables are maintained by enqueue/dequeue/removeTicketAt and
+ * every hit is checked against the queue itself, so a stale entry can
+ * never produce a wrong answer.
+ */
+
+struct IndexEntry {
+    unsigned long long key;
+    int ticketID;           // 0 = empty slot (valid IDs start at MIN_TICKET_ID)
+    long long value;        // Queue slot or archive location
+};
+
+struct IndexTable {
+    struct IndexEntry *entries;
+    int capacity;           // Power of two
+    int size;
+};
+
+struct IndexTable queueIdIndex = {NULL, 0, 0};
+struct IndexTable queueDuplicateIndex = {NULL, 0, 0};
+struct IndexTable resolvedIdIndex = {NULL, 0, 0};
+
+int indexHome(const struct IndexTable *table, unsigned long long key) {
+    return (int)(((key * 0x9E3779B97F4A7C15ULL) >> 32) & (unsigned long long)(table->capacity - 1));
+}
+
+int indexGrow(struct IndexTable *table) {
+    int newCapacity = table->capacity ? table->capacity * 2 : HISTORY_INDEX_INITIAL_CAPACITY;
+    struct IndexEntry *newEntries = calloc(newCapacity, sizeof(struct IndexEntry));
+    if (!newEntries) {
+        logError("Memory allocation failed while growing ticket index");
+        return 0;
+    }
+
+    struct IndexTable grown = {newEntries, newCapacity, 0};
+    for (int i = 0; i < table->capacity; i++) {
+        if (table->entries[i].ticketID == 0) continue;
+        int j = indexHome(&grown, table->entries[i].key);
+        while (newEntries[j].ticketID != 0) j = (j + 1) & (newCapacity - 1);
+        newEntries[j] = table->entries[i];
+    }
+
+    free(table->entries);
+    table->entries = newEntries;
+    table->capacity = newCapacity;
+    return 1;
+}
+
+/*
+ * Inserts (key, ticketID) -> value. An existing entry for the same pair is
+ * updated in place, so a table keyed by ticket ID stays unique.
+ */
+void indexPut(struct IndexTable *table, unsigned long long key, int ticketID, long long value) {
+    if ((table->size + 1) * 10 > table->capacity * 7 && !indexGrow(table)) return;
+
+    int mask = table->capacity - 1;
+    int i = indexHome(table, key);
+    while (table->entries[i].ticketID != 0) {
+        if (table->entries[i].key == key && table->entries[i].ticketID == ticketID) {
+            table->entries[i].value = value;
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    table->entries[i].key = key;
+    table->entries[i].ticketID = ticketID;
+    table->entries[i].value = value;
+    table->size++;
+}
+
+// Returns the entry for (key, ticketID), or NULL
+struct IndexEntry *indexFind(const struct IndexTable *table, unsigned long long key, int ticketID) {
+    if (!table->entries) return NULL;
+
+    int mask = table->capacity - 1;
+    int i = indexHome(table, key);
+    while (table->entries[i].ticketID != 0) {
+        if (table->entries[i].key == key && table->entries[i].ticketID == ticketID) {
+            return &table->entries[i];
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+void indexRemove(struct IndexTable *table, unsigned long long key, int ticketID) {
+    struct IndexEntry *e = indexFind(table, key, ticketID);
+    if (!e) return;
+
+    int mask = table->capacity - 1;
+    int hole = (int)(e - table->entries);
+    int j = hole;
+    while (1) {
+        j = (j + 1) & mask;
+        if (table->entries[j].ticketID == 0) break;
+
+        int home = indexHome(table, table->entries[j].key);
+        // Move j into the hole unless its home lies cyclically in (hole, j]
+        int stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (!stays) {
+            table->entries[hole] = table->entries[j];
+            hole = j;
+        }
+    }
+    memset(&table->entries[hole], 0, sizeof(struct IndexEntry));
+    table->size--;
+}
+
+void indexClear(struct IndexTable *table) {
+    if (table->entries) memset(table->entries, 0, (size_t)table->capacity * sizeof(struct IndexEntry));
+    table->size = 0;
+}
+
+// True if `slot` currently holds a queued ticket with this ID
+int slotHoldsTicket(int slot, int id) {
+    if (isEmpty() || slot < 0 || slot >= MAX) return 0;
+    if ((slot - front + MAX) % MAX > (rear - front + MAX) % MAX) return 0;
+    return queue[slot].ticketID == id;
+}
+
+void indexQueuedTicket(int slot) {
+    const struct QueuedTicket *q = &queue[slot];
+    if (q->ticketID <= 0) return;
+    indexPut(&queueIdIndex, (unsigned long long)q->ticketID, q->ticketID, slot);
+    indexPut(&queueDuplicateIndex, q->dupKey, q->ticketID, 0);
+}
+
+// A ticket moved to `slot`: only its slot changes (its duplicate key stays)
+void reindexMovedTicket(int slot) {
+    const struct QueuedTicket *q = &queue[slot];
+    if (q->ticketID <= 0) return;
+    indexPut(&queueIdIndex, (unsigned long long)q->ticketID, q->ticketID, slot);
+}
+
+void unindexQueuedTicket(const struct QueuedTicket *q) {
+    if (q->ticketID <= 0) return;
+    indexRemove(&queueIdIndex, (unsigned long long)q->ticketID, q->ticketID);
+    indexRemove(&queueDuplicateIndex, q->dupKey, q->ticketID);
+}
+
+void clearQueueIndexes() {
+    indexClear(&queueIdIndex);
+    indexClear(&queueDuplicateIndex);
+}
+
+// Queue slot of ticket `id`, or -1; O(1) average
+int lookupQueuedTicket(int id) {
+    struct IndexEntry *e = indexFind(&queueIdIndex, (unsigned long long)id, id);
+    if (e && slotHoldsTicket((int)e->value, id)) return (int)e->value;
+    return -1;
+}
+
+// ID of a queued ticket with duplicate key `key` matching email and issue prefix, or 0
+int findDuplicateByKey(unsigned long long key, const char *email, const char *issuePrefix) {
+    if (!queueDuplicateIndex.entries) return 0;
+
+    int mask = queueDuplicateIndex.capacity - 1;
+    int i = indexHome(&queueDuplicateIndex, key);
+    int found = 0;
+
+    // Several tickets may share a key; return the one nearest the front
+    while (queueDuplicateIndex.entries[i].ticketID != 0) {
+        struct IndexEntry *e = &queueDuplicateIndex.entries[i];
+        if (e->key == key) {
+            int slot = lookupQueuedTicket(e->ticketID);
+            if (slot >= 0 && ticketMatchesIssue(ticketText(&queue[slot], FIELD_EMAIL),
+                                                 ticketText(&queue[slot], FIELD_ISSUE), email, issuePrefix) &&
+                (!found || queuePosition(slot) < queuePosition(lookupQueuedTicket(found)))) {
+                found = e->ticketID;
+            }
+        }
+        i = (i + 1) & mask;
+    }
+    return found;
+}
+
+// ID of a queued ticket with the same email and issue prefix, or 0
+int findDuplicateInQueueIndex(const char *email, const char *issue, const char *issuePrefix) {
+    return findDuplicateByKey(duplicateKey(email, issue), email, issuePrefix);
+}
+
+extern int maxResolvedTicketID;
+
+// Records where ticket `id` was written in the resolved archive (archiveLocation())
+void indexResolvedTicket(int id, long long location) {
+    if (id <= 0) return;
+    indexPut(&resolvedIdIndex, (unsigned long long)id, id, location);
+    if (id > maxResolvedTicketID) maxResolvedTicketID = id;
+}
+
+// Drops ticket `id` from the resolved index if its row is in partition `period`
+void forgetResolvedTicket(int id, int period) {
+    struct IndexEntry *e = indexFind(&resolvedIdIndex, (unsigned long long)id, id);
+    if (e && (int)(e->value >> ARCHIVE_OFFSET_BITS) == period) {
+        indexRemove(&resolvedIdIndex, (unsigned long long)id, id);
+    }
+}
+
+int isArchivedTicket(int id) {
+    return indexFind(&resolvedIdIndex, (unsigned long long)id, id) != NULL;
+}
+
+/*
+ * Reads ticket `id`'s archive row into `line` and splits it into `fields`.
+ * Returns the field count, or 0 if the ticket was never resolved.
+ */
+int lookupResolvedTicket(int id, char *line, size_t lineSize, char **fields, int maxFields) {
+    struct IndexEntry *e = indexFind(&resolvedIdIndex, (unsigned long long)id, id);
+    if (!e) return 0;
+
+    FILE *f = readArchivePartition((int)(e->value >> ARCHIVE_OFFSET_BITS));
+    if (!f) return 0;   // Deleted by retention
+
+    long offset = (long)(e->value & ((1LL << ARCHIVE_OFFSET_BITS) - 1));
+    int n = 0;
+    if (fseek(f, offset, SEEK_SET) == 0 && fgets(line, (int)lineSize, f)) {
+        removeNewline(line);
+        n = splitCSVLine(line, fields, maxFields);
+        if (n < 1 || atoi(fields[0]) != id) n = 0;   // Archive rewritten under us
+    }
+    fclose(f);
+    return n;
+}
+
+/* ==================== COLD TICKET FIELDS ==================== */
+
+/*
+ * DESIGN DECISION: Cold fields stay in the active database
+ * Escalation, statistics, ordering and the duplicate indexes only need a
+ * ticket's ID, priority, entry time, email and duplicate key. With
+ * --cold-fields, a ticket that has a row in the active database keeps
+ * only those in memory, plus the row's byte offset. Name, product,
+ * purchase date and issue are decoded from a read-only mapping of the
+ * file when something asks for them. The owner thread keeps the last
+ * COLD_FIELD_CACHE_ENTRIES decoded tickets in an LRU, so repeated status
+ * queries do not re-parse the row. Views and queue copies hold a
+ * reference to the mapping they were taken with; the renderer and the
+ * compaction worker decode from it directly. The engine only appends to
+ * the file or renames a new one over it, so a mapping never changes
+ * under a reader. After its own rewrites the engine points every cold
+ * ticket at its row in the new file (relocateColdRows). Reads check the
+ * row's ticket ID, so a file replaced by someone else shows up as an
+ * unreadable row, never as another ticket's text.
+ */
+
+int coldFieldMode = 0;   // Set by --cold-fields
+
+struct DatabaseMap {
+    int refs;
+    const char *data;
+    size_t length;
+};
+
+struct DatabaseMap *databaseMap = NULL;   // Owner thread's mapping of the active database
+
+void retainDatabaseMap(struct DatabaseMap *map) {
+    if (map) __atomic_fetch_add(&map->refs, 1, __ATOMIC_RELAXED);
+}
+
+void releaseDatabaseMap(struct DatabaseMap *map) {
+    if (!map || __atomic_sub_fetch(&map->refs, 1, __ATOMIC_ACQ_REL) != 0) return;
+#ifndef _WIN32
+    if (map->length > 0) munmap((void *)map->data, map->length);
+#endif
+    free(map);
+}
+
+// Maps the active database as it is now (owner thread); keeps the old mapping on failure
+struct DatabaseMap *refreshDatabaseMap() {
+#ifndef _WIN32
+    struct DatabaseMap *map = calloc(1, sizeof(struct DatabaseMap));
+    int fd = open(PENDING_TICKETS_FILE, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    void *data = NULL;
+    if (map && fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0) {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    if (!map || fd < 0 || data == MAP_FAILED) {
+        logError("Cannot map the active database for cold fields");
+        free(map);
+        if (fd >= 0) close(fd);
+        return databaseMap;
+    }
+    close(fd);
+    map->refs = 1;
+    map->data = data;
+    map->length = data ? (size_t)st.st_size : 0;
+    releaseDatabaseMap(databaseMap);
+    databaseMap = map;
+#endif
+    return databaseMap;
+}
+
+// The owner's mapping, remapped first if it ends before `row`
+struct DatabaseMap *databaseMapFor(long row) {
+    if (!databaseMap || row >= (long)databaseMap->length) refreshDatabaseMap();
+    return databaseMap;
+}
+
+/*
+ * Decodes the text fields of ticket `id` from its row at byte `row` of
+ * `map` (any thread: the mapping is read-only). Returns 0, fields empty,
+ * if there is no complete row for that ticket there.
+ */
+int readTicketRow(const struct DatabaseMap *map, long row, int id, struct Ticket *t) {
+    t->customerName[0] = t->email[0] = t->product[0] = t->purchaseDate[0] = t->issueDescription[0] = '\0';
+    if (!map || row < 0 || row >= (long)map->length) return 0;
+
+    const char *start = map->data + row;
+    size_t avail = map->length - (size_t)row;
+    const char *end = memchr(start, '\n', avail < TICKET_RECORD_MAX ? avail : TICKET_RECORD_MAX);
+    if (!end) return 0;
+
+    char line[TICKET_RECORD_MAX];
+    memcpy(line, start, (size_t)(end - start));
+    line[end - start] = '\0';
+    char *fields[8];
+    if (splitCSVLine(line, fields, 8) < 6 || atoi(fields[0]) != id) return 0;
+
+    copyText(t->customerName, sizeof(t->customerName), fields[1]);
+    copyText(t->email, sizeof(t->email), fields[2]);
+    copyText(t->product, sizeof(t->product), fields[3]);
+    copyText(t->purchaseDate, sizeof(t->purchaseDate), fields[4]);
+    copyText(t->issueDescription, sizeof(t->issueDescription), fields[5]);
+    return 1;
+}
+
+struct ColdCacheEntry {
+    struct Ticket fields;   // Text fields of the cached ticket
+    int ticketID;           // 0 = holds nothing
+    int prev, next;         // LRU list, most recent first (-1 = none)
+};
+
+struct ColdCacheEntry coldCache[COLD_FIELD_CACHE_ENTRIES];
+struct IndexTable coldCacheIndex = {NULL, 0, 0};   // Ticket ID -> entry
+int coldCacheHead = -1;
+int coldCacheTail = -1;
+int coldCacheUsed = 0;                             // Entries ever handed out
+
+void coldCacheUnlink(int i) {
+    struct ColdCacheEntry *e = &coldCache[i];
+    if (e->prev >= 0) coldCache[e->prev].next = e->next; else coldCacheHead = e->next;
+    if (e->next >= 0) coldCache[e->next].prev = e->prev; else coldCacheTail = e->prev;
+}
+
+// Links entry i at the front (most recent) or, with `last`, at the back
+void coldCacheLink(int i, int last) {
+    struct ColdCacheEntry *e = &coldCache[i];
+    if (last) {
+        e->next = -1;
+        e->prev = coldCacheTail;
+        if (coldCacheTail >= 0) coldCache[coldCacheTail].next = i; else coldCacheHead = i;
+        coldCacheTail = i;
+    } else {
+        e->prev = -1;
+        e->next = coldCacheHead;
+        if (coldCacheHead >= 0) coldCache[coldCacheHead].prev = i; else coldCacheTail = i;
+        coldCacheHead = i;
+    }
+}
+
+/*
+ * Name, product, purchase date and issue of cold ticket `q` (owner
+ * thread): from the cache, else decoded from the database. On a read
+ * error the fields are empty (logged). Valid until the next cold read.
+ */
+const struct Ticket *coldTicketFields(const struct QueuedTicket *q) {
+    struct IndexEntry *hit = indexFind(&coldCacheIndex, (unsigned long long)q->ticketID, q->ticketID);
+    if (hit) {
+        int i = (int)hit->value;
+        coldCacheUnlink(i);
+        coldCacheLink(i, 0);
+        return &coldCache[i].fields;
+    }
+
+    // Take a fresh entry, or evict the least recently used one
+    int i;
+    if (coldCacheUsed < COLD_FIELD_CACHE_ENTRIES) {
+        i = coldCacheUsed++;
+    } else {
+        i = coldCacheTail;
+        coldCacheUnlink(i);
+        if (coldCache[i].ticketID) {
+            indexRemove(&coldCacheIndex, (unsigned long long)coldCache[i].ticketID, coldCache[i].ticketID);
+        }
+    }
+    struct ColdCacheEntry *e = &coldCache[i];
+    e->ticketID = 0;
+
+    // A row missing from the mapping may have been appended since it was taken
+    if (!readTicketRow(databaseMapFor(q->row), q->row, q->ticketID, &e->fields) &&
+        !readTicketRow(refreshDatabaseMap(), q->row, q->ticketID, &e->fields)) {
+        logEvent(LOG_ERROR, "ERROR: Cannot read ticket #%d from the active database", q->ticketID);
+        coldCacheLink(i, 1);   // Uncached: first to be reused
+        return &e->fields;
+    }
+    e->ticketID = q->ticketID;
+    indexPut(&coldCacheIndex, (unsigned long long)q->ticketID, q->ticketID, i);
+    coldCacheLink(i, 0);
+    return &e->fields;
+}
+
+// Drops ticket `id` from the cache (it left the queue)
+void forgetColdFields(int id) {
+    struct IndexEntry *hit = indexFind(&coldCacheIndex, (unsigned long long)id, id);
+    if (!hit) return;
+    int i = (int)hit->value;
+    indexRemove(&coldCacheIndex, (unsigned long long)id, id);
+    coldCache[i].ticketID = 0;
+    coldCacheUnlink(i);
+    coldCacheLink(i, 1);
+}
+
+void clearColdFieldCache() {
+    indexClear(&coldCacheIndex);
+    coldCacheHead = coldCacheTail = -1;
+    coldCacheUsed = 0;
+}
+
+// A reference to a mapping that holds every cold ticket's row, or NULL if none is cold
+struct DatabaseMap *holdColdRows() {
+    int count = isEmpty() ? 0 : (rear - front + MAX) % MAX + 1;
+    long last = -1;
+    for (int n = 0; n < count; n++) {
+        long row = queue[(front + n) % MAX].row;
+        if (row > last) last = row;
+    }
+    if (last < 0) return NULL;
+    struct DatabaseMap *map = databaseMapFor(last);
+    retainDatabaseMap(map);
+    return map;
+}
+
+// Moves cold ticket q's fields into the arena, reading them from `map`
+void pinTicketText(struct QueuedTicket *q, const struct DatabaseMap *map) {
+    struct Ticket t;
+    if (!expandTicketFrom(textArena, map, q, &t)) {
+        logEvent(LOG_ERROR, "ERROR: Lost the text of ticket #%d while relocating cold fields", q->ticketID);
+    }
+    struct QueuedTicket pinned;
+    if (!storeTicket(&pinned, &t, q->dupKey, -1)) return;
+    releaseTicketText(q);
+    *q = pinned;
+}
+
+/*
+ * The engine replaced the active database: maps the new file and points
+ * every cold ticket at its row there (one pass over the file). A ticket
+ * without a row in the new file keeps its text in the arena instead,
+ * read from `old` - a mapping of the replaced file from holdColdRows().
+ */
+void relocateColdRows(const struct DatabaseMap *old) {
+    int count = isEmpty() ? 0 : (rear - front + MAX) % MAX + 1;
+    if (!old || count == 0) return;
+
+    long *rows = malloc((size_t)count * sizeof(long));
+    struct DatabaseMap *map = refreshDatabaseMap();
+    for (int n = 0; rows && n < count; n++) rows[n] = -1;
+
+    if (rows && map && map->length > 0) {
+        const char *end = map->data + map->length;
+        const char *p = memchr(map->data, '\n', map->length);   // Past the header
+        while (p && ++p < end) {
+            long id = 0;
+            for (const char *c = p; c < end && isdigit((unsigned char)*c) && id <= MAX_TICKET_ID; c++) {
+                id = id * 10 + (*c - '0');
+            }
+            int slot = id > 0 && id <= MAX_TICKET_ID ? lookupQueuedTicket((int)id) : -1;
+            if (slot >= 0) {
+                int n = (slot - front + MAX) % MAX;
+                if (rows[n] < 0) rows[n] = (long)(p - map->data);
+            }
+            p = memchr(p, '\n', (size_t)(end - p));
+        }
+    }
+
+    for (int n = 0; n < count; n++) {
+        struct QueuedTicket *q = &queue[(front + n) % MAX];
+        if (q->row < 0) continue;
+        if (rows && rows[n] >= 0) q->row = rows[n];
+        else pinTicketText(q, old);
+    }
+    free(rows);
+}
+
+/* ==================== QUEUE STATISTICS ==================== */
+
+/*
+ * Count, average wait and oldest ticket from the counters the queue
+ * operations keep (priorityCounts, queuedEntryTimeSum); the front ticket
+ * is the oldest because the queue holds tickets in arrival order.
+ */
+void getQueueStats(int *total, double *avgWaitHours, int *oldestHours, int priorities[4]) {
+    // Maintained incrementally by the queue operations
+    memcpy(priorities, priorityCounts, sizeof(priorityCounts));
+    *total = isEmpty() ? 0 : queuePosition(rear);
+    *avgWaitHours = 0.0;
+    *oldestHours = 0;
+    if (*total == 0) return;
+
+    time_t now = time(NULL);
+    *avgWaitHours = ((double)now - (double)queuedEntryTimeSum / *total) / 3600.0;
+    double oldest = difftime(now, queue[front].queueEntryTime) / 3600.0;
+    if (oldest > 0) *oldestHours = (int)oldest;
+}
+
+/* ==================== WAIT TIME SKETCHES ==================== */
+
+/*
+ * DESIGN DECISION: Decayed log-bucket histograms of resolve waits
+ * Average wait and oldest ticket say little about the tail. Every resolve
+ * (archiveTickets) adds its ticket's wait to a histogram for its priority
+ * and one for its product (analytics dictionary ID), with the METRICS
+ * bucket layout in seconds (within 12.5%). Weights halve every
+ * WAIT_SKETCH_HALF_LIFE_HOURS, applied lazily to the whole histogram when
+ * it is next touched, so the quantiles follow recent service rather than
+ * the engine's lifetime. Reading p50/p90/p99 walks the buckets, whatever
+ * the queue depth. At startup the sketches are seeded from the recent
+ * archive sidecars with the weight each ticket would have decayed to.
+ */
+
+#define WAIT_SKETCH_BUCKETS (24 * HIST_SUB_BUCKETS)   // Waits up to 2^23 s (~97 days)
+
+struct WaitSketch {
+    double counts[WAIT_SKETCH_BUCKETS];
+    double total;
+    time_t decayedAt;   // Time the weights are relative to
+};
+
+// Quantiles of one sketch, in seconds; weight = decayed ticket count
+struct WaitQuantiles {
+    char name[MAX_PRODUCT_LEN + 1];
+    double weight;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+};
+
+struct WaitSketch prioritySketches[4];
+struct WaitSketch *productSketches = NULL;   // Indexed by product dictionary ID
+int productSketchCount = 0;
+
+// Brings the weights of `s` forward to `now`
+void decayWaitSketch(struct WaitSketch *s, time_t now) {
+    if (s->decayedAt == 0 || s->total == 0.0) {
+        s->decayedAt = now;
+        return;
+    }
+    if (now <= s->decayedAt) return;
+    double factor = pow(0.5, difftime(now, s->decayedAt) / (WAIT_SKETCH_HALF_LIFE_HOURS * 3600.0));
+    for (int i = 0; i < WAIT_SKETCH_BUCKETS; i++) s->counts[i] *= factor;
+    s->total *= factor;
+    s->decayedAt = now;
+}
+
+void addWaitSample(struct WaitSketch *s, time_t now, double waitSeconds, double weight) {
+    decayWaitSketch(s, now);
+    int bucket = histogramBucket(waitSeconds > 0 ? (uint64_t)waitSeconds : 0);
+    if (bucket >= WAIT_SKETCH_BUCKETS) bucket = WAIT_SKETCH_BUCKETS - 1;
+    s->counts[bucket] += weight;
+    s->total += weight;
+}
+
+// The sketch of product dictionary ID `product`, added if new; NULL if out of memory
+struct WaitSketch *productWaitSketch(uint16_t product) {
+    if (product == COLUMN_NO_ID) return NULL;
+    if (product >= productSketchCount) {
+        int grown = product + 16;
+        struct WaitSketch *larger = realloc(productSketches, (size_t)grown * sizeof(struct WaitSketch));
+        if (!larger) return NULL;
+        memset(larger + productSketchCount, 0, (size_t)(grown - productSketchCount) * sizeof(struct WaitSketch));
+        productSketches = larger;
+        productSketchCount = grown;
+    }
+    return &productSketches[product];
+}
+
+// A resolved ticket's wait, at resolve time `now` (product from dictionaryID())
+void recordResolvedWait(int priority, uint16_t product, time_t entryTime, time_t now) {
+    double wait = difftime(now, entryTime);
+    addWaitSample(&prioritySketches[priority & 3], now, wait, 1.0);
+    struct WaitSketch *s = productWaitSketch(product);
+    if (s) addWaitSample(s, now, wait, 1.0);
+}
+
+void resetWaitSketches() {
+    memset(prioritySketches, 0, sizeof(prioritySketches));
+    free(productSketches);
+    productSketches = NULL;
+    productSketchCount = 0;
+}
+
+/*
+ * Rebuilds the sketches from the sidecars of the partitions resolved in
+ * the last 8 half-lives (older tickets would weigh under 0.4%).
+ */
+void seedWaitSketches() {
+    resetWaitSketches();
+    time_t now = time(NULL);
+    double halfLife = WAIT_SKETCH_HALF_LIFE_HOURS * 3600.0;
+    time_t from = now - (time_t)(8 * halfLife);
+
+    for (int p = 0; p < archivePartitionCount; p++) {
+        if (!archivePartitionOverlaps(&archivePartitions[p], from, now)) continue;
+        size_t size;
+        unsigned char *data = readColumnFile(archivePartitions[p].period, &size);
+        size_t pos = 0;
+        while (data && pos + sizeof(struct ColumnChunkHeader) <= size) {
+            const struct ColumnChunkHeader *header = (const void *)(data + pos);
+            uint32_t rows = header->rows;
+            if (header->magic != COLUMN_CHUNK_MAGIC || pos + columnChunkBytes(rows) > size) break;
+            const uint32_t *entry = (const void *)(data + pos + sizeof(*header));
+            const uint32_t *resolved = entry + rows;
+            const uint16_t *product = (const void *)(resolved + rows);
+            const uint8_t *priority = (const uint8_t *)(product + 2 * (size_t)rows);
+            pos += columnChunkBytes(rows);
+
+            for (uint32_t i = 0; i < rows; i++) {
+                if ((time_t)resolved[i] < from || (time_t)resolved[i] > now) continue;
+                double weight = pow(0.5, difftime(now, (time_t)resolved[i]) / halfLife);
+                double wait = (double)resolved[i] - (double)entry[i];
+                addWaitSample(&prioritySketches[priority[i] & 3], now, wait, weight);
+                struct WaitSketch *s = productWaitSketch(product[i]);
+                if (s) addWaitSample(s, now, wait, weight);
+            }
+        }
+        free(data);
+    }
+}
+
+// Quantiles of `s` as of `now` (decays it first)
+void waitSketchQuantiles(struct WaitSketch *s, time_t now, struct WaitQuantiles *out) {
+    static const double quantiles[3] = {0.5, 0.9, 0.99};
+    uint32_t *values[3] = {&out->p50, &out->p90, &out->p99};
+    decayWaitSketch(s, now);
+    out->weight = s->total;
+    out->p50 = out->p90 = out->p99 = 0;
+    if (s->total <= 0.0) return;
+
+    double seen = 0.0;
+    int q = 0;
+    for (int i = 0; i < WAIT_SKETCH_BUCKETS && q < 3; i++) {
+        seen += s->counts[i];
+        while (q < 3 && seen > quantiles[q] * s->total) *values[q++] = (uint32_t)histogramBucketHigh(i);
+    }
+    while (q < 3) *values[q++] = (uint32_t)histogramBucketHigh(WAIT_SKETCH_BUCKETS - 1);
+}
+
+int compareWaitWeights(const void *a, const void *b) {
+    const struct WaitQuantiles *x = a, *y = b;
+    return (x->weight < y->weight) - (x->weight > y->weight);
+}
+
+/*
+ * Resolve-wait quantiles per priority (Critical..Low) and for the
+ * `maxProducts` busiest products; returns the product count. Owner thread.
+ */
+int getWaitQuantiles(struct WaitQuantiles byPriority[4], struct WaitQuantiles *byProduct, int maxProducts) {
+    time_t now = time(NULL);
+    for (int p = 0; p < 4; p++) {
+        waitSketchQuantiles(&prioritySketches[p], now, &byPriority[p]);
+        copyText(byPriority[p].name, sizeof(byPriority[p].name), priorityNames[p]);
+    }
+
+    const struct NameDictionary *names = &columnDictionaries[DICT_PRODUCT];
+    int count = 0;
+    for (int id = 0; id < productSketchCount && maxProducts > 0; id++) {
+        struct WaitQuantiles line;
+        waitSketchQuantiles(&productSketches[id], now, &line);
+        if (line.weight < 0.01) continue;
+        if (id < names->count) copyText(line.name, sizeof(line.name), names->names[id]);
+        else snprintf(line.name, sizeof(line.name), "#%d", id);
+
+        // Keep the busiest `maxProducts`, heaviest first
+        if (count < maxProducts) {
+            byProduct[count++] = line;
+        } else if (line.weight > byProduct[count - 1].weight) {
+            byProduct[count - 1] = line;
+        } else {
+            continue;
+        }
+        qsort(byProduct, (size_t)count, sizeof(*byProduct), compareWaitWeights);
+    }
+    return count;
+}
+
+/* ==================== AUTO-ESCALATION (24H CYCLES) ==================== */
+
+/*
+ * DESIGN DECISION: 24-hour escalation cycles
+ * 
+ * Why 24h instead of 48h/72h?
+ * - Faster response to aging tickets
+ * - Prevents tickets from languishing
+ * - Creates urgency for support team
+ * 
+ * Escalation timeline:
+ * Low: 0-24h Low, 24-48h Medium, 48h+ High
+ * Medium: 0-24h Medium, 24h+ High
+ * High: 0-24h High, 24h+ Critical
+ * Critical: Always Critical
+ */
+
+void escalateOldTickets() {
+    if (isEmpty()) return;
+    
+    uint64_t startNs = metricsNow();
+    time_t now = time(NULL);
+    int i = front;
+    int escalated = 0;
+    
+    while (1) {
+        double hours = difftime(now, queue[i].queueEntryTime) / 3600.0;
+        int oldPriority = queue[i].priority;
+        
+        // FIXED: Complete 24-hour escalation with 72h Critical safety net
+        // Rule: Every 24 hours, priority increases one step
+        // Low → (24h) → Medium → (24h) → High → (24h) → Critical
+        // Safety: ANY ticket ≥72h is forced to Critical
+        
+        if (queue[i].priority != PRIORITY_CRITICAL) {
+            // SAFETY NET: Force any ticket ≥72 hours to Critical
+            if (hours >= 72) {
+                queue[i].priority = PRIORITY_CRITICAL;
+                escalated++;
+            }
+            // Low priority escalation
+            else if (queue[i].priority == PRIORITY_LOW) {
+                if (hours >= 48) {
+                    queue[i].priority = PRIORITY_HIGH;
+                    escalated++;
+                } else if (hours >= 24) {
+                    queue[i].priority = PRIORITY_MEDIUM;
+                    escalated++;
+                }
+            }
+            // Medium priority escalation
+            else if (queue[i].priority == PRIORITY_MEDIUM) {
+                if (hours >= 24) {
+                    queue[i].priority = PRIORITY_HIGH;
+                    escalated++;
+                }
+            }
+            // High priority escalation - FIXED: High → Critical after 24h
+            else if (queue[i].priority == PRIORITY_HIGH) {
+                if (hours >= 24) {
+                    queue[i].priority = PRIORITY_CRITICAL;
+                    escalated++;
+                }
+            }
+        }
+        
+        if (oldPriority != queue[i].priority) {
+            countPriority(oldPriority, -1);
+            countPriority(queue[i].priority, 1);
+        }
+        
+        if (i == rear) break;
+        i = (i + 1) % MAX;
+    }
+    
+    if (escalated > 0) {
+        queueVersion++;
+        markDashboardDirty();
+        logEvent(LOG_ESCALATION, "Auto-escalated %d tickets", escalated);
+    }
+    recordStageLatency(STAGE_ESCALATE, startNs);
+}
+
+/* ==================== CSV FILE OPERATIONS ==================== */
+
+/*
+ * SIMPLIFIED CSV STRUCTURE (removed unnecessary columns):
+ * Old: 11 fields (including status, responseTime, resolveTime)
+ * New: 8 fields (essential only)
+ * Benefits: Cleaner data, fixes #### in Excel, easier to maintain
+ */
+
+// Formats one active-database row; returns its length (truncated to size - 1)
+int formatTicketRecord(char *buf, size_t size, const struct Ticket *t) {
+    // CSV with simplified structure
+    int len = snprintf(buf, size, "%d,\"%s\",\"%s\",\"%s\",\"%s\",\"%s\",%s,%ld\n",
+        t->ticketID, t->customerName, t->email,
+        t->product, t->purchaseDate,
+        t->issueDescription, t->priority, (long)t->queueEntryTime);
+    if (len < 0) return 0;
+    return len < (int)size ? len : (int)size - 1;
+}
+
+// Defined with ticket resolution below
+extern int databaseOverflowRows;
+extern long databaseOverflowOffset;
+extern struct IndexTable overflowRemovals;
+void loadRemovalLog(struct IndexTable *removed);
+void releaseOverflowState();
+
+/*
+ * Parses one active-database row (newline stripped) into `t` and
+ * validates it. Problems are logged against `lineNumber`; 0 means the
+ * row was reported before, so bad data is not logged again. Returns 1
+ * for a ticket to queue, 0 for a malformed or invalid row, -1 if memory
+ * ran out.
+ */
+int parseTicketRow(char *line, int lineNumber, struct Ticket *t) {
+    // Simple CSV parser that handles quoted fields
+    char *fields[8];
+    int fieldIndex = 0;
+    char *ptr = line;
+    char fieldBuffer[TICKET_RECORD_MAX];
+    int bufferIndex = 0;
+    int inQuotes = 0;
+
+    while (*ptr && fieldIndex < 8) {
+        if (*ptr == '"') {
+            inQuotes = !inQuotes;
+            ptr++;
+            continue;
+        }
+        
+        if (*ptr == ',' && !inQuotes) {
+            fieldBuffer[bufferIndex] = '\0';
+            fields[fieldIndex] = strdup(fieldBuffer);
+            
+            // ENHANCEMENT: NULL check for strdup
+            if (!fields[fieldIndex]) {
+                char errMsg[256];
+                snprintf(errMsg, sizeof(errMsg), 
+                         "Memory allocation failed at line %d - skipping", lineNumber);
+                logError(errMsg);
+                
+                // Free previously allocated fields
+                for (int j = 0; j < fieldIndex; j++) {
+                    if (fields[j]) free(fields[j]);
+                }
+                return -1;
+            }
+            
+            fieldIndex++;
+            bufferIndex = 0;
+            ptr++;
+            continue;
+        }
+        
+        if (bufferIndex < (int)sizeof(fieldBuffer) - 1) fieldBuffer[bufferIndex++] = *ptr;
+        ptr++;
+    }
+    
+    // Last field
+    fieldBuffer[bufferIndex] = '\0';
+    fields[fieldIndex] = strdup(fieldBuffer);
+    
+    // ENHANCEMENT: NULL check for last field
+    if (!fields[fieldIndex]) {
+        char errMsg[256];
+        snprintf(errMsg, sizeof(errMsg), 
+                 "Memory allocation failed at line %d - skipping", lineNumber);
+        logError(errMsg);
+        
+        for (int j = 0; j < fieldIndex; j++) {
+            if (fields[j]) free(fields[j]);
+        }
+        return -1;
+    }
+    
+    fieldIndex++;
+
+    // ENHANCEMENT: Better error message for malformed lines
+    if (fieldIndex < 8) {
+        char errMsg[256];
+        snprintf(errMsg, sizeof(errMsg), 
+                 "Line %d: Malformed CSV - %d fields (expected 8) - skipping", 
+                 lineNumber, fieldIndex);
+        if (lineNumber > 0) logError(errMsg);
+        
+        // Free any allocated fields and skip malformed line
+        for (int i = 0; i < fieldIndex; i++) {
+            if (fields[i]) free(fields[i]);
+        }
+        return 0;
+    }
+
+    // Parse fields
+    t->ticketID = atoi(fields[0]);
+    copyText(t->customerName, sizeof(t->customerName), fields[1]);
+    copyText(t->email, sizeof(t->email), fields[2]);
+    copyText(t->product, sizeof(t->product), fields[3]);
+    copyText(t->purchaseDate, sizeof(t->purchaseDate), fields[4]);
+    copyText(t->issueDescription, sizeof(t->issueDescription), fields[5]);
+    copyText(t->priority, sizeof(t->priority), fields[6]);
+    
+    if (strlen(fields[7]) > 0) {
+        t->queueEntryTime = (time_t)atol(fields[7]);
+    } else {
+        t->queueEntryTime = time(NULL);
+    }
+
+    // ENHANCEMENT: Validate parsed ticket data
+    int validationFailed = 0;
+    char validationMsg[256];
+    
+    if (!isValidTicketID(t->ticketID)) {
+        snprintf(validationMsg, sizeof(validationMsg), 
+                 "Line %d: Invalid ticket ID %d - skipping", lineNumber, t->ticketID);
+        if (lineNumber > 0) logError(validationMsg);
+        validationFailed = 1;
+    }
+    
+    if (!validationFailed && !isValidEmail(t->email)) {
+        snprintf(validationMsg, sizeof(validationMsg), 
+                 "Line %d: Invalid email '%s' for ticket #%d - skipping", 
+                 lineNumber, t->email, t->ticketID);
+        if (lineNumber > 0) logError(validationMsg);
+        validationFailed = 1;
+    }
+    
+    if (!validationFailed && !isValidString(t->customerName, 2, MAX_CUSTOMER_NAME_LEN)) {
+        snprintf(validationMsg, sizeof(validationMsg), 
+                 "Line %d: Invalid customer name for ticket #%d - skipping", 
+                 lineNumber, t->ticketID);
+        if (lineNumber > 0) logError(validationMsg);
+        validationFailed = 1;
+    }
+    
+    if (!validationFailed && !isValidPriority(t->priority)) {
+        // Auto-correct invalid priority instead of failing
+        snprintf(validationMsg, sizeof(validationMsg), 
+                 "Line %d: Invalid priority '%s' for ticket #%d - defaulting to Low", 
+                 lineNumber, t->priority, t->ticketID);
+        if (lineNumber > 0) logError(validationMsg);
+        strcpy(t->priority, "Low");
+    }
+
+    for (int i = 0; i < fieldIndex; i++) {
+        if (fields[i]) free(fields[i]);
+    }
+    return validationFailed ? 0 : 1;
+}
+
+void loadFromFile() {
+    FILE *f = fopen("customer_support_tickets_updated.csv", "r");
+    if (!f) {
+        f = fopen("customer_support_tickets_updated.csv", "w");
+        if (!f) {
+            logError("Cannot create customer_support_tickets_updated.csv");
+            return;
+        }
+        fprintf(f, "Ticket ID,Customer Name,Customer Email,Product,Purchase Date,Issue Description,Priority,Queue Entry Time\n");
+        fclose(f);
+        return;
+    }
+
+    uint64_t startNs = metricsNow();
+    char line[TICKET_RECORD_MAX];
+    fgets(line, sizeof(line), f); // Skip header
+    long offset = (long)strlen(line);   // Byte offset of the next line (cold-field rows)
+
+    resetQueue();
+    databaseOverflowRows = 0;
+
+    // Resolved since the last rewrite: still in the CSV, no longer active
+    indexClear(&overflowRemovals);
+    loadRemovalLog(&overflowRemovals);
+
+    int lineNumber = 1;  // Track line numbers for error reporting
+    int validTickets = 0;
+    int invalidTickets = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        lineNumber++;
+        struct Ticket t;
+        long lineStart = offset;
+        offset += (long)strlen(line);
+        removeNewline(line);
+
+        int parsed = parseTicketRow(line, lineNumber, &t);
+        if (parsed < 0) continue;
+
+        if (parsed == 0) {
+            invalidTickets++;
+        } else if (indexFind(&overflowRemovals, (unsigned long long)t.ticketID, t.ticketID)) {
+            // Resolved; the row goes at the next rewrite
+        } else if (databaseOverflowRows == 0 && enqueueTicket(&t, coldFieldMode ? lineStart : -1)) {
+            validTickets++;
+        } else {
+            // Queue full: this row and the rest wait for loadOverflowRows()
+            if (databaseOverflowRows++ == 0) databaseOverflowOffset = lineStart;
+        }
+    }
+    
+    fclose(f);
+    if (databaseOverflowRows == 0) releaseOverflowState();   // Kept for loadOverflowRows() otherwise
+    if (coldFieldMode) refreshDatabaseMap();
+    
+    // Priority changes not yet folded into the CSV
+    applyPriorityLog();
+    markDashboardDirty();
+    
+    // Log loading summary
+    if (invalidTickets > 0) {
+        char summaryMsg[256];
+        snprintf(summaryMsg, sizeof(summaryMsg), 
+                 "CSV Load Summary: %d valid tickets loaded, %d invalid tickets skipped", 
+                 validTickets, invalidTickets);
+        logError(summaryMsg);
+        printf("⚠️  Warning: %d invalid tickets skipped (check error_log.txt)\n", invalidTickets);
+    }
+    recordStageLatency(STAGE_LOAD, startNs);
+}
+
+/* ==================== ADMIN DASHBOARD GENERATION ==================== */
+
+// Set by mutations; the event loop regenerates the dashboard once per wake
+int dashboardDirty = 1;
+
+void markDashboardDirty() {
+    dashboardDirty = 1;
+}
+
+/*
+ * DESIGN DECISION: Render from an immutable queue view
+ * A QueueView is a copy of the queue in FIFO order plus the per-row
+ * customer history, taken by the thread that owns the queue. Rendering
+ * only reads the view, so it can run on another thread (see ENGINE
+ * THREADS) while the owner keeps ingesting and resolving. Views are
+ * reference counted and freed by whoever drops the last reference.
+ * The rows' text is read from the view's own copy of the text arena.
+ */
+
+struct DashboardRow {
+    struct QueuedTicket t;
+    int historyCount;
+    time_t lastResolved;
+};
+
+struct QueueView {
+    int refs;
+    unsigned long version;      // queueVersion when taken
+    int count;
+    int priorities[4];          // Critical, High, Medium, Low
+    long long entryTimeSum;     // queuedEntryTimeSum when taken
+    struct WaitQuantiles waitByPriority[4];
+    struct WaitQuantiles waitByProduct[DASHBOARD_PRODUCT_WAITS];
+    int productWaits;
+    const char *text;           // Copy of the text arena (after the rows)
+    struct DatabaseMap *map;    // Cold rows' database mapping, or NULL
+    struct DashboardRow rows[];
+};
+
+// Copies the queue (owner thread only); the caller holds the one reference
+struct QueueView *buildQueueView() {
+    int count = isEmpty() ? 0 : queuePosition(rear);
+    size_t rowsSize = (size_t)count * sizeof(struct DashboardRow);
+    struct QueueView *v = malloc(sizeof(struct QueueView) + rowsSize + textArenaSize);
+    if (!v) return NULL;
+
+    v->refs = 1;
+    v->version = queueVersion;
+    v->count = count;
+    memcpy(v->priorities, priorityCounts, sizeof(priorityCounts));
+    v->entryTimeSum = queuedEntryTimeSum;
+    v->productWaits = getWaitQuantiles(v->waitByPriority, v->waitByProduct, DASHBOARD_PRODUCT_WAITS);
+    char *text = (char *)v->rows + rowsSize;
+    if (textArenaSize > 0) memcpy(text, textArena, textArenaSize);
+    v->text = text;
+    v->map = holdColdRows();
+    for (int n = 0, i = front; n < count; n++, i = (i + 1) % MAX) {
+        v->rows[n].t = queue[i];
+        v->rows[n].lastResolved = 0;
+        v->rows[n].historyCount = lookupCustomerHistory(ticketText(&queue[i], FIELD_EMAIL),
+                                                        &v->rows[n].lastResolved);
+    }
+    return v;
+}
+
+void retainQueueView(struct QueueView *v) {
+    __atomic_fetch_add(&v->refs, 1, __ATOMIC_RELAXED);
+}
+
+void releaseQueueView(struct QueueView *v) {
+    if (v && __atomic_sub_fetch(&v->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        releaseDatabaseMap(v->map);
+        free(v);
+    }
+}
+
+// Same figures as getQueueStats(), from a view
+void getViewStats(const struct QueueView *v, time_t now, double *avgWaitHours, int *oldestHours) {
+    *avgWaitHours = 0.0;
+    *oldestHours = 0;
+    if (v->count == 0) return;
+    *avgWaitHours = ((double)now - (double)v->entryTimeSum / v->count) / 3600.0;
+    double oldest = difftime(now, v->rows[0].t.queueEntryTime) / 3600.0;
+    if (oldest > 0) *oldestHours = (int)oldest;
+}
+
+// "p50 / p90 / p99" in hours, or "-" before the first resolve
+void formatWaitQuantiles(const struct WaitQuantiles *w, char *buf, size_t size) {
+    if (w->weight < 0.01) snprintf(buf, size, "-");
+    else snprintf(buf, size, "%.1f / %.1f / %.1fh", w->p50 / 3600.0, w->p90 / 3600.0, w->p99 / 3600.0);
+}
+
+// One line of per-priority resolve wait quantiles, for the status output
+void printWaitSummary(const struct WaitQuantiles byPriority[4]) {
+    printf("[Status] Resolve wait p50/p90/p99:");
+    for (int p = 0; p < 4; p++) {
+        char buf[64];
+        formatWaitQuantiles(&byPriority[p], buf, sizeof(buf));
+        printf(" %s %s%s", byPriority[p].name, buf, p < 3 ? " |" : "\n");
+    }
+}
+
+void renderDashboard(const struct QueueView *v) {
+    uint64_t startNs = metricsNow();
+
+    // Write to temporary file first to prevent race conditions
+    FILE *file = fopen("templates/admin_view.html.tmp", "w"); 
+    if (!file) {
+        logError("Cannot create admin_view.html.tmp");
+        return;
+    }
+
+    // Get queue statistics
+    time_t now = time(NULL);
+    int total = v->count, oldestHours = 0;
+    double avgWait = 0.0;
+    const int *priorities = v->priorities;
+    getViewStats(v, now, &avgWait, &oldestHours);
+
+    fprintf(file, "<!DOCTYPE html><html><head><title>Admin Dashboard</title>");
+    fprintf(file, "<meta charset='UTF-8'>");
+    fprintf(file, "<style>");
+    fprintf(file, "body { font-family: 'Segoe UI', sans-serif; background: #f4f6f9; padding: 20px; margin: 0; }");
+    
+    fprintf(file, ".resolve-btn-top { position: sticky; top: 0; z-index: 1000; background: #27ae60; color: white; padding: 15px; text-align: center; margin: -20px -20px 20px -20px; box-shadow: 0 2px 10px rgba(0,0,0,0.2); }");
+    fprintf(file, ".resolve-btn-top a { color: white; text-decoration: none; font-size: 16px; font-weight: bold; }");
+    fprintf(file, ".resolve-btn-top a:hover { text-decoration: underline; }");
+    
+    // Stats card styling
+    fprintf(file, ".stats-container { display: grid; grid-template-columns: repeat(auto-fit, minmax(200px, 1fr)); gap: 15px; margin-bottom: 25px; }");
+    fprintf(file, ".stat-card { background: white; padding: 20px; border-radius: 8px; box-shadow: 0 2px 4px rgba(0,0,0,0.1); }");
+    fprintf(file, ".stat-card h3 { margin: 0 0 5px 0; font-size: 14px; color: #7f8c8d; text-transform: uppercase; }");
+    fprintf(file, ".stat-card .value { font-size: 32px; font-weight: bold; color: #2c3e50; }");
+    fprintf(file, ".stat-card .subtext { font-size: 12px; color: #95a5a6; margin-top: 5px; }");
+    fprintf(file, ".stat-card.critical { border-left: 4px solid #e74c3c; }");
+    fprintf(file, ".stat-card.warning { border-left: 4px solid #f39c12; }");
+    fprintf(file, ".stat-card.info { border-left: 4px solid #3498db; }");
+    fprintf(file, ".stat-card.success { border-left: 4px solid #27ae60; }");
+    
+    fprintf(file, "table { width: 100%%; border-collapse: collapse; background: white; box-shadow: 0 4px 8px rgba(0,0,0,0.1); border-radius: 8px; overflow: hidden; }");
+    fprintf(file, "th, td { padding: 15px; text-align: left; border-bottom: 1px solid #ddd; vertical-align: middle; }");
+    fprintf(file, "th { background-color: #2c3e50; color: white; text-transform: uppercase; font-size: 13px; letter-spacing: 0.5px; }");
+    fprintf(file, "tr:hover { background-color: #f8f9fa; }");
+    
+    // Age-based row highlighting
+    fprintf(file, ".age-critical { background-color: #fadbd8 !important; }");
+    fprintf(file, ".age-warning { background-color: #fdebd0 !important; }");
+    fprintf(file, ".age-caution { background-color: #fff9e6 !important; }");
+    
+    fprintf(file, ".Critical { color: #c0392b; font-weight: bold; background: #fadbd8; padding: 4px 8px; border-radius: 4px; font-size: 12px; }");
+    fprintf(file, ".High { color: #e67e22; font-weight: bold; background: #fdebd0; padding: 4px 8px; border-radius: 4px; font-size: 12px; }");
+    fprintf(file, ".Medium { color: #2980b9; background: #d6eaf8; padding: 4px 8px; border-radius: 4px; font-size: 12px; }");
+    fprintf(file, ".Low { color: #27ae60; background: #d5f5e3; padding: 4px 8px; border-radius: 4px; font-size: 12px; }");
+    fprintf(file, ".logout-btn { float: right; background: #e74c3c; color: white; padding: 10px 20px; text-decoration: none; border-radius: 30px; font-weight: bold; font-size: 14px; box-shadow: 0 2px 5px rgba(231, 76, 60, 0.3); }");
+    fprintf(file, ".logout-btn:hover { background: #c0392b; transform: translateY(-2px); }");
+    fprintf(file, ".subtext { display: block; font-size: 12px; color: #7f8c8d; margin-top: 4px; }");
+    fprintf(file, ".age-badge { font-size: 11px; padding: 3px 6px; border-radius: 3px; font-weight: 600; }");
+    fprintf(file, ".age-critical-badge { background: #e74c3c; color: white; }");
+    fprintf(file, ".age-warning-badge { background: #f39c12; color: white; }");
+    fprintf(file, ".age-caution-badge { background: #f1c40f; color: #333; }");
+    fprintf(file, ".history-tooltip { font-size: 11px; color: #3498db; margin-left: 8px; cursor: help; }");
+    fprintf(file, ".priority-select { padding: 5px 8px; border: 1px solid #ddd; border-radius: 4px; background: white; font-size: 12px; cursor: pointer; font-weight: 600; }");
+    fprintf(file, ".priority-select:hover { border-color: #3498db; }");
+    fprintf(file, ".priority-Critical { background: #fadbd8; color: #c0392b; border-color: #c0392b; }");
+    fprintf(file, ".priority-High { background: #fdebd0; color: #e67e22; border-color: #e67e22; }");
+    fprintf(file, ".priority-Medium { background: #d6eaf8; color: #2980b9; border-color: #2980b9; }");
+    fprintf(file, ".priority-Low { background: #d5f5e3; color: #27ae60; border-color: #27ae60; }");
+    fprintf(file, ".bulk-resolve { background: white; padding: 12px 15px; border-radius: 8px; margin-bottom: 20px; box-shadow: 0 2px 5px rgba(0,0,0,0.05); font-size: 13px; }");
+    fprintf(file, ".bulk-resolve input, .bulk-resolve select { padding: 5px; margin: 0 6px 0 2px; border: 1px solid #ccc; border-radius: 4px; }");
+    fprintf(file, ".bulk-resolve button { padding: 5px 10px; margin-right: 14px; background: #27ae60; color: white; border: none; border-radius: 4px; cursor: pointer; }");
+    fprintf(file, ".flash { padding: 10px 15px; border-radius: 6px; margin-bottom: 15px; background: #d5f5e3; color: #1e8449; }");
+    fprintf(file, "</style>");
+    fprintf(file, "</head><body>");
+    
+    if (v->count > 0) {
+        fprintf(file, "<div class='resolve-btn-top'>");
+        fprintf(file, "<a href='/resolve/%d'>⚡ Resolve Next Ticket (FIFO) - #%d ✅</a>", v->rows[0].t.ticketID, v->rows[0].t.ticketID);
+        fprintf(file, "</div>");
+    }
+    
+    fprintf(file, "<div style='overflow: hidden; margin-bottom: 20px;'>");
+    fprintf(file, "<a href='/' class='logout-btn'>Logout</a>");
+    fprintf(file, "<h2 style='color: #2c3e50; margin: 0;'>🚀 Live Support Dashboard</h2>");
+    fprintf(file, "<p style='color: #7f8c8d; margin: 5px 0 0 0;'>Real-time ticket monitoring system (FIFO Circular Queue)</p>");
+    fprintf(file, "</div>");
+
+    // Statistics Dashboard
+    fprintf(file, "<div class='stats-container'>");
+    
+    // Total Tickets
+    fprintf(file, "<div class='stat-card info'>");
+    fprintf(file, "<h3>📊 Total in Queue</h3>");
+    fprintf(file, "<div class='value'>%d</div>", total);
+    fprintf(file, "<div class='subtext'>Capacity: %d/%d (%.1f%%)</div>", total, MAX, (total * 100.0) / MAX);
+    fprintf(file, "</div>");
+    
+    // Average Wait Time
+    char waitClass[20] = "success";
+    if (avgWait > 48) strcpy(waitClass, "critical");
+    else if (avgWait > 24) strcpy(waitClass, "warning");
+    fprintf(file, "<div class='stat-card %s'>", waitClass);
+    fprintf(file, "<h3>⏱️ Avg Wait Time</h3>");
+    fprintf(file, "<div class='value'>%.1fh</div>", avgWait);
+    fprintf(file, "<div class='subtext'>Average across all tickets</div>");
+    fprintf(file, "</div>");
+    
+    // Oldest Ticket
+    char oldestClass[20] = "success";
+    if (oldestHours > 72) strcpy(oldestClass, "critical");
+    else if (oldestHours > 48) strcpy(oldestClass, "warning");
+    fprintf(file, "<div class='stat-card %s'>", oldestClass);
+    fprintf(file, "<h3>⚠️ Oldest Ticket</h3>");
+    fprintf(file, "<div class='value'>%dh</div>", oldestHours);
+    fprintf(file, "<div class='subtext'>Waiting time of longest ticket</div>");
+    fprintf(file, "</div>");
+    
+    // Priority Breakdown
+    fprintf(file, "<div class='stat-card info'>");
+    fprintf(file, "<h3>🎯 Priority Distribution</h3>");
+    fprintf(file, "<div style='font-size: 14px; margin-top: 10px;'>");
+    fprintf(file, "<span class='Critical' style='margin-right: 8px;'>Critical: %d</span>", priorities[0]);
+    fprintf(file, "<span class='High' style='margin-right: 8px;'>High: %d</span>", priorities[1]);
+    fprintf(file, "<br><span class='Medium' style='margin-right: 8px; margin-top: 5px; display: inline-block;'>Medium: %d</span>", priorities[2]);
+    fprintf(file, "<span class='Low'>Low: %d</span>", priorities[3]);
+    fprintf(file, "</div></div>");
+    
+    // Resolve wait quantiles (decayed sketches, see WAIT TIME SKETCHES)
+    fprintf(file, "<div class='stat-card info'>");
+    fprintf(file, "<h3>📈 Resolve Wait p50 / p90 / p99</h3>");
+    fprintf(file, "<div style='font-size: 13px; margin-top: 10px; line-height: 1.9;'>");
+    for (int p = 0; p < 4; p++) {
+        char buf[64];
+        formatWaitQuantiles(&v->waitByPriority[p], buf, sizeof(buf));
+        fprintf(file, "<span class='%s'>%s</span> %s<br>", priorityNames[p], priorityNames[p], buf);
+    }
+    fprintf(file, "</div><div class='subtext'>Recent resolves, half-life %dh</div>", WAIT_SKETCH_HALF_LIFE_HOURS);
+    fprintf(file, "</div>");
+    
+    if (v->productWaits > 0) {
+        fprintf(file, "<div class='stat-card info'>");
+        fprintf(file, "<h3>📦 Resolve Wait by Product</h3>");
+        fprintf(file, "<div style='font-size: 13px; margin-top: 10px; line-height: 1.6;'>");
+        for (int i = 0; i < v->productWaits; i++) {
+            char buf[64];
+            formatWaitQuantiles(&v->waitByProduct[i], buf, sizeof(buf));
+            fprintf(file, "<strong>%s</strong> %s<br>", v->waitByProduct[i].name, buf);
+        }
+        fprintf(file, "</div><div class='subtext'>p50 / p90 / p99, busiest products</div>");
+        fprintf(file, "</div>");
+    }
+    
+    fprintf(file, "</div>"); // End stats-container
+
+    // Bulk resolve (Flask renders this file as a template: flashed results go here)
+    fprintf(file, "{%% for message in get_flashed_messages() %%}<div class='flash'>{{ message }}</div>{%% endfor %%}");
+    fprintf(file, "<form class='bulk-resolve' method='post' action='/resolve_bulk'>");
+    fprintf(file, "<strong>Bulk resolve:</strong> ");
+    fprintf(file, "IDs <input name='ids' size='18' placeholder='1001, 1002, ...'>");
+    fprintf(file, "<button name='mode' value='ids'>Resolve IDs</button>");
+    fprintf(file, "Priority <select name='priority'><option value='*'>Any</option><option>Critical</option><option>High</option><option>Medium</option><option>Low</option></select>");
+    fprintf(file, "Product <input name='product' size='12' placeholder='Any'>");
+    fprintf(file, "Older than <input name='min_age_hours' size='3' placeholder='0'>h");
+    fprintf(file, "<button name='mode' value='matching' onclick=\"return confirm('Resolve every matching ticket?')\">Resolve matching</button>");
+    fprintf(file, "First <input name='count' size='4' placeholder='N'>");
+    fprintf(file, "<button name='mode' value='first'>Resolve first N</button>");
+    fprintf(file, "</form>");
+
+    fprintf(file, "<table>");
+    fprintf(file, "<tr><th width='5%%'>ID</th><th width='20%%'>Customer Details</th><th width='20%%'>Product Info</th><th width='25%%'>Issue Description</th><th width='12%%'>Priority</th><th width='10%%'>Wait Time</th><th width='8%%'>History</th></tr>");
+
+    if (v->count > 0) {
+        struct Ticket text;
+        for (int n = 0; n < v->count; n++) {
+            const struct QueuedTicket *t = &v->rows[n].t;
+            expandTicketFrom(v->text, v->map, t, &text);
+            const char *priority = priorityNames[t->priority];
+            double hours = difftime(now, t->queueEntryTime) / 3600.0;
+            
+            // Determine row class based on age
+            char rowClass[50] = "";
+            if (hours > 72) strcpy(rowClass, "class='age-critical'");
+            else if (hours > 48) strcpy(rowClass, "class='age-warning'");
+            else if (hours > 24) strcpy(rowClass, "class='age-caution'");
+            
+            fprintf(file, "<tr %s>", rowClass);
+            fprintf(file, "<td><strong>#%d</strong></td>", t->ticketID);
+            
+            fprintf(file, "<td><span style='font-weight:600; color:#2c3e50;'>%s</span><span class='subtext'>✉️ %s</span></td>", 
+                    text.customerName, text.email);
+
+            fprintf(file, "<td><span style='font-weight:600; color:#2c3e50;'>%s</span><span class='subtext'>📅 %s</span></td>", 
+                    text.product, text.purchaseDate);
+
+            fprintf(file, "<td>%s</td>", text.issueDescription);
+            
+            // Priority dropdown for editing with color coding
+            fprintf(file, "<td>");
+            fprintf(file, "<select class='priority-select priority-%s' onchange='updatePriority(%d, this.value)'>", 
+                    priority, t->ticketID);
+            fprintf(file, "<option value='Low' %s>Low</option>", strcmp(priority, "Low") == 0 ? "selected" : "");
+            fprintf(file, "<option value='Medium' %s>Medium</option>", strcmp(priority, "Medium") == 0 ? "selected" : "");
+            fprintf(file, "<option value='High' %s>High</option>", strcmp(priority, "High") == 0 ? "selected" : "");
+            fprintf(file, "<option value='Critical' %s>Critical</option>", strcmp(priority, "Critical") == 0 ? "selected" : "");
+            fprintf(file, "</select>");
+            fprintf(file, "</td>");
+            
+            // Wait time with badges
+            char ageBadgeClass[50] = "";
+            if (hours > 72) strcpy(ageBadgeClass, "age-critical-badge");
+            else if (hours > 48) strcpy(ageBadgeClass, "age-warning-badge");
+            else if (hours > 24) strcpy(ageBadgeClass, "age-caution-badge");
+            
+            if (strlen(ageBadgeClass) > 0) {
+                fprintf(file, "<td><span class='age-badge %s'>%.1fh</span></td>", ageBadgeClass, hours);
+            } else {
+                fprintf(file, "<td>%.1fh</td>", hours);
+            }
+            
+            // Customer history count (looked up when the view was taken)
+            int historyCount = v->rows[n].historyCount;
+            time_t lastResolved = v->rows[n].lastResolved;
+            if (historyCount > 0) {
+                char lastBuf[20] = "";
+                if (lastResolved > 0) {
+                    struct tm tmBuf;
+#ifdef _WIN32
+                    tmBuf = *localtime(&lastResolved);
+#else
+                    localtime_r(&lastResolved, &tmBuf);
+#endif
+                    strftime(lastBuf, sizeof(lastBuf), "%Y-%m-%d", &tmBuf);
+                }
+                fprintf(file, "<td><span class='history-tooltip' title='%d previous tickets, last resolved %s'>📋 %d</span></td>", 
+                        historyCount, lastBuf, historyCount);
+            } else {
+                fprintf(file, "<td style='color: #bdc3c7;'>-</td>");
+            }
+            
+            fprintf(file, "</tr>");
+        }
+    } else {
+        fprintf(file, "<tr><td colspan='7' style='text-align:center; padding: 40px; color: #95a5a6;'><h3>No Pending Tickets! 🎉</h3><p>Good job team, all caught up.</p></td></tr>");
+    }
+
+    fprintf(file, "</table>");
+
+    fprintf(file, "<div style='text-align:center; margin-top:20px; color:#bdc3c7; font-size:12px;'>");
+    fprintf(file, "System Auto-Refreshes every 15s | Auto-escalation: Low→Medium (24h), Medium→High (24h), High→Critical (24h)");
+    fprintf(file, "</div>");
+    // JavaScript for priority update
+    fprintf(file, "<script>");
+    fprintf(file, "function updatePriority(ticketId, newPriority) {");
+    fprintf(file, "  fetch('/update_priority/' + ticketId + '/' + newPriority, { method: 'POST' })");
+    fprintf(file, "    .then(res => res.json())");
+    fprintf(file, "    .then(data => {");
+    fprintf(file, "      if (data.success) {");
+    fprintf(file, "        alert('Priority updated to ' + newPriority);");
+    fprintf(file, "        location.reload();");
+    fprintf(file, "      } else {");
+    fprintf(file, "        alert('Error: ' + data.error);");
+    fprintf(file, "      }");
+    fprintf(file, "    });");
+    fprintf(file, "}");
+    
+    fprintf(file, "var isRefreshing = false;");
+    fprintf(file, "var hasClickedResolve = false;");
+    
+    fprintf(file, "document.addEventListener('DOMContentLoaded', function() {");
+    fprintf(file, "  var resolveLinks = document.querySelectorAll('a[href*=\"/resolve/\"]');");
+    fprintf(file, "  resolveLinks.forEach(function(link) {");
+    fprintf(file, "    link.addEventListener('click', function(e) {");
+    fprintf(file, "      if (hasClickedResolve) {");
+    fprintf(file, "        e.preventDefault();");
+    fprintf(file, "        return false;");
+    fprintf(file, "      }");
+    fprintf(file, "      hasClickedResolve = true;");
+    fprintf(file, "    });");
+    fprintf(file, "  });");
+    fprintf(file, "});");
+    
+    fprintf(file, "setTimeout(function() {");
+    fprintf(file, "  var editing = document.activeElement && document.activeElement.closest('.bulk-resolve');");
+    fprintf(file, "  if (!isRefreshing && !hasClickedResolve && !editing) {");
+    fprintf(file, "    isRefreshing = true;");
+    fprintf(file, "    location.reload();");
+    fprintf(file, "  }");
+    fprintf(file, "}, 5000);");
+    
+    fprintf(file, "</script>");
+    fprintf(file, "</body></html>");
+    fclose(file);
+    
+    // Atomic rename - prevents race conditions with Flask reading file
+    remove("templates/admin_view.html");
+    rename("templates/admin_view.html.tmp", "templates/admin_view.html");
+    recordStageLatency(STAGE_DASHBOARD, startNs);
+}
+
+// Renders the current queue on the calling (owner) thread
+void generateAdminHTML() {
+    struct QueueView *v = buildQueueView();
+    if (!v) {
+        logError("Out of memory building dashboard view");
+        return;
+    }
+    renderDashboard(v);
+    releaseQueueView(v);
+    dashboardDirty = 0;
+}
+
+/* ==================== TICKET RESOLUTION ==================== */
+
+/*
+ * DESIGN DECISION: Append-only resolve
+ * Resolving used to copy every other row of the active database into
+ * temp.csv, rename it over the original, reload the queue from it and
+ * re-render the dashboard. The in-memory queue is authoritative now: a
+ * resolve appends the ticket as held in memory (logged priority changes
+ * included) to the archive, plus one "<id>,<time>" marker to
+ * REMOVAL_LOG_FILE. loadFromFile() skips the marked IDs until background
+ * compaction (see BACKGROUND COMPACTION) rewrites the active database.
+ */
+
+int removalLogRecords = 0;
+int databaseOverflowRows = 0;   // Rows in the active database that did not fit in the queue
+long databaseOverflowOffset = 0;   // Where the first of them starts
+struct IndexTable overflowRemovals = {NULL, 0, 0};   // Removal-log IDs while rows overflow
+
+// Collects the IDs marked as resolved since the last rewrite (for loadFromFile)
+void loadRemovalLog(struct IndexTable *removed) {
+    removalLogRecords = 0;
+    FILE *log = fopen(REMOVAL_LOG_FILE, "r");
+    if (!log) return;
+
+    char line[64];
+    while (fgets(line, sizeof(line), log)) {
+        int id = atoi(line);
+        if (id <= 0) continue;
+        indexPut(removed, (unsigned long long)id, id, 0);
+        removalLogRecords++;
+    }
+    fclose(log);
+}
+
+void releaseOverflowState() {
+    free(overflowRemovals.entries);
+    memset(&overflowRemovals, 0, sizeof(overflowRemovals));
+    databaseOverflowRows = 0;
+    databaseOverflowOffset = 0;
+}
+
+/*
+ * Queues overflow rows, starting at databaseOverflowOffset, until the
+ * queue is full again. Rows before that offset were loaded or skipped,
+ * and freed slots are refilled at once, so only the rows that fit are
+ * parsed, never the whole database. Rows from the offset on that are
+ * queued (written by the batch that overflowed) or resolved are skipped.
+ */
+void loadOverflowRows() {
+    FILE *f = fopen(PENDING_TICKETS_FILE, "r");
+    if (!f || fseek(f, databaseOverflowOffset, SEEK_SET) != 0) {
+        if (f) fclose(f);
+        loadFromFile();   // Fall back to a full reload
+        return;
+    }
+
+    char line[TICKET_RECORD_MAX];
+    long offset = databaseOverflowOffset;
+    int loaded = 0, atEnd = 1;
+    while (fgets(line, sizeof(line), f)) {
+        long lineStart = offset;
+        offset += (long)strlen(line);
+        removeNewline(line);
+
+        struct Ticket t;
+        if (parseTicketRow(line, 0, &t) != 1 ||
+            indexFind(&overflowRemovals, (unsigned long long)t.ticketID, t.ticketID) ||
+            findTicketSlot(t.ticketID) >= 0) {
+            continue;   // Invalid (reported by loadFromFile()), resolved, or written while queued
+        }
+        if (isFull() || !enqueueTicket(&t, coldFieldMode ? lineStart : -1)) {
+            offset = lineStart;
+            atEnd = 0;
+            break;
+        }
+        loaded++;
+        databaseOverflowRows--;
+    }
+    fclose(f);
+
+    if (atEnd || databaseOverflowRows <= 0) {
+        releaseOverflowState();
+    } else {
+        databaseOverflowOffset = offset;
+    }
+    if (loaded > 0) {
+        if (coldFieldMode) refreshDatabaseMap();
+        applyPriorityLog();
+        markDashboardDirty();
+    }
+}
+
+/*
+ * Appends `count` resolved tickets to the archive - one write however many
+ * there are - and fsyncs it. Only then are they indexed as resolved;
+ * callers take them out of the queue and log their removal (logRemovals())
+ * after a successful return. Returns 0, leaving nothing indexed, if the
+ * rows could not be made durable.
+ */
+int archiveTickets(const struct Ticket *tickets, int count, const char *admin_username) {
+    if (count <= 0) return 1;
+    uint64_t startNs = metricsNow();
+    time_t now = time(NULL);
+    int period;
+    FILE *arc = openArchivePartition(now, &period);
+    if (!arc) {
+        logError("Cannot open the archive partition for resolved tickets");
+        return 0;
+    }
+    long offset = ftell(arc);
+
+    char timeBuf[50];
+    getSystemTime(timeBuf);
+
+    size_t rowMax = TICKET_RECORD_MAX + sizeof(timeBuf) + strlen(admin_username) + 2;
+    char *rows = malloc((size_t)count * rowMax);
+    size_t *rowStart = malloc((size_t)count * sizeof(size_t));
+    if (!rows || !rowStart) {
+        logError("Memory allocation failed while archiving tickets");
+        free(rows);
+        free(rowStart);
+        fclose(arc);
+        return 0;
+    }
+
+    size_t rowsLen = 0;
+    for (int i = 0; i < count; i++) {
+        int len = formatTicketRecord(rows + rowsLen, TICKET_RECORD_MAX, &tickets[i]);
+        if (len > 0 && rows[rowsLen + len - 1] == '\n') len--;
+        len += snprintf(rows + rowsLen + len, rowMax - (size_t)len, ",%s,%s\n", timeBuf, admin_username);
+        rowStart[i] = rowsLen;
+        rowsLen += (size_t)len;
+    }
+    int written = fwrite(rows, 1, rowsLen, arc) == rowsLen;
+    if (!closeArchivePartition(arc) || !written) {
+        logError("Cannot write resolved tickets to the archive - they stay queued");
+#ifndef _WIN32
+        // Drop a torn row so the next append starts on a line of its own
+        char path[64];
+        archivePartitionPath(period, ".csv", path, sizeof(path));
+        if (truncate(path, offset) != 0) logError("Cannot trim a partial row from the archive");
+#endif
+        free(rows);
+        free(rowStart);
+        return 0;
+    }
+
+    struct ResolvedColumns cols;
+    memset(&cols, 0, sizeof(cols));
+    uint16_t adminID = dictionaryID(DICT_ADMIN, admin_username);
+    for (int i = 0; i < count; i++) {
+        const struct Ticket *t = &tickets[i];
+        indexResolvedTicket(t->ticketID, archiveLocation(period, offset + (long)rowStart[i]));
+
+        // Keep the customer history index in step with the archive
+        recordCustomerResolution(t->email, now);
+        uint16_t productID = dictionaryID(DICT_PRODUCT, t->product);
+        appendColumnRow(&cols, t->queueEntryTime, now, priorityRank(t->priority), productID, adminID);
+        recordResolvedWait(priorityRank(t->priority), productID, t->queueEntryTime, now);
+    }
+    countArchivedRows(findArchivePartition(period), now, count);
+    writeArchiveManifest();
+    if (cols.rows == (uint32_t)count) {
+        appendColumnChunk(period, &cols);
+    } else {
+        logError("Memory allocation failed while archiving ticket columns - rebuilt at next start");
+    }
+    freeColumns(&cols);
+    free(rows);
+    free(rowStart);
+    __atomic_fetch_add(&metricTicketsResolved, (uint64_t)count, __ATOMIC_RELAXED);
+    recordStageLatency(STAGE_ARCHIVE, startNs);
+    return 1;
+}
+
+/*
+ * Appends the removal markers of archived tickets that have left the queue
+ * (one write), then refills the queue from overflow rows.
+ */
+void logRemovals(const struct Ticket *tickets, int count) {
+    char *markers = malloc((size_t)count * 32);
+    FILE *log = markers ? fopen(REMOVAL_LOG_FILE, "a") : NULL;
+    if (log) {
+        size_t markersLen = 0;
+        time_t now = time(NULL);
+        for (int i = 0; i < count; i++) {
+            markersLen += (size_t)snprintf(markers + markersLen, 32, "%d,%ld\n", tickets[i].ticketID, (long)now);
+            if (databaseOverflowRows > 0) indexPut(&overflowRemovals, (unsigned long long)tickets[i].ticketID, tickets[i].ticketID, 0);
+        }
+        fwrite(markers, 1, markersLen, log);
+        fclose(log);
+        removalLogRecords += count;
+    } else {
+        // Fall back to a full rewrite so the removals are not lost
+        logError("Cannot append to removal log - rewriting database");
+        saveQueueToFile();
+    }
+    free(markers);
+
+    // Freed capacity: pull in rows that overflowed the queue earlier
+    if (databaseOverflowRows > 0) loadOverflowRows();
+}
+
+// Archives the ticket in `slot`, then removes it from the queue and the
+// active database. Returns 0, with the ticket still queued, if archiving failed.
+int archiveAndRemove(int slot, const char *admin_username) {
+    struct Ticket t;
+    copyQueuedTicket(slot, &t);
+    if (!archiveTickets(&t, 1, admin_username)) return 0;
+    removeTicketAt(slot, NULL);
+    logRemovals(&t, 1);
+    return 1;
+}
+
+void resolveNextTicket(const char *admin_username) {
+    if (isEmpty() || !archiveAndRemove(front, admin_username)) return;
+    markDashboardDirty();
+    refreshDashboard();
+}
+
+/*
+ * Resolves a specific ticket (not necessarily the front one).
+ * Marks the dashboard dirty; callers that acknowledge the resolve
+ * regenerate it first so the admin's next page load is current.
+ * TICKET_ERROR_FILE_OPEN means the archive write failed and it stays queued.
+ */
+int resolveTicketByID(int id, const char *admin_username) {
+    int slot = findTicketSlot(id);
+    if (slot < 0) return TICKET_ERROR_NOT_FOUND;
+    if (!archiveAndRemove(slot, admin_username)) return TICKET_ERROR_FILE_OPEN;
+    markDashboardDirty();
+    return SUCCESS;
+}
+
+/*
+ * DESIGN DECISION: Bulk resolve in one pass
+ * Clearing a spam wave used to be one RESOLVE per ticket. A bulk command
+ * first marks its tickets: index probes for an ID list, one queue scan
+ * for a predicate, the front N for RESOLVE_FIRST. One compaction pass
+ * then closes the gaps in FIFO order, shifting whichever side of the
+ * queue is shorter (so resolving the front N moves nothing), and
+ * archiveTickets() writes the whole set at once.
+ */
+
+struct ResolveFilter {
+    const char *priority;   // NULL = any
+    const char *product;    // NULL = any (case-insensitive)
+    long minAgeSeconds;     // 0 = any age
+};
+
+int ticketMatchesFilter(const struct QueuedTicket *t, const struct ResolveFilter *f, time_t now) {
+    if (f->priority && t->priority != priorityRank(f->priority)) return 0;
+    if (f->product && strcasecmp(ticketText(t, FIELD_PRODUCT), f->product) != 0) return 0;
+    if (f->minAgeSeconds > 0 && now - t->queueEntryTime < f->minAgeSeconds) return 0;
+    return 1;
+}
+
+/*
+ * Archives the tickets whose queue position (0 = front) is flagged in
+ * `marked`, then removes them. `first`/`last` bound the flagged positions.
+ * Returns the number resolved, or TICKET_ERROR_FILE_OPEN (nothing removed)
+ * if the archive write failed.
+ */
+int resolveMarkedPositions(const unsigned char *marked, int first, int last, int count,
+                           const char *admin_username) {
+    if (count <= 0) return 0;
+    struct Ticket *resolved = malloc((size_t)count * sizeof(struct Ticket));
+    if (!resolved) {
+        logError("Memory allocation failed for bulk resolve");
+        return 0;
+    }
+
+    int n = 0;
+    for (int p = first; p <= last; p++) {
+        if (marked[p]) copyQueuedTicket((front + p) % MAX, &resolved[n++]);
+    }
+    if (!archiveTickets(resolved, count, admin_username)) {
+        free(resolved);
+        return TICKET_ERROR_FILE_OPEN;
+    }
+    removeMarkedPositions(marked + first, first, last, count, NULL);
+
+    for (int i = 0; i < count; i++) traceCommand(TRACE_RESOLVE, resolved[i].ticketID, NULL, admin_username);
+    logRemovals(resolved, count);
+    free(resolved);
+    markDashboardDirty();
+    return count;
+}
+
+// Resolves every queued ticket in `ids` (unknown IDs are skipped); returns the count
+int resolveTicketList(const int *ids, int idCount, const char *admin_username) {
+    if (isEmpty() || idCount <= 0) return 0;
+    int size = (rear - front + MAX) % MAX + 1;
+    unsigned char *marked = calloc((size_t)size, 1);
+    if (!marked) return 0;
+
+    int count = 0, first = size, last = -1;
+    for (int i = 0; i < idCount; i++) {
+        int slot = findTicketSlot(ids[i]);
+        if (slot < 0) continue;
+        int p = (slot - front + MAX) % MAX;
+        if (marked[p]) continue;   // Listed twice
+        marked[p] = 1;
+        count++;
+        if (p < first) first = p;
+        if (p > last) last = p;
+    }
+    int resolved = resolveMarkedPositions(marked, first, last, count, admin_username);
+    free(marked);
+    return resolved;
+}
+
+// Resolves every queued ticket matching `filter`; returns the count
+int resolveMatching(const struct ResolveFilter *filter, const char *admin_username) {
+    if (isEmpty()) return 0;
+    int size = (rear - front + MAX) % MAX + 1;
+    unsigned char *marked = calloc((size_t)size, 1);
+    if (!marked) return 0;
+
+    time_t now = time(NULL);
+    int count = 0, first = size, last = -1;
+    for (int p = 0; p < size; p++) {
+        if (!ticketMatchesFilter(&queue[(front + p) % MAX], filter, now)) continue;
+        marked[p] = 1;
+        count++;
+        if (p < first) first = p;
+        last = p;
+    }
+    int resolved = resolveMarkedPositions(marked, first, last, count, admin_username);
+    free(marked);
+    return resolved;
+}
+
+// Resolves the first `n` tickets in FIFO order; returns the count
+int resolveFirst(int n, const char *admin_username) {
+    if (isEmpty() || n <= 0) return 0;
+    int size = (rear - front + MAX) % MAX + 1;
+    if (n > size) n = size;
+    unsigned char *marked = malloc((size_t)n);
+    if (!marked) return 0;
+    memset(marked, 1, (size_t)n);
+    int resolved = resolveMarkedPositions(marked, 0, n - 1, n, admin_username);
+    free(marked);
+    return resolved;
+}
+
+/*
+ * Runs one bulk command; args[0] is the verb (argument layout in config.h).
+ * Returns the number resolved, or TICKET_ERROR_INVALID_DATA / _MEMORY.
+ */
+int runBulkResolve(char **args, int nargs) {
+    if (nargs >= 3 && strcmp(args[0], "RESOLVE_FIRST") == 0) {
+        int n = atoi(args[1]);
+        return n > 0 ? resolveFirst(n, args[2]) : TICKET_ERROR_INVALID_DATA;
+    }
+
+    if (nargs >= 3 && strcmp(args[0], "RESOLVE_IDS") == 0) {
+        int capacity = 1;
+        for (const char *c = args[2]; *c; c++) if (*c == ',') capacity++;
+        int *ids = malloc((size_t)capacity * sizeof(int));
+        if (!ids) return TICKET_ERROR_MEMORY;
+
+        int count = 0;
+        for (char *tok = strtok(args[2], ","); tok; tok = strtok(NULL, ",")) {
+            int id = atoi(tok);
+            if (isValidTicketID(id)) ids[count++] = id;
+        }
+        int resolved = resolveTicketList(ids, count, args[1]);
+        free(ids);
+        return resolved;
+    }
+
+    if (nargs >= 5 && strcmp(args[0], "RESOLVE_MATCHING") == 0) {
+        struct ResolveFilter filter = {NULL, NULL, 0};
+        if (strcmp(args[2], "*") != 0) {
+            if (!isValidPriority(args[2])) return TICKET_ERROR_INVALID_DATA;
+            filter.priority = args[2];
+        }
+        filter.minAgeSeconds = (long)(atof(args[3]) * 3600);
+        if (strcmp(args[4], "*") != 0) filter.product = args[4];
+
+        // Refuse an unfiltered "resolve everything"
+        if (!filter.priority && !filter.product && filter.minAgeSeconds <= 0) return TICKET_ERROR_INVALID_DATA;
+        return resolveMatching(&filter, args[1]);
+    }
+    return TICKET_ERROR_INVALID_DATA;
+}
+
+/* ==================== PRIORITY UPDATES ==================== */
+
+/*
+ * DESIGN DECISION: Log priority changes instead of rewriting the CSV
+ * A dropdown change used to rewrite the whole active database. Now the
+ * engine updates the ticket in memory (found through the ID index) and
+ * appends one "<id>,<priority>,<time>" line to PRIORITY_LOG_FILE.
+ * loadFromFile() replays the log after reading the CSV; compaction and
+ * saveQueueToFile() fold it into the CSV.
+ */
+
+int priorityLogRecords = 0;
+
+// Changes the priority of the queued ticket in `slot`, keeping counters in step
+void changeTicketPriority(int slot, const char *priority) {
+    countPriority(queue[slot].priority, -1);
+    queue[slot].priority = (uint8_t)priorityRank(priority);
+    countPriority(queue[slot].priority, 1);
+    queueVersion++;
+}
+
+void appendPriorityRecord(int id, const char *priority) {
+    FILE *log = fopen(PRIORITY_LOG_FILE, "a");
+    if (!log) {
+        // Fall back to a full rewrite so the change is not lost
+        logError("Cannot append to priority log - rewriting database");
+        saveQueueToFile();
+        return;
+    }
+    fprintf(log, "%d,%s,%ld\n", id, priority, (long)time(NULL));
+    fclose(log);
+    priorityLogRecords++;   // Folded in by the next compaction
+}
+
+// Re-applies logged priority changes to the freshly loaded queue
+void applyPriorityLog() {
+    priorityLogRecords = 0;
+    FILE *log = fopen(PRIORITY_LOG_FILE, "r");
+    if (!log) return;
+
+    char line[128];
+    while (fgets(line, sizeof(line), log)) {
+        char *fields[3];
+        removeNewline(line);
+        if (splitCSVLine(line, fields, 3) < 2) continue;
+        priorityLogRecords++;
+
+        int slot = lookupQueuedTicket(atoi(fields[0]));
+        if (slot >= 0 && isValidPriority(fields[1])) changeTicketPriority(slot, fields[1]);
+    }
+    fclose(log);
+}
+
+int setTicketPriority(int id, const char *priority, char *oldPriority) {
+    if (!isValidPriority(priority)) return TICKET_ERROR_INVALID_DATA;
+
+    int slot = findTicketSlot(id);
+    if (slot < 0) return TICKET_ERROR_NOT_FOUND;
+
+    if (oldPriority) strcpy(oldPriority, priorityNames[queue[slot].priority]);
+    changeTicketPriority(slot, priority);
+
+    // Persist as one log record; the dashboard is refreshed by the caller
+    appendPriorityRecord(id, priority);
+    markDashboardDirty();
+    return SUCCESS;
+}
+
+/* ==================== TICKET ID ALLOCATION ==================== */
+
+/*
+ * DESIGN DECISION: Persisted high-water mark with block leasing
+ * Producers (Flask, data_generator) used to compute max(ID)+1 by parsing
+ * every CSV, and two of them could pick the same number. Now
+ * TICKET_ID_HWM_FILE holds the next unassigned ID. A producer takes an
+ * exclusive flock, reads it, writes it back advanced by the block size,
+ * and then numbers its tickets locally. The mark is fsync'd before the
+ * block is handed out, so a crash can leave gaps but never reuse an ID.
+ * The engine serves the same operation over the socket (ALLOC).
+ */
+
+long ticketIDHighWater = 0;   // Lower bound of the file's value (others only raise it)
+int maxResolvedTicketID = 0;  // Highest ID seen in the archive (set by buildArchiveIndexes)
+
+/*
+ * Reserves `count` consecutive IDs, never below `floorID`.
+ * Returns the first ID of the block (count may be 0 to just raise the
+ * mark), or TICKET_ERROR_FILE_OPEN / TICKET_ERROR_INVALID_DATA.
+ */
+long reserveTicketIDs(int count, long floorID) {
+    if (count < 0 || count > MAX_TICKET_ID_LEASE) return TICKET_ERROR_INVALID_DATA;
+
+    char buf[32] = "";
+#ifndef _WIN32
+    int fd = open(TICKET_ID_HWM_FILE, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        logError("Cannot open ticket ID high-water mark file");
+        return TICKET_ERROR_FILE_OPEN;
+    }
+    flock(fd, LOCK_EX);
+    ssize_t got = pread(fd, buf, sizeof(buf) - 1, 0);
+    buf[got > 0 ? got : 0] = '\0';
+#else
+    FILE *in = fopen(TICKET_ID_HWM_FILE, "r");
+    if (in) {
+        if (!fgets(buf, sizeof(buf), in)) buf[0] = '\0';
+        fclose(in);
+    }
+#endif
+
+    long first = atol(buf);
+    if (first < floorID) first = floorID;
+    if (first < FIRST_ALLOCATED_TICKET_ID) first = FIRST_ALLOCATED_TICKET_ID;
+
+    long next = first + count;
+    if (next - 1 > MAX_TICKET_ID) {
+        logError("Ticket ID space exhausted");
+#ifndef _WIN32
+        flock(fd, LOCK_UN);
+        close(fd);
+#endif
+        return TICKET_ERROR_INVALID_DATA;
+    }
+
+    int len = snprintf(buf, sizeof(buf), "%ld\n", next);
+#ifndef _WIN32
+    int ok = ftruncate(fd, 0) == 0 && pwrite(fd, buf, len, 0) == len && fsync(fd) == 0;
+    flock(fd, LOCK_UN);
+    close(fd);
+#else
+    FILE *out = fopen(TICKET_ID_HWM_FILE, "w");
+    int ok = out && fputs(buf, out) >= 0;
+    if (out) fclose(out);
+#endif
+    if (!ok) {
+        logError("Cannot persist ticket ID high-water mark");
+        return TICKET_ERROR_FILE_OPEN;
+    }
+
+    ticketIDHighWater = next;
+    return first;
+}
+
+// Raises the mark past IDs already in use (queue and archive); run at startup
+void seedTicketIDAllocator() {
+    long maxKnown = maxResolvedTicketID;
+    if (!isEmpty()) {
+        int i = front;
+        while (1) {
+            if (queue[i].ticketID > maxKnown) maxKnown = queue[i].ticketID;
+            if (i == rear) break;
+            i = (i + 1) % MAX;
+        }
+    }
+    reserveTicketIDs(0, maxKnown + 1);
+}
+
+// Keeps the mark ahead of IDs assigned outside the allocator (legacy producers)
+void noteTicketID(int id) {
+    if (id >= ticketIDHighWater) reserveTicketIDs(0, (long)id + 1);
+}
+
+/* ==================== PENDING TICKET PROCESSING ==================== */
+void appendTicketRecord(FILE *db, const struct Ticket *t) {
+    char row[TICKET_RECORD_MAX];
+    formatTicketRecord(row, sizeof(row), t);
+    fputs(row, db);
+}
+
+// Byte offset the next row appended to `db` starts at, or -1
+long appendOffset(FILE *db) {
+    return fseek(db, 0, SEEK_END) == 0 ? ftell(db) : -1;
+}
+
+/*
+ * Shared ingestion path for spooled batch files and the engine socket:
+ * duplicate check -> auto-priority -> enqueue -> append to active database.
+ * In cold-field mode the ticket's text is read back from its row in `db`.
+ * Returns SUCCESS, TICKET_ERROR_DUPLICATE (existingID set) or TICKET_ERROR_QUEUE_FULL.
+ */
+int ingestTicket(struct Ticket *t, time_t entryTime, FILE *db, int *existingID) {
+    traceSubmit(t);
+
+    // DUPLICATE DETECTION
+    int existingTicketID = isDuplicateInQueue(t->email, t->issueDescription);
+    
+    if (existingTicketID > 0) {
+        // Log duplicate and skip
+        logEvent(LOG_DUPLICATE, "Duplicate rejected: Ticket #%d (similar to #%d) - %s - %s",
+                 t->ticketID, existingTicketID, t->email, t->issueDescription);
+        countMetric(&metricDuplicatesRejected);
+        if (existingID) *existingID = existingTicketID;
+        return TICKET_ERROR_DUPLICATE;
+    }
+
+    // If not duplicate, process normally
+    strncpy(t->priority, getAutoPriority(t->issueDescription), 19);
+    t->priority[19] = '\0';
+    t->queueEntryTime = entryTime;
+
+    long row = (coldFieldMode && db) ? appendOffset(db) : -1;
+    if (!enqueueTicket(t, row)) return TICKET_ERROR_QUEUE_FULL;
+    noteTicketID(t->ticketID);
+    countMetric(&metricTicketsIngested);
+
+    if (db) appendTicketRecord(db, t);
+    if (row >= 0) fflush(db);   // Readable before the next cold lookup
+    markDashboardDirty();
+    return SUCCESS;
+}
+
+/*
+ * DESIGN DECISION: Batch enqueue for file-based ingestion
+ * ingestTicket() costs a dedup probe, a store through enqueueTicket(), an
+ * fprintf and (in the old pending path) a full loadFromFile() per batch.
+ * enqueueBatch() does one pass over the batch to validate, classify and
+ * dedup it. The dedup covers the queue and, through a local hash table,
+ * earlier rows of the same batch. It then reserves all queue slots at
+ * once and writes every accepted row with a single fwrite.
+ */
+
+// ID of an earlier batch row with duplicate key `key` matching t, or 0
+int findDuplicateInBatch(const struct IndexTable *seen, const struct Ticket *tickets,
+                         unsigned long long key, const struct Ticket *t, const char *issuePrefix) {
+    if (!seen->entries) return 0;
+
+    int mask = seen->capacity - 1;
+    for (int i = indexHome(seen, key); seen->entries[i].ticketID != 0; i = (i + 1) & mask) {
+        const struct IndexEntry *e = &seen->entries[i];
+        if (e->key == key && ticketMatchesIssue(tickets[e->value].email, tickets[e->value].issueDescription,
+                                                 t->email, issuePrefix)) {
+            return e->ticketID;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Ingests `count` tickets in order. results[i] (optional) receives
+ * SUCCESS, TICKET_ERROR_INVALID_DATA, TICKET_ERROR_DUPLICATE or
+ * TICKET_ERROR_QUEUE_FULL. Rows that do not fit in the queue are still
+ * written to `db` (if given) so they load once capacity frees up.
+ * Returns the number of tickets enqueued.
+ */
+int enqueueBatch(struct Ticket *tickets, int count, time_t entryTime, FILE *db, int *results) {
+    if (count <= 0) return 0;
+
+    int *status = results ? results : malloc((size_t)count * sizeof(int));
+    unsigned long long *keys = malloc((size_t)count * sizeof(unsigned long long));
+    if (!status || !keys) {
+        if (!results) free(status);
+        free(keys);
+        logError("Memory allocation failed for ticket batch");
+        return 0;
+    }
+
+    // Pass 1: validate, dedup and classify
+    struct IndexTable seenIDs = {NULL, 0, 0};
+    struct IndexTable seenIssues = {NULL, 0, 0};
+    int accepted = 0;
+    int maxID = 0;
+    for (int i = 0; i < count; i++) {
+        struct Ticket *t = &tickets[i];
+        traceSubmit(t);
+
+        if (!isValidTicketID(t->ticketID) || !isValidEmail(t->email) ||
+            !isValidString(t->customerName, 2, MAX_CUSTOMER_NAME_LEN)) {
+            logEvent(LOG_ERROR, "Invalid spooled ticket #%d - skipping", t->ticketID);
+            status[i] = TICKET_ERROR_INVALID_DATA;
+            continue;
+        }
+        // Same ID already queued or earlier in the batch: a re-read, not a new ticket
+        if (findTicketSlot(t->ticketID) >= 0 ||
+            indexFind(&seenIDs, (unsigned long long)t->ticketID, t->ticketID)) {
+            status[i] = TICKET_ERROR_DUPLICATE;
+            continue;
+        }
+
+        char issuePrefix[31];
+        strncpy(issuePrefix, t->issueDescription, 30);
+        issuePrefix[30] = '\0';
+        for (int j = 0; issuePrefix[j]; j++) issuePrefix[j] = tolower(issuePrefix[j]);
+
+        // One key per ticket serves the queue probe, the batch probe and the index
+        keys[i] = duplicateKey(t->email, t->issueDescription);
+        int existingTicketID = isEmpty() ? 0 : findDuplicateByKey(keys[i], t->email, issuePrefix);
+        if (!existingTicketID) existingTicketID = findDuplicateInBatch(&seenIssues, tickets, keys[i], t, issuePrefix);
+        if (existingTicketID > 0) {
+            logEvent(LOG_DUPLICATE, "Duplicate rejected: Ticket #%d (similar to #%d) - %s - %s",
+                     t->ticketID, existingTicketID, t->email, t->issueDescription);
+            countMetric(&metricDuplicatesRejected);
+            status[i] = TICKET_ERROR_DUPLICATE;
+            continue;
+        }
+
+        indexPut(&seenIDs, (unsigned long long)t->ticketID, t->ticketID, i);
+        indexPut(&seenIssues, keys[i], t->ticketID, i);
+        strncpy(t->priority, getAutoPriority(t->issueDescription), 19);
+        t->priority[19] = '\0';
+        t->queueEntryTime = entryTime;
+        if (t->ticketID > maxID) maxID = t->ticketID;
+        status[i] = SUCCESS;
+        accepted++;
+    }
+    free(seenIDs.entries);
+    free(seenIssues.entries);
+
+    // Pass 2: format every accepted row (queued and overflowed) for one append
+    char *buf = (db && accepted > 0) ? malloc((size_t)accepted * TICKET_RECORD_MAX) : NULL;
+    long *rows = NULL;
+    size_t len = 0;
+    if (buf) {
+        long base = coldFieldMode ? appendOffset(db) : -1;
+        if (base >= 0) rows = malloc((size_t)count * sizeof(long));
+        for (int i = 0; i < count; i++) {
+            if (status[i] != SUCCESS) continue;
+            if (rows) rows[i] = base + (long)len;
+            len += (size_t)formatTicketRecord(buf + len, TICKET_RECORD_MAX, &tickets[i]);
+        }
+    }
+
+    // Pass 3: reserve slots for everything that fits, in one step
+    int used = isEmpty() ? 0 : (rear - front + MAX) % MAX + 1;
+    int room = (MAX - 1) - used;
+    int enqueued = 0;
+    int firstSlot = (rear + 1) % MAX;
+    for (int i = 0; i < count; i++) {
+        if (status[i] != SUCCESS) continue;
+        int slot = (firstSlot + enqueued) % MAX;
+        if (enqueued == room || !storeTicket(&queue[slot], &tickets[i], keys[i], rows ? rows[i] : -1)) {
+            logEvent(LOG_OVERFLOW, "QUEUE FULL - Ticket #%d rejected", tickets[i].ticketID);
+            countMetric(&metricQueueOverflows);
+            status[i] = TICKET_ERROR_QUEUE_FULL;
+            if (db && databaseOverflowRows++ == 0) {
+                databaseOverflowOffset = appendOffset(db);   // Loaded once a resolve frees a slot
+            }
+            continue;
+        }
+        indexQueuedTicket(slot);
+        countQueuedTicket(&queue[slot], 1);
+        enqueued++;
+    }
+    if (enqueued > 0) {
+        if (front == -1) front = 0;
+        rear = (firstSlot + enqueued - 1) % MAX;
+        queueVersion++;
+        __atomic_fetch_add(&metricTicketsIngested, (uint64_t)enqueued, __ATOMIC_RELAXED);
+        noteTicketID(maxID);
+        markDashboardDirty();
+    }
+
+    // Pass 4: one append for the whole batch
+    if (db && accepted > 0) {
+        if (buf) {
+            if (fwrite(buf, 1, len, db) != len) logError("Short write appending ticket batch");
+            if (rows) fflush(db);   // Readable before the next cold lookup
+        } else {
+            // No room for the batch buffer: fall back to row-at-a-time writes
+            for (int i = 0; i < count; i++) {
+                if (status[i] == SUCCESS || status[i] == TICKET_ERROR_QUEUE_FULL) {
+                    appendTicketRecord(db, &tickets[i]);
+                }
+            }
+        }
+    }
+
+    free(buf);
+    free(rows);
+    free(keys);
+    if (!results) free(status);
+    return enqueued;
+}
+
+/*
+ * DESIGN DECISION: Maildir-style spool instead of one truncated file
+ * processPendingTickets() used to read pending_tickets.csv and then
+ * reopen it with "w"; anything appended in between was lost. Now every
+ * producer writes its own batch file under SPOOL_TMP_DIR and rename()s
+ * it into SPOOL_NEW_DIR, so the engine only ever sees complete files.
+ * The engine claims a file by renaming it into SPOOL_CUR_DIR, ingests
+ * its rows, fsyncs the active database and only then unlinks it. Files
+ * still in cur/ after a crash are ingested again on the next pass;
+ * tickets that are already queued are skipped by ID. A large backlog is
+ * parsed on worker threads; ingestion itself stays in file order.
+ */
+
+struct SpoolBatch {
+    char path[300];
+    struct Ticket *tickets;
+    int count;
+};
+
+int makeSpoolDirectory(const char *path) {
+#ifdef _WIN32
+    return CreateDirectoryA(path, NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+    return mkdir(path, 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+int ensureSpoolDirectories() {
+    return makeSpoolDirectory(SPOOL_DIR) && makeSpoolDirectory(SPOOL_TMP_DIR) &&
+           makeSpoolDirectory(SPOOL_NEW_DIR) && makeSpoolDirectory(SPOOL_CUR_DIR);
+}
+
+// Reads one batch file (rows as in pending_tickets.csv) into batch->tickets
+void parseSpoolBatch(struct SpoolBatch *batch) {
+    batch->tickets = NULL;
+    batch->count = 0;
+    FILE *f = fopen(batch->path, "r");
+    if (!f) return;
+
+    int capacity = 0;
+    char line[TICKET_RECORD_MAX];
+    while (fgets(line, sizeof(line), f)) {
+        char *fields[6];
+        if (splitCSVLine(line, fields, 6) < 6) continue;
+
+        if (batch->count == capacity) {
+            int grown = capacity ? capacity * 2 : 16;
+            struct Ticket *tickets = realloc(batch->tickets, (size_t)grown * sizeof(struct Ticket));
+            if (!tickets) break;
+            batch->tickets = tickets;
+            capacity = grown;
+        }
+        struct Ticket *t = &batch->tickets[batch->count++];
+        memset(t, 0, sizeof(*t));
+        t->ticketID = atoi(fields[0]);
+        copyText(t->customerName, sizeof(t->customerName), fields[1]);
+        copyText(t->email, sizeof(t->email), fields[2]);
+        copyText(t->product, sizeof(t->product), fields[3]);
+        copyText(t->purchaseDate, sizeof(t->purchaseDate), fields[4]);
+        copyText(t->issueDescription, sizeof(t->issueDescription), fields[5]);
+    }
+    fclose(f);
+}
+
+#ifndef _WIN32
+
+struct SpoolParseJob {
+    struct SpoolBatch *batches;
+    int count;
+    int next;               // Next batch to claim (atomic)
+};
+
+void *spoolParseWorker(void *arg) {
+    struct SpoolParseJob *job = arg;
+    int i;
+    while ((i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->count) {
+        parseSpoolBatch(&job->batches[i]);
+    }
+    return NULL;
+}
+
+#endif
+
+// Parses all batches, on SPOOL_PARSE_THREADS workers when there are many
+void parseSpoolBatches(struct SpoolBatch *batches, int count) {
+#ifndef _WIN32
+    if (count >= SPOOL_PARALLEL_MIN_FILES) {
+        struct SpoolParseJob job = {batches, count, 0};
+        pthread_t workers[SPOOL_PARSE_THREADS];
+        int started = 0;
+        while (started < SPOOL_PARSE_THREADS &&
+               pthread_create(&workers[started], NULL, spoolParseWorker, &job) == 0) started++;
+        spoolParseWorker(&job);   // This thread helps too (and covers create failures)
+        for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+        return;
+    }
+#endif
+    for (int i = 0; i < count; i++) parseSpoolBatch(&batches[i]);
+}
+
+int compareSpoolBatches(const void *a, const void *b) {
+    return strcmp(((const struct SpoolBatch *)a)->path, ((const struct SpoolBatch *)b)->path);
+}
+
+// Moves `from` to `to` unless `to` exists (errno EEXIST); returns 1 on success
+int claimSpoolFile(const char *from, const char *to) {
+#ifdef _WIN32
+    struct stat st;
+    if (stat(to, &st) == 0) {
+        errno = EEXIST;
+        return 0;
+    }
+    return rename(from, to) == 0;
+#else
+    if (link(from, to) != 0) return 0;
+    unlink(from);
+    return 1;
+#endif
+}
+
+/*
+ * Moves new/ files (and a legacy pending_tickets.csv) into cur/, then
+ * returns every file in cur/ in name order. *count is set; the caller
+ * frees the array.
+ */
+struct SpoolBatch *claimSpoolBatches(int *count) {
+    char from[300], to[300];
+    *count = 0;
+
+    // Older producers still append to pending_tickets.csv: claim it whole.
+    // A claim from the same second may still be in cur/, so the name gets
+    // a sequence number and never replaces an existing file.
+    struct stat st;
+    if (stat(LEGACY_PENDING_FILE, &st) == 0 && st.st_size > 0) {
+        long now = (long)time(NULL);
+        int claimed = 0;
+        for (int seq = 0; seq < SPOOL_LEGACY_CLAIMS_PER_SECOND && !claimed; seq++) {
+            snprintf(to, sizeof(to), "%s/%ld.%03d.legacy.csv", SPOOL_CUR_DIR, now, seq);
+            if (claimSpoolFile(LEGACY_PENDING_FILE, to)) claimed = 1;
+            else if (errno != EEXIST) break;
+        }
+        if (!claimed) logError("Cannot claim pending_tickets.csv");
+    }
+
+    DIR *dir = opendir(SPOOL_NEW_DIR);
+    if (dir) {
+        struct dirent *ent;
+        while ((ent = readdir(dir)) != NULL) {
+            if (ent->d_name[0] == '.') continue;
+            snprintf(from, sizeof(from), "%s/%s", SPOOL_NEW_DIR, ent->d_name);
+            snprintf(to, sizeof(to), "%s/%s", SPOOL_CUR_DIR, ent->d_name);
+            rename(from, to);   // Atomic claim
+        }
+        closedir(dir);
+    }
+
+    dir = opendir(SPOOL_CUR_DIR);
+    if (!dir) return NULL;
+    struct SpoolBatch *batches = NULL;
+    int capacity = 0;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        if (ent->d_name[0] == '.') continue;
+        if (*count == capacity) {
+            int grown = capacity ? capacity * 2 : 16;
+            struct SpoolBatch *more = realloc(batches, (size_t)grown * sizeof(struct SpoolBatch));
+            if (!more) break;
+            batches = more;
+            capacity = grown;
+        }
+        snprintf(batches[*count].path, sizeof(batches[*count].path), "%s/%s", SPOOL_CUR_DIR, ent->d_name);
+        (*count)++;
+    }
+    closedir(dir);
+
+    if (*count > 1) qsort(batches, (size_t)*count, sizeof(struct SpoolBatch), compareSpoolBatches);
+    return batches;
+}
+
+// Flushes `db` to stable storage; returns 1 on success
+int syncDatabase(FILE *db) {
+    if (fflush(db) != 0) return 0;
+#ifndef _WIN32
+    if (fsync(fileno(db)) != 0) return 0;
+#endif
+    return 1;
+}
+
+void processPendingTickets() {
+    int count = 0;
+    struct SpoolBatch *batches = claimSpoolBatches(&count);
+    if (count == 0) {
+        free(batches);
+        return;
+    }
+
+    uint64_t startNs = metricsNow();
+    parseSpoolBatches(batches, count);
+
+    FILE *db = fopen(PENDING_TICKETS_FILE, "a");
+    if (!db) {
+        logError("Cannot open active database for spooled tickets - will retry");
+        for (int b = 0; b < count; b++) free(batches[b].tickets);
+        free(batches);
+        return;
+    }
+
+    // All claimed files go through one batch: one dedup pass, one append
+    int total = 0;
+    for (int b = 0; b < count; b++) total += batches[b].count;
+    struct Ticket *tickets = total > 0 ? malloc((size_t)total * sizeof(struct Ticket)) : NULL;
+    if (total > 0 && !tickets) {
+        logError("Memory allocation failed for spooled tickets - will retry");
+        fclose(db);
+        for (int b = 0; b < count; b++) free(batches[b].tickets);
+        free(batches);
+        return;
+    }
+    int n = 0;
+    for (int b = 0; b < count; b++) {
+        if (batches[b].count > 0) {
+            memcpy(&tickets[n], batches[b].tickets, (size_t)batches[b].count * sizeof(struct Ticket));
+            n += batches[b].count;
+        }
+    }
+    enqueueBatch(tickets, total, time(NULL), db, NULL);
+    free(tickets);
+
+    // Batch files go only once their tickets are durable in the database
+    int durable = syncDatabase(db);
+    if (fclose(db) != 0) durable = 0;
+    for (int b = 0; b < count; b++) {
+        if (durable) remove(batches[b].path);
+        free(batches[b].tickets);
+    }
+    free(batches);
+    if (!durable) logError("Cannot sync active database - spooled tickets kept for retry");
+
+    recordStageLatency(STAGE_PROCESS_PENDING, startNs);
+}
+
+/* ==================== ADMIN COMMANDS ==================== */
+
+/*
+ * DESIGN DECISION: Append-only, sequence-numbered command journal
+ * The old admin_commands.txt held one command and was truncated after
+ * reading; Flask opened it in 'w' mode, so two resolves within one cycle
+ * lost one of them. Now:
+ *   - producers append "<seq> <COMMAND> <args>" lines (under flock)
+ *   - the engine applies every new line in one batch, in order
+ *   - the last applied seq + journal offset are persisted, so commands
+ *     with seq <= last applied are skipped (retries are free)
+ *   - each command's outcome is appended as "<seq> OK|ERR <message>"
+ *     to the results file, which Flask polls instead of sleeping
+ *
+ * Commands: RESOLVE <id> [admin], SET_PRIORITY <id> <priority> [admin]
+ */
+
+long adminJournalOffset = 0;
+long lastAppliedCommandSeq = 0;
+
+void loadAdminCommandState() {
+    FILE *f = fopen(ADMIN_COMMAND_STATE_FILE, "r");
+    if (!f) return;
+    if (fscanf(f, "%ld %ld", &lastAppliedCommandSeq, &adminJournalOffset) != 2) {
+        lastAppliedCommandSeq = adminJournalOffset = 0;
+    }
+    fclose(f);
+}
+
+void saveAdminCommandState() {
+    FILE *f = fopen(ADMIN_COMMAND_STATE_FILE ".tmp", "w");
+    if (!f) {
+        logError("Cannot write admin command state");
+        return;
+    }
+    fprintf(f, "%ld %ld\n", lastAppliedCommandSeq, adminJournalOffset);
+    fclose(f);
+    rename(ADMIN_COMMAND_STATE_FILE ".tmp", ADMIN_COMMAND_STATE_FILE);
+}
+
+// Applies one journal command (text after the seq); writes a one-line result
+int applyAdminCommand(const char *command, char *result, size_t resultSize) {
+    if (strncmp(command, "RESOLVE_", 8) == 0) {
+        // Bulk commands: space-separated, the last argument runs to end of line
+        char buf[ADMIN_COMMAND_MAX_LINE];
+        snprintf(buf, sizeof(buf), "%s", command);
+        char *args[5];
+        int nargs = 0;
+        char *p = buf;
+        int maxArgs = (strncmp(buf, "RESOLVE_MATCHING", 16) == 0) ? 5 : 3;
+        while (*p && nargs < maxArgs) {
+            while (*p == ' ') p++;
+            if (!*p) break;
+            args[nargs++] = p;
+            if (nargs == maxArgs) break;
+            while (*p && *p != ' ') p++;
+            if (*p) *p++ = '\0';
+        }
+
+        int resolved = runBulkResolve(args, nargs);
+        if (resolved >= 0) {
+            snprintf(result, resultSize, "OK %d tickets resolved", resolved);
+            return SUCCESS;
+        }
+        snprintf(result, resultSize, resolved == TICKET_ERROR_FILE_OPEN ?
+                 "ERR Cannot archive tickets - still queued" : "ERR Invalid bulk resolve command");
+        return resolved;
+    }
+
+    char verb[32] = "";
+    char arg1[32] = "";
+    char arg2[100] = "";
+    char arg3[100] = "";
+    int n = sscanf(command, "%31s %31s %99s %99s", verb, arg1, arg2, arg3);
+
+    if (n >= 2 && strcmp(verb, "RESOLVE") == 0) {
+        int id = atoi(arg1);
+        const char *admin = (n >= 3) ? arg2 : "admin";
+        traceCommand(TRACE_RESOLVE, id, NULL, admin);
+        int status = resolveTicketByID(id, admin);
+        if (status == SUCCESS) {
+            snprintf(result, resultSize, "OK Ticket #%d resolved", id);
+        } else if (status == TICKET_ERROR_FILE_OPEN) {
+            snprintf(result, resultSize, "ERR Cannot archive ticket #%d - still queued", id);
+        } else {
+            snprintf(result, resultSize, "ERR Ticket #%d is not in the queue", id);
+        }
+        return status;
+    }
+
+    if (n >= 3 && strcmp(verb, "SET_PRIORITY") == 0) {
+        int id = atoi(arg1);
+        char oldPriority[20] = "";
+        traceCommand(TRACE_SET_PRIORITY, id, arg2, (n >= 4) ? arg3 : "admin");
+        int rc = setTicketPriority(id, arg2, oldPriority);
+        if (rc == SUCCESS) {
+            snprintf(result, resultSize, "OK %s -> %s", oldPriority, arg2);
+        } else if (rc == TICKET_ERROR_INVALID_DATA) {
+            snprintf(result, resultSize, "ERR Invalid priority");
+        } else {
+            snprintf(result, resultSize, "ERR Ticket #%d is not in the queue", id);
+        }
+        return rc;
+    }
+
+    snprintf(result, resultSize, "ERR Unknown command");
+    return TICKET_ERROR_INVALID_DATA;
+}
+
+// Keeps only the newest ADMIN_RESULTS_KEEP_LINES results once the file grows
+void compactAdminResults() {
+    struct stat st;
+    if (stat(ADMIN_COMMAND_RESULTS_FILE, &st) != 0 || st.st_size < ADMIN_JOURNAL_COMPACT_BYTES) return;
+
+    FILE *in = fopen(ADMIN_COMMAND_RESULTS_FILE, "r");
+    if (!in) return;
+
+    static char keep[ADMIN_RESULTS_KEEP_LINES][256];
+    long total = 0;
+    while (fgets(keep[total % ADMIN_RESULTS_KEEP_LINES], sizeof(keep[0]), in)) total++;
+    fclose(in);
+
+    FILE *out = fopen(ADMIN_COMMAND_RESULTS_FILE ".tmp", "w");
+    if (!out) return;
+    long start = total > ADMIN_RESULTS_KEEP_LINES ? total - ADMIN_RESULTS_KEEP_LINES : 0;
+    for (long i = start; i < total; i++) fputs(keep[i % ADMIN_RESULTS_KEEP_LINES], out);
+    fclose(out);
+    rename(ADMIN_COMMAND_RESULTS_FILE ".tmp", ADMIN_COMMAND_RESULTS_FILE);
+}
+
+// Truncates the journal once everything in it has been applied
+void compactAdminJournal() {
+#ifndef _WIN32
+    if (adminJournalOffset < ADMIN_JOURNAL_COMPACT_BYTES) return;
+
+    int fd = open(ADMIN_COMMANDS_FILE, O_RDWR);
+    if (fd < 0) return;
+
+    // Producers append under the same lock, so nothing can slip in between
+    if (flock(fd, LOCK_EX) == 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size == adminJournalOffset && ftruncate(fd, 0) == 0) {
+            adminJournalOffset = 0;
+            saveAdminCommandState();
+        }
+        flock(fd, LOCK_UN);
+    }
+    close(fd);
+#endif
+}
+
+void checkAdminCommands() {
+    FILE *cmd = fopen(ADMIN_COMMANDS_FILE, "r");
+    if (!cmd) return;
+
+    // Journal replaced or truncated behind our back: start from the top
+    // (seq numbers still stop anything being applied twice)
+    fseek(cmd, 0, SEEK_END);
+    if (ftell(cmd) < adminJournalOffset) adminJournalOffset = 0;
+    if (ftell(cmd) == adminJournalOffset) {
+        fclose(cmd);
+        return;
+    }
+    uint64_t startNs = metricsNow();
+    fseek(cmd, adminJournalOffset, SEEK_SET);
+
+    FILE *results = NULL;
+    int applied = 0;
+    char line[ADMIN_COMMAND_MAX_LINE];
+
+    while (fgets(line, sizeof(line), cmd)) {
+        size_t len = strlen(line);
+        if (len == 0 || line[len - 1] != '\n') break;  // Partially written - next time
+
+        adminJournalOffset += (long)len;
+        removeNewline(line);
+
+        char *rest = NULL;
+        long seq = strtol(line, &rest, 10);
+        if (rest == line || seq <= lastAppliedCommandSeq) continue;  // Malformed or already applied
+
+        while (*rest == ' ') rest++;
+        char result[200];
+        applyAdminCommand(rest, result, sizeof(result));
+        lastAppliedCommandSeq = seq;
+        applied++;
+
+        if (!results) results = fopen(ADMIN_COMMAND_RESULTS_FILE, "a");
+        if (results) fprintf(results, "%ld %s\n", seq, result);
+    }
+    fclose(cmd);
+
+    if (applied > 0 && dashboardDirty) {
+        // Refresh before publishing results so the admin's reload is current
+        refreshDashboard();
+    }
+    if (results) fclose(results);
+
+    saveAdminCommandState();
+    compactAdminJournal();
+    compactAdminResults();
+    recordStageLatency(STAGE_ADMIN_COMMANDS, startNs);
+}
+
+/* ==================== SHARED-MEMORY QUEUE SNAPSHOT ==================== */
+
+/*
+ * DESIGN DECISION: Publish the queue index through a seqlock'd mmap file
+ * Flask's status page and duplicate check used to csv-parse the whole
+ * active database per request. The engine now publishes, after each change,
+ * a compact array (queue order) of: ticket ID, position, entry time,
+ * priority, email hash and duplicate key.
+ *
+ * Seqlock protocol (single writer, any number of readers):
+ *   writer: seq++ (odd) -> write entries -> seq++ (even)
+ *   reader: read seq (retry if odd) -> copy -> re-read seq (retry if changed)
+ * Readers never block the engine and never take a lock.
+ * The reader side lives in server.py (read_queue_snapshot).
+ */
+
+#ifndef _WIN32
+
+#define SNAPSHOT_MAGIC "TQSNAP1"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_FLAG_LIVE 0x1u
+
+struct SnapshotHeader {          // 64 bytes
+    char magic[8];
+    uint32_t version;
+    uint32_t entrySize;
+    uint32_t capacity;
+    uint32_t seq;                // Seqlock counter, odd while writing
+    uint32_t count;              // Entries that follow, in queue order
+    uint32_t flags;              // SNAPSHOT_FLAG_LIVE while the engine runs
+    int64_t publishedAt;
+    uint64_t generation;         // Number of publishes
+    char reserved[16];
+};
+
+struct SnapshotEntry {           // 40 bytes
+    int32_t ticketID;
+    int32_t position;            // 1-based queue position
+    int64_t entryTime;
+    uint64_t emailHash;          // hashString(normalized email)
+    uint64_t duplicateKey;       // duplicateKey(email, issue)
+    uint8_t priority;            // priorityRank(): 0 = Critical ... 3 = Low
+    uint8_t reserved[7];
+};
+
+struct SnapshotHeader *snapshotHeader = NULL;
+struct SnapshotEntry *snapshotEntries = NULL;
+size_t snapshotMapSize = 0;
+unsigned long snapshotPublishedVersion = (unsigned long)-1;
+
+int openQueueSnapshot() {
+    snapshotMapSize = sizeof(struct SnapshotHeader) + (size_t)MAX * sizeof(struct SnapshotEntry);
+
+    // Reuse the file (no O_TRUNC) so readers' existing mappings stay valid
+    int fd = open(QUEUE_SNAPSHOT_FILE, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0 || ftruncate(fd, (off_t)snapshotMapSize) != 0) {
+        logError("Cannot create queue snapshot file - readers will parse CSV");
+        if (fd >= 0) close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, snapshotMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        logError("Cannot map queue snapshot file - readers will parse CSV");
+        return 0;
+    }
+
+    snapshotHeader = (struct SnapshotHeader *)map;
+    snapshotEntries = (struct SnapshotEntry *)(snapshotHeader + 1);
+
+    // Make any stale seq even before (re)initializing the header
+    uint32_t seq = __atomic_load_n(&snapshotHeader->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&snapshotHeader->seq, (seq | 1u) + 1u, __ATOMIC_RELAXED);
+    memcpy(snapshotHeader->magic, SNAPSHOT_MAGIC, sizeof(snapshotHeader->magic));
+    snapshotHeader->version = SNAPSHOT_VERSION;
+    snapshotHeader->entrySize = sizeof(struct SnapshotEntry);
+    snapshotHeader->capacity = MAX;
+    snapshotPublishedVersion = (unsigned long)-1;
+    return 1;
+}
+
+// Republishes the queue if it changed since the last publish; O(queue size)
+void publishQueueSnapshot() {
+    if (!snapshotHeader || snapshotPublishedVersion == queueVersion) return;
+
+    uint32_t seq = __atomic_load_n(&snapshotHeader->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&snapshotHeader->seq, seq + 1, __ATOMIC_RELAXED);   // Odd: write in progress
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    uint32_t count = 0;
+    if (!isEmpty()) {
+        int i = front;
+        while (1) {
+            struct SnapshotEntry *e = &snapshotEntries[count];
+            e->ticketID = queue[i].ticketID;
+            e->position = (int32_t)(count + 1);
+            e->entryTime = (int64_t)queue[i].queueEntryTime;
+            char email[MAX_EMAIL_LEN + 1];
+            normalizeEmail(ticketText(&queue[i], FIELD_EMAIL), email, sizeof(email));
+            e->emailHash = hashString(email);
+            e->duplicateKey = queue[i].dupKey;
+            e->priority = queue[i].priority;
+            count++;
+
+            if (i == rear) break;
+            i = (i + 1) % MAX;
+        }
+    }
+    snapshotHeader->count = count;
+    snapshotHeader->flags = SNAPSHOT_FLAG_LIVE;
+    snapshotHeader->publishedAt = (int64_t)time(NULL);
+    snapshotHeader->generation++;
+
+    __atomic_store_n(&snapshotHeader->seq, seq + 2, __ATOMIC_RELEASE);  // Even: consistent
+    snapshotPublishedVersion = queueVersion;
+}
+
+// Final publish with the live flag cleared, so readers fall back to CSV
+void closeQueueSnapshot() {
+    if (!snapshotHeader) return;
+    uint32_t seq = __atomic_load_n(&snapshotHeader->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&snapshotHeader->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    snapshotHeader->flags = 0;
+    __atomic_store_n(&snapshotHeader->seq, seq + 2, __ATOMIC_RELEASE);
+    munmap(snapshotHeader, snapshotMapSize);
+    snapshotHeader = NULL;
+    snapshotEntries = NULL;
+}
+
+#else /* _WIN32 */
+
+int openQueueSnapshot() { return 0; }
+void publishQueueSnapshot() {}
+void closeQueueSnapshot() {}
+
+#endif /* _WIN32 */
+
+/* ==================== ENGINE SOCKET SERVER ==================== */
+
+/*
+ * DESIGN DECISION: Unix domain socket + epoll instead of polled files
+ * Flask used to append to pending_tickets.csv / write admin commands and
+ * then sleep, hoping the engine noticed within one cycle. Requests on the
+ * socket are applied immediately and acknowledged synchronously.
+ *
+ * Wire format: 4-byte big-endian payload length, then tab-separated fields.
+ * The file-based paths stay in place as a fallback (and for Windows).
+ */
+
+// Bits returned by waitForEngineEvents()
+#define ENGINE_EVENT_SOCKET   0x01u
+#define ENGINE_EVENT_PENDING  0x02u
+#define ENGINE_EVENT_ADMIN    0x04u
+#define ENGINE_EVENT_DATABASE 0x08u
+#define ENGINE_EVENT_SHUTDOWN 0x10u
+#define ENGINE_EVENT_TIMER    0x20u
+
+#ifdef __linux__
+
+// epoll data tags; client connections use their slot index
+#define SOCKET_LISTENER_TAG 0xFFFFFFFFu
+#define INOTIFY_TAG 0xFFFFFFFEu
+#define SIGNALFD_TAG 0xFFFFFFFDu
+#define TIMER_TAG 0xFFFFFFFCu
+#define MAX_REQUEST_FIELDS 16
+
+struct SocketClient {
+    int fd;                                   // -1 = free slot
+    size_t len;                               // Bytes buffered so far
+    unsigned char buf[4 + MAX_FRAME_SIZE];
+    size_t outLen;                            // Reply bytes not yet sent (0 = none)
+    size_t outSent;
+    unsigned char out[4 + MAX_FRAME_SIZE];
+};
+
+struct SocketClient socketClients[MAX_SOCKET_CLIENTS];
+int listenFd = -1;
+int epollFd = -1;
+int inotifyFd = -1;
+int spoolWatch = -1;     // inotify watch on SPOOL_NEW_DIR
+int signalFd = -1;
+
+// Defined with the tickless event loop below
+unsigned int drainFileEvents();
+unsigned int drainSignalEvents();
+unsigned int drainTimerEvents();
+int startEngineThreads();
+void stopEngineThreads();
+
+// Splits a request payload on tabs in place; returns the field count
+int splitRequestFields(char *payload, char **fields, int maxFields) {
+    int count = 0;
+    char *p = payload;
+    fields[count++] = p;
+    while (*p && count < maxFields) {
+        if (*p == '\t') {
+            *p = '\0';
+            fields[count++] = p + 1;
+        }
+        p++;
+    }
+    return count;
+}
+
+/*
+ * Executes one request and writes the reply payload into `reply`.
+ * Every command gets exactly one reply, so clients can wait synchronously.
+ */
+// Appends "\t<field>" to the reply; tabs/newlines inside the field become spaces
+void appendReplyField(char *reply, size_t replySize, const char *field) {
+    size_t n = strlen(reply);
+    if (n + 1 >= replySize) return;
+    reply[n++] = '\t';
+    while (*field && n + 1 < replySize) {
+        char c = *field++;
+        reply[n++] = (c == '\t' || c == '\n' || c == '\r') ? ' ' : c;
+    }
+    reply[n] = '\0';
+}
+
+/*
+ * QUERY <id> <email>: status lookup served from the ticket indexes.
+ *   OK Open <id> <position> <wait seconds> <priority> <name> <product> <date> <issue>
+ *   OK Resolved <id> <resolved at> <entry time> <priority> <name> <product> <date> <issue>
+ *   UNAUTHORIZED (email does not match) / NOT_FOUND
+ */
+void handleTicketQuery(int id, const char *email, char *reply, size_t replySize) {
+    char want[MAX_EMAIL_LEN + 1], have[MAX_EMAIL_LEN + 1];
+    normalizeEmail(email, want, sizeof(want));
+
+    int slot = lookupQueuedTicket(id);
+    if (slot >= 0) {
+        const struct QueuedTicket *t = &queue[slot];
+        normalizeEmail(ticketText(t, FIELD_EMAIL), have, sizeof(have));
+        if (strcmp(want, have) != 0) {
+            snprintf(reply, replySize, "UNAUTHORIZED");
+            return;
+        }
+        snprintf(reply, replySize, "OK\tOpen\t%d\t%d\t%ld", id, queuePosition(slot),
+                 (long)(time(NULL) - t->queueEntryTime));
+        appendReplyField(reply, replySize, priorityNames[t->priority]);
+        appendReplyField(reply, replySize, ticketText(t, FIELD_NAME));
+        appendReplyField(reply, replySize, ticketText(t, FIELD_PRODUCT));
+        appendReplyField(reply, replySize, ticketText(t, FIELD_DATE));
+        appendReplyField(reply, replySize, ticketText(t, FIELD_ISSUE));
+        return;
+    }
+
+    // Ticket ID, Name, Email, Product, Date, Issue, Priority, Entry Time, Resolved At, Resolved By
+    char line[ARCHIVE_RECORD_MAX];
+    char *fields[10];
+    int n = lookupResolvedTicket(id, line, sizeof(line), fields, 10);
+    if (n < 6) {
+        snprintf(reply, replySize, "NOT_FOUND");
+        return;
+    }
+    normalizeEmail(fields[2], have, sizeof(have));
+    if (strcmp(want, have) != 0) {
+        snprintf(reply, replySize, "UNAUTHORIZED");
+        return;
+    }
+    snprintf(reply, replySize, "OK\tResolved\t%d", id);
+    appendReplyField(reply, replySize, n > 8 ? fields[8] : "N/A");
+    appendReplyField(reply, replySize, n > 7 ? fields[7] : "");
+    appendReplyField(reply, replySize, n > 6 ? fields[6] : "N/A");
+    appendReplyField(reply, replySize, fields[1]);
+    appendReplyField(reply, replySize, fields[3]);
+    appendReplyField(reply, replySize, fields[4]);
+    appendReplyField(reply, replySize, fields[5]);
+}
+
+void handleEngineRequest(char *payload, char *reply, size_t replySize) {
+    char *f[MAX_REQUEST_FIELDS];
+    int n = splitRequestFields(payload, f, MAX_REQUEST_FIELDS);
+
+    if (strcmp(f[0], "SUBMIT") == 0) {
+        if (n < 7) {
+            snprintf(reply, replySize, "ERR\tSUBMIT needs 6 fields");
+            return;
+        }
+        struct Ticket t;
+        memset(&t, 0, sizeof(t));
+        t.ticketID = atoi(f[1]);
+        copyText(t.customerName, sizeof(t.customerName), f[2]);
+        copyText(t.email, sizeof(t.email), f[3]);
+        copyText(t.product, sizeof(t.product), f[4]);
+        copyText(t.purchaseDate, sizeof(t.purchaseDate), f[5]);
+        copyText(t.issueDescription, sizeof(t.issueDescription), f[6]);
+
+        if (!isValidTicketID(t.ticketID) || !isValidEmail(t.email) ||
+            !isValidString(t.customerName, 2, MAX_CUSTOMER_NAME_LEN)) {
+            snprintf(reply, replySize, "ERR\tInvalid ticket data");
+            return;
+        }
+        if (findTicketSlot(t.ticketID) >= 0) {
+            snprintf(reply, replySize, "ERR\tTicket #%d already queued", t.ticketID);
+            return;
+        }
+
+        FILE *db = fopen(PENDING_TICKETS_FILE, "a");
+        int existingID = 0;
+        int result = ingestTicket(&t, time(NULL), db, &existingID);
+        if (db) fclose(db);
+
+        if (result == SUCCESS) {
+            // Optional 8th field: client's submission time (metricsNow() clock)
+            uint64_t submittedNs = (n >= 8) ? strtoull(f[7], NULL, 10) : 0;
+            if (submittedNs > 0 && submittedNs <= metricsNow()) {
+                recordStageLatency(STAGE_SUBMIT_TO_QUEUED, submittedNs);
+            }
+            int position = queuePosition(rear);
+            snprintf(reply, replySize, "OK\t%d\t%s\t%d", t.ticketID, t.priority, position);
+        } else if (result == TICKET_ERROR_DUPLICATE) {
+            snprintf(reply, replySize, "DUPLICATE\t%d", existingID);
+        } else {
+            snprintf(reply, replySize, "ERR\tQueue full");
+        }
+    }
+    else if (strncmp(f[0], "RESOLVE_", 8) == 0) {
+        int resolved = runBulkResolve(f, n);
+        if (resolved >= 0) {
+            refreshDashboard();
+            snprintf(reply, replySize, "OK\t%d", resolved);
+        } else if (resolved == TICKET_ERROR_FILE_OPEN) {
+            snprintf(reply, replySize, "ERR\tCannot archive tickets - still queued");
+        } else {
+            snprintf(reply, replySize, "ERR\tInvalid bulk resolve command");
+        }
+    }
+    else if (strcmp(f[0], "RESOLVE") == 0) {
+        if (n < 2) {
+            snprintf(reply, replySize, "ERR\tRESOLVE needs a ticket ID");
+            return;
+        }
+        int id = atoi(f[1]);
+        const char *admin = (n >= 3 && f[2][0]) ? f[2] : "admin";
+        traceCommand(TRACE_RESOLVE, id, NULL, admin);
+        int status = resolveTicketByID(id, admin);
+        if (status == SUCCESS) {
+            refreshDashboard();
+            snprintf(reply, replySize, "OK\t%d", id);
+        } else if (status == TICKET_ERROR_FILE_OPEN) {
+            snprintf(reply, replySize, "ERR\tCannot archive ticket #%d - still queued", id);
+        } else {
+            snprintf(reply, replySize, "ERR\tTicket #%d is not in the queue", id);
+        }
+    }
+    else if (strcmp(f[0], "SET_PRIORITY") == 0) {
+        if (n < 3) {
+            snprintf(reply, replySize, "ERR\tSET_PRIORITY needs a ticket ID and priority");
+            return;
+        }
+        int id = atoi(f[1]);
+        char oldPriority[20] = "";
+        traceCommand(TRACE_SET_PRIORITY, id, f[2], (n >= 4 && f[3][0]) ? f[3] : "admin");
+        int result = setTicketPriority(id, f[2], oldPriority);
+        if (result == SUCCESS) {
+            refreshDashboard();
+            snprintf(reply, replySize, "OK\t%s\t%s", oldPriority, f[2]);
+        } else if (result == TICKET_ERROR_INVALID_DATA) {
+            snprintf(reply, replySize, "ERR\tInvalid priority");
+        } else {
+            snprintf(reply, replySize, "ERR\tTicket #%d is not in the queue", id);
+        }
+    }
+    else if (strcmp(f[0], "QUERY") == 0) {
+        if (n < 3) {
+            snprintf(reply, replySize, "ERR\tQUERY needs a ticket ID and email");
+            return;
+        }
+        handleTicketQuery(atoi(f[1]), f[2], reply, replySize);
+    }
+    else if (strcmp(f[0], "DUPCHECK") == 0) {
+        if (n < 3) {
+            snprintf(reply, replySize, "ERR\tDUPCHECK needs an email and issue");
+            return;
+        }
+        int existingID = isDuplicateInQueue(f[1], f[2]);
+        if (existingID) {
+            snprintf(reply, replySize, "DUPLICATE\t%d", existingID);
+        } else {
+            snprintf(reply, replySize, "OK");
+        }
+    }
+    else if (strcmp(f[0], "ALLOC") == 0) {
+        int count = (n >= 2 && f[1][0]) ? atoi(f[1]) : TICKET_ID_LEASE_SIZE;
+        if (count < 1 || count > MAX_TICKET_ID_LEASE) {
+            snprintf(reply, replySize, "ERR\tLease size must be 1-%d", MAX_TICKET_ID_LEASE);
+            return;
+        }
+        long first = reserveTicketIDs(count, ticketIDHighWater);
+        if (first < 0) {
+            snprintf(reply, replySize, "ERR\tCannot allocate ticket IDs");
+        } else {
+            snprintf(reply, replySize, "OK\t%ld\t%d", first, count);
+        }
+    }
+    else if (strcmp(f[0], "METRICS") == 0) {
+        // Per-stage latency since start, for load and replay tools
+        snprintf(reply, replySize, "OK");
+        for (int stage = 0; stage < STAGE_COUNT; stage++) {
+            char field[96];
+            const struct LatencyHistogram *h = &stageLatency[stage];
+            snprintf(field, sizeof(field), "%s %llu %llu %llu %llu", stageNames[stage],
+                     (unsigned long long)__atomic_load_n(&h->total, __ATOMIC_RELAXED),
+                     (unsigned long long)(histogramQuantile(h, 0.5) / 1000),
+                     (unsigned long long)(histogramQuantile(h, 0.99) / 1000),
+                     (unsigned long long)(__atomic_load_n(&h->maxNs, __ATOMIC_RELAXED) / 1000));
+            appendReplyField(reply, replySize, field);
+        }
+    }
+    else if (strcmp(f[0], "REPORT") == 0) {
+        int group = n >= 2 ? reportGroupFromName(f[1]) : -1;
+        int days = n >= 3 ? atoi(f[2]) : REPORT_DEFAULT_DAYS;
+        if (group < 0 || days <= 0) {
+            snprintf(reply, replySize, "ERR\tREPORT needs priority, product, admin or day and a day count");
+            return;
+        }
+        days = clampReportDays(days);
+        time_t now = time(NULL);
+        int count;
+        struct ReportLine *lines = buildReport(group, now - (time_t)days * 86400, now, &count);
+        if (!lines) {
+            snprintf(reply, replySize, "ERR\tOut of memory");
+            return;
+        }
+        // Whole groups only; product and admin lines come largest first
+        snprintf(reply, replySize, "OK");
+        for (int i = 0; i < count; i++) {
+            char field[MAX_PRODUCT_LEN + 96];
+            snprintf(field, sizeof(field), "%llu %llu %llu %llu %s", (unsigned long long)lines[i].count,
+                     (unsigned long long)lines[i].p50, (unsigned long long)lines[i].p90,
+                     (unsigned long long)lines[i].p99, lines[i].name);
+            if (strlen(reply) + strlen(field) + 2 > replySize) break;
+            appendReplyField(reply, replySize, field);
+        }
+        free(lines);
+    }
+    else if (strcmp(f[0], "STATS") == 0) {
+        int total = 0, oldestHours = 0;
+        double avgWait = 0.0;
+        int priorities[4] = {0, 0, 0, 0};
+        getQueueStats(&total, &avgWait, &oldestHours, priorities);
+        snprintf(reply, replySize,
+                 "OK\ttotal=%d\tavg_wait_hours=%.2f\toldest_hours=%d\tcritical=%d\thigh=%d\tmedium=%d\tlow=%d",
+                 total, avgWait, oldestHours, priorities[0], priorities[1], priorities[2], priorities[3]);
+        struct WaitQuantiles waits[4];
+        getWaitQuantiles(waits, NULL, 0);
+        for (int p = 0; p < 4; p++) {
+            char field[64];
+            snprintf(field, sizeof(field), "wait_%c%s=%u,%u,%u", tolower((unsigned char)waits[p].name[0]),
+                     waits[p].name + 1, waits[p].p50, waits[p].p90, waits[p].p99);
+            appendReplyField(reply, replySize, field);
+        }
+    }
+    else {
+        snprintf(reply, replySize, "ERR\tUnknown command");
+    }
+}
+
+// Watches `c` for requests, or (while a reply is pending) for room to send it
+void watchSocketClient(struct SocketClient *c, unsigned int events) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events | EPOLLRDHUP;
+    ev.data.u32 = (unsigned int)(c - socketClients);
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, c->fd, &ev);
+}
+
+/*
+ * Sends as much of the pending reply as the socket takes. A client that
+ * is not reading keeps the rest in c->out and is watched for EPOLLOUT;
+ * its further requests wait, nobody else's do. Returns 0 on a dead client.
+ */
+int flushSocketClient(struct SocketClient *c) {
+    while (c->outSent < c->outLen) {
+        ssize_t w = send(c->fd, c->out + c->outSent, c->outLen - c->outSent, MSG_NOSIGNAL);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                watchSocketClient(c, EPOLLOUT);
+                return 1;
+            }
+            return 0;
+        }
+        c->outSent += (size_t)w;
+    }
+    if (c->outLen > 0) {
+        c->outLen = c->outSent = 0;
+        watchSocketClient(c, EPOLLIN);
+    }
+    return 1;
+}
+
+int sendFrame(struct SocketClient *c, const char *payload, size_t len) {
+    c->out[0] = (unsigned char)(len >> 24);
+    c->out[1] = (unsigned char)(len >> 16);
+    c->out[2] = (unsigned char)(len >> 8);
+    c->out[3] = (unsigned char)len;
+    memcpy(c->out + 4, payload, len);
+    c->outLen = 4 + len;
+    c->outSent = 0;
+    return flushSocketClient(c);
+}
+
+void closeSocketClient(struct SocketClient *c) {
+    if (c->fd < 0) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+    c->len = 0;
+    c->outLen = c->outSent = 0;
+}
+
+int startCommandSocket() {
+    for (int i = 0; i < MAX_SOCKET_CLIENTS; i++) socketClients[i].fd = -1;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, ENGINE_SOCKET_PATH, sizeof(addr.sun_path) - 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        logError("Cannot create engine socket - falling back to file polling");
+        return 0;
+    }
+
+    unlink(ENGINE_SOCKET_PATH);  // Stale socket from a previous run
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenFd, 64) < 0) {
+        char errMsg[256];
+        snprintf(errMsg, sizeof(errMsg), "Cannot bind %s: %s - falling back to file polling",
+                 ENGINE_SOCKET_PATH, strerror(errno));
+        logError(errMsg);
+        close(listenFd);
+        listenFd = -1;
+        return 0;
+    }
+
+    if (epollFd < 0) epollFd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = SOCKET_LISTENER_TAG;
+    if (epollFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev) < 0) {
+        logError("Cannot set up epoll for engine socket - falling back to file polling");
+        if (epollFd >= 0) close(epollFd);
+        close(listenFd);
+        unlink(ENGINE_SOCKET_PATH);
+        epollFd = listenFd = -1;
+        return 0;
+    }
+
+    printf(" Engine socket listening on %s\n", ENGINE_SOCKET_PATH);
+    return 1;
+}
+
+void acceptSocketClients() {
+    while (1) {
+        int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN: no more pending connections
+
+        int slot = -1;
+        for (int i = 0; i < MAX_SOCKET_CLIENTS; i++) {
+            if (socketClients[i].fd < 0) { slot = i; break; }
+        }
+        if (slot < 0) {
+            logError("Engine socket: too many clients - connection refused");
+            close(fd);
+            continue;
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u32 = (unsigned int)slot;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            close(fd);
+            continue;
+        }
+        socketClients[slot].fd = fd;
+        socketClients[slot].len = 0;
+        socketClients[slot].outLen = socketClients[slot].outSent = 0;
+    }
+}
+
+// Serves the complete frames buffered for `c` (clients may pipeline),
+// pausing while a reply is still waiting to be sent
+void handleSocketFrames(struct SocketClient *c) {
+    while (c->fd >= 0 && c->outLen == 0 && c->len >= 4) {
+        size_t frameLen = ((size_t)c->buf[0] << 24) | ((size_t)c->buf[1] << 16) |
+                          ((size_t)c->buf[2] << 8) | (size_t)c->buf[3];
+        if (frameLen > MAX_FRAME_SIZE) {
+            logError("Engine socket: oversized frame - dropping client");
+            closeSocketClient(c);
+            return;
+        }
+        if (c->len < 4 + frameLen) break;
+
+        char payload[MAX_FRAME_SIZE + 1];
+        memcpy(payload, c->buf + 4, frameLen);
+        payload[frameLen] = '\0';
+
+        char reply[MAX_FRAME_SIZE];
+        handleEngineRequest(payload, reply, sizeof(reply));
+
+        memmove(c->buf, c->buf + 4 + frameLen, c->len - 4 - frameLen);
+        c->len -= 4 + frameLen;
+        if (!sendFrame(c, reply, strlen(reply))) closeSocketClient(c);
+    }
+}
+
+void readSocketClient(struct SocketClient *c) {
+    while (c->fd >= 0 && c->outLen == 0) {
+        ssize_t r = recv(c->fd, c->buf + c->len, sizeof(c->buf) - c->len, 0);
+        if (r == 0) { closeSocketClient(c); return; }
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) closeSocketClient(c);
+            return;
+        }
+        c->len += (size_t)r;
+        handleSocketFrames(c);
+    }
+}
+
+// EPOLLOUT: the rest of a pending reply, then the requests held back behind it
+void writeSocketClient(struct SocketClient *c) {
+    if (!flushSocketClient(c)) {
+        closeSocketClient(c);
+        return;
+    }
+    handleSocketFrames(c);
+}
+
+/*
+ * Waits up to timeoutMs (-1 = indefinitely) for any engine event.
+ * Socket requests are served inline; file changes and shutdown are
+ * returned as ENGINE_EVENT_* bits for the caller to act on.
+ */
+unsigned int waitForEngineEvents(int timeoutMs) {
+    struct epoll_event events[32];
+    unsigned int fired = 0;
+    int n = epoll_wait(epollFd, events, 32, timeoutMs);
+
+    for (int i = 0; i < n; i++) {
+        unsigned int tag = events[i].data.u32;
+        if (tag == SOCKET_LISTENER_TAG) {
+            acceptSocketClients();
+            fired |= ENGINE_EVENT_SOCKET;
+            continue;
+        }
+        if (tag == INOTIFY_TAG) {
+            fired |= drainFileEvents();
+            continue;
+        }
+        if (tag == SIGNALFD_TAG) {
+            fired |= drainSignalEvents();
+            continue;
+        }
+        if (tag == TIMER_TAG) {
+            fired |= drainTimerEvents();
+            continue;
+        }
+        struct SocketClient *c = &socketClients[tag];
+        if (c->fd < 0) continue;
+        if (events[i].events & EPOLLOUT) writeSocketClient(c);
+        if (c->fd >= 0 && (events[i].events & EPOLLIN)) readSocketClient(c);
+        if (c->fd >= 0 && (events[i].events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP))) {
+            closeSocketClient(c);
+        }
+        fired |= ENGINE_EVENT_SOCKET;
+    }
+    return fired;
+}
+
+void stopCommandSocket() {
+    if (listenFd < 0) return;
+    for (int i = 0; i < MAX_SOCKET_CLIENTS; i++) closeSocketClient(&socketClients[i]);
+    close(listenFd);
+    listenFd = -1;
+    unlink(ENGINE_SOCKET_PATH);
+}
+
+#else /* !__linux__ */
+
+int startCommandSocket() { return 0; }
+unsigned int waitForEngineEvents(int timeoutMs) { (void)timeoutMs; return 0; }
+void stopCommandSocket() {}
+
+#endif /* __linux__ */
+
+/* ==================== TICKLESS EVENT LOOP ==================== */
+
+time_t lastMetricsExport = 0;
+
+void exportMetrics(time_t now) {
+    int depth = isEmpty() ? 0 : queuePosition(rear);
+    writeMetricsFile(depth, priorityCounts, __atomic_load_n(&logDropped, __ATOMIC_RELAXED));
+    if (traceFile) fflush(traceFile);
+    lastMetricsExport = now;
+}
+
+/*
+ * DESIGN DECISION: One blocking wait instead of sleep-and-poll
+ * The old loop woke every 500ms to poll three files and rescan the queue
+ * even when nothing happened. Now a single epoll_wait covers:
+ *   - the engine socket (requests served inline)
+ *   - inotify on the working directory (pending tickets, admin commands,
+ *     external appends to the active database)
+ *   - signalfd for SIGINT/SIGTERM
+ * and its timeout is the next moment a ticket crosses an escalation
+ * threshold (or the dashboard's wait-time column goes stale).
+ * An idle engine therefore sleeps until there is actual work.
+ */
+
+/*
+ * Earliest future time at which escalateOldTickets() could change anything.
+ * Thresholds are ESCALATION_CYCLE_HOURS multiples up to SAFETY_NET_HOURS.
+ * Returns 0 if no ticket can escalate any more.
+ */
+time_t nextEscalationDeadline(const struct QueueView *v, time_t now) {
+    time_t deadline = 0;
+    for (int n = 0; n < v->count; n++) {
+        const struct QueuedTicket *t = &v->rows[n].t;
+        if (t->priority == PRIORITY_CRITICAL) continue;
+        for (int h = ESCALATION_CYCLE_HOURS; h <= SAFETY_NET_HOURS; h += ESCALATION_CYCLE_HOURS) {
+            time_t due = t->queueEntryTime + (time_t)h * 3600;
+            if (due > now) {
+                if (deadline == 0 || due < deadline) deadline = due;
+                break;
+            }
+        }
+    }
+    return deadline;
+}
+
+// Size + mtime of the active database after the engine's own last write
+struct stat databaseStamp;
+
+void rememberDatabaseStamp() {
+    if (stat(PENDING_TICKETS_FILE, &databaseStamp) != 0) {
+        memset(&databaseStamp, 0, sizeof(databaseStamp));
+    }
+}
+
+// True if someone else (e.g. data_generator) changed the active database
+int databaseChangedExternally() {
+    struct stat st;
+    if (stat(PENDING_TICKETS_FILE, &st) != 0) return 0;
+    if (st.st_size != databaseStamp.st_size || st.st_mtime != databaseStamp.st_mtime) return 1;
+#ifdef __linux__
+    return st.st_ino != databaseStamp.st_ino ||
+           st.st_mtim.tv_nsec != databaseStamp.st_mtim.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+#ifdef __linux__
+
+unsigned int drainFileEvents() {
+    // Buffer aligned for struct inotify_event, as inotify(7) recommends
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    unsigned int fired = 0;
+
+    while (1) {
+        ssize_t len = read(inotifyFd, buf, sizeof(buf));
+        if (len <= 0) break;  // EAGAIN: drained
+
+        for (char *p = buf; p < buf + len; ) {
+            struct inotify_event *ev = (struct inotify_event *)p;
+            if (ev->mask & IN_Q_OVERFLOW) {
+                // Lost events - check everything
+                fired |= ENGINE_EVENT_PENDING | ENGINE_EVENT_ADMIN | ENGINE_EVENT_DATABASE;
+            } else if (ev->wd == spoolWatch) {
+                fired |= ENGINE_EVENT_PENDING;   // A batch was published
+            } else if (ev->len > 0) {
+                if (strcmp(ev->name, LEGACY_PENDING_FILE) == 0) fired |= ENGINE_EVENT_PENDING;
+                else if (strcmp(ev->name, ADMIN_COMMANDS_FILE) == 0) fired |= ENGINE_EVENT_ADMIN;
+                else if (strcmp(ev->name, PENDING_TICKETS_FILE) == 0) fired |= ENGINE_EVENT_DATABASE;
+            }
+            p += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+    return fired;
+}
+
+unsigned int drainSignalEvents() {
+    struct signalfd_siginfo info;
+    unsigned int fired = 0;
+
+    while (read(signalFd, &info, sizeof(info)) == (ssize_t)sizeof(info)) {
+        if (info.ssi_signo == SIGINT || info.ssi_signo == SIGTERM) {
+            printf("\n\n");
+            printf("  Shutdown signal received - cleaning up...  \n");
+            running = 0;
+            fired |= ENGINE_EVENT_SHUTDOWN;
+        }
+    }
+    return fired;
+}
+
+int addEpollSource(int fd, unsigned int tag) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = tag;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+/*
+ * Sets up inotify + signalfd on the shared epoll instance.
+ * Returns 0 (and leaves signal handling untouched) if any piece is missing,
+ * in which case main() falls back to the polling loop.
+ */
+int startEventSources() {
+    if (epollFd < 0) epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) return 0;
+
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0 ||
+        inotify_add_watch(inotifyFd, ".", IN_CLOSE_WRITE | IN_MOVED_TO) < 0 ||
+        (spoolWatch = inotify_add_watch(inotifyFd, SPOOL_NEW_DIR, IN_MOVED_TO)) < 0 ||
+        !addEpollSource(inotifyFd, INOTIFY_TAG)) {
+        logError("Cannot watch working directory with inotify - using polling loop");
+        if (inotifyFd >= 0) close(inotifyFd);
+        inotifyFd = -1;
+        return 0;
+    }
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, NULL);
+    signalFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signalFd < 0 || !addEpollSource(signalFd, SIGNALFD_TAG)) {
+        logError("Cannot create signalfd - using polling loop");
+        sigprocmask(SIG_UNBLOCK, &mask, NULL);
+        if (signalFd >= 0) close(signalFd);
+        signalFd = -1;
+        close(inotifyFd);
+        inotifyFd = -1;
+        return 0;
+    }
+
+    if (!startEngineThreads()) {
+        logError("Cannot start renderer/timer threads - using polling loop");
+        sigprocmask(SIG_UNBLOCK, &mask, NULL);
+        close(signalFd);
+        close(inotifyFd);
+        signalFd = inotifyFd = -1;
+        return 0;
+    }
+
+    rememberDatabaseStamp();
+    return 1;
+}
+
+void stopEventSources() {
+    stopEngineThreads();
+    if (inotifyFd >= 0) close(inotifyFd);
+    if (signalFd >= 0) close(signalFd);
+    if (epollFd >= 0) close(epollFd);
+    inotifyFd = signalFd = epollFd = -1;
+}
+
+// Milliseconds until `deadline` (0 = none), folded into the current timeout
+int foldTimeout(int timeoutMs, time_t deadline, time_t now) {
+    if (deadline == 0) return timeoutMs;
+    long long ms = (deadline > now) ? (long long)(deadline - now) * 1000 : 0;
+    if (ms > 24LL * 3600 * 1000) ms = 24LL * 3600 * 1000;  // Re-check at least daily
+    if (timeoutMs < 0 || ms < timeoutMs) return (int)ms;
+    return timeoutMs;
+}
+
+/* ==================== ENGINE THREADS ==================== */
+
+/*
+ * DESIGN DECISION: One owner thread, readers on immutable views
+ * The event loop thread owns the queue and is the only thread that
+ * mutates it: ingestion, admin commands, resolves and escalation all
+ * run there. After a change it publishes a fresh QueueView (RCU style:
+ * swap the pointer, readers keep the version they hold, the last
+ * reference frees it). Building a view copies the queue, so a burst of
+ * changes is published at most every VIEW_PUBLISH_INTERVAL_MS and only
+ * once the renderer has taken the previous view. Escalation runs when
+ * the timer says a threshold passed, not on every wake. Two threads
+ * read the views:
+ *   - the renderer writes the dashboard and the status line, and
+ *     re-renders every DASHBOARD_REFRESH_SECONDS so wait times move
+ *   - the timer scans for the next escalation threshold and wakes the
+ *     owner through an eventfd when it passes
+ * A slow dashboard therefore never delays a submit or a resolve, and
+ * the owner no longer rescans the queue for deadlines on every wake.
+ */
+
+pthread_mutex_t viewLock = PTHREAD_MUTEX_INITIALIZER;   // currentView + generation
+pthread_cond_t viewChanged = PTHREAD_COND_INITIALIZER;
+struct QueueView *currentView = NULL;
+unsigned long viewGeneration = 0;       // Bumped on every publish
+unsigned long consumedGeneration = 0;   // Last generation the renderer took
+int engineThreadsRunning = 0;
+int timerEventFd = -1;
+pthread_t rendererThread, timerThread;
+
+// Owner thread: swaps in a view of the current queue and wakes the readers
+void publishQueueView() {
+    struct QueueView *v = buildQueueView();
+    if (!v) {
+        logError("Out of memory building queue view");
+        return;
+    }
+    pthread_mutex_lock(&viewLock);
+    struct QueueView *old = currentView;
+    currentView = v;
+    viewGeneration++;
+    pthread_cond_broadcast(&viewChanged);
+    pthread_mutex_unlock(&viewLock);
+
+    releaseQueueView(old);
+    dashboardDirty = 0;
+}
+
+// Takes a reference to the current view (viewLock held)
+struct QueueView *acquireQueueViewLocked(unsigned long *generation) {
+    struct QueueView *v = currentView;
+    if (v) retainQueueView(v);
+    *generation = viewGeneration;
+    return v;
+}
+
+// Waits on viewChanged until `deadline` (wall clock, 0 = no limit); viewLock held
+int waitForView(time_t deadline) {
+    if (deadline == 0) return pthread_cond_wait(&viewChanged, &viewLock);
+    struct timespec until = {deadline, 0};
+    return pthread_cond_timedwait(&viewChanged, &viewLock, &until);
+}
+
+void *rendererMain(void *arg) {
+    (void)arg;
+    unsigned long rendered = 0;
+    time_t lastStatus = 0;
+
+    pthread_mutex_lock(&viewLock);
+    while (engineThreadsRunning) {
+        if (viewGeneration == rendered) {
+            int rc = waitForView(time(NULL) + DASHBOARD_REFRESH_SECONDS);
+            if (!engineThreadsRunning) break;
+            // Nothing new: re-render only to refresh the Wait Time column
+            if (viewGeneration == rendered &&
+                (rc != ETIMEDOUT || !currentView || currentView->count == 0)) continue;
+        }
+
+        unsigned long generation;
+        struct QueueView *v = acquireQueueViewLocked(&generation);
+        __atomic_store_n(&consumedGeneration, generation, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&viewLock);
+
+        if (v) {
+            renderDashboard(v);
+
+            time_t now = time(NULL);
+            if (generation != rendered && now - lastStatus >= STATS_DISPLAY_SECONDS) {
+                double avgWait = 0.0;
+                int oldestHours = 0;
+                getViewStats(v, now, &avgWait, &oldestHours);
+                printf("[Status] Tickets: %d | Avg Wait: %.1fh | Oldest: %dh | Critical: %d High: %d Med: %d Low: %d\n",
+                       v->count, avgWait, oldestHours,
+                       v->priorities[0], v->priorities[1], v->priorities[2], v->priorities[3]);
+                printWaitSummary(v->waitByPriority);
+                lastStatus = now;
+            }
+            releaseQueueView(v);
+        }
+        rendered = generation;
+        pthread_mutex_lock(&viewLock);
+    }
+    pthread_mutex_unlock(&viewLock);
+    return NULL;
 }
 
-/* ==================== TICKET RESOLUTION ==================== */
+void *timerMain(void *arg) {
+    (void)arg;
 
-void archiveAndRemove(int id, const char *admin_username) {
-    FILE *src = fopen("customer_support_tickets_updated.csv", "r");
-    if (!src) {
-        logError("Cannot open customer_support_tickets_updated.csv for archiving");
-        return;
-    }
-    
-    FILE *tmp = fopen("temp.csv", "w");
-    if (!tmp) {
-        logError("Cannot create temp.csv");
-        fclose(src);
-        return;
-    }
-    
-    FILE *arc = fopen("resolved_tickets.csv", "a");
+    pthread_mutex_lock(&viewLock);
+    while (engineThreadsRunning) {
+        unsigned long generation;
+        struct QueueView *v = acquireQueueViewLocked(&generation);
+        pthread_mutex_unlock(&viewLock);
 
-    // Check if resolved_tickets.csv exists, if not create with header
-    if (!arc) {
-        arc = fopen("resolved_tickets.csv", "w");
-        fprintf(arc, "Ticket ID,Customer Name,Customer Email,Product,Purchase Date,Issue Description,Priority,Queue Entry Time,Resolved At,Resolved By\n");
-        fclose(arc);
-        arc = fopen("resolved_tickets.csv", "a");
-    }
+        // The O(n) deadline scan runs here, not on the owner thread
+        time_t deadline = v ? nextEscalationDeadline(v, time(NULL)) : 0;
+        releaseQueueView(v);
 
-    char line[1024];
-    fgets(line, sizeof(line), src);
-    fprintf(tmp, "%s", line); // Copy header
+        pthread_mutex_lock(&viewLock);
+        if (!engineThreadsRunning) break;
+        if (viewGeneration != generation) continue;   // Newer view arrived meanwhile
 
-    int found = 0;
-    while (fgets(line, sizeof(line), src)) {
-        char copy[1024];
-        strncpy(copy, line, 1023);  //  Safe
-        copy[1023] = '\0';           //  Null terminate
-        
-        // Parse ticket ID - handle quoted fields
-        char *tok = strtok(copy, ",");
-        if (tok) {
-            // Remove quotes if present
-            if (tok[0] == '"') tok++;
-            int curr = atoi(tok);
-
-            if (curr == id) {
-                // Found the ticket to resolve
-                char timeBuf[50];
-                getSystemTime(timeBuf);
-                removeNewline(line);
-                
-                // Append resolved timestamp AND admin username
-                fprintf(arc, "%s,%s,%s\n", line, timeBuf, admin_username);
-                found = 1;
-            } else {
-                fprintf(tmp, "%s", line);
-            }
-        } else {
-            fprintf(tmp, "%s", line);
+        if (waitForView(deadline) == ETIMEDOUT && viewGeneration == generation) {
+            uint64_t one = 1;
+            if (write(timerEventFd, &one, sizeof(one)) < 0) logError("Cannot signal escalation timer");
         }
     }
+    pthread_mutex_unlock(&viewLock);
+    return NULL;
+}
 
-    fclose(src); fclose(tmp); fclose(arc);
-    
-    if (found) {
-        remove("customer_support_tickets_updated.csv");
-        rename("temp.csv", "customer_support_tickets_updated.csv");
-    } else {
-        remove("temp.csv");
+unsigned int drainTimerEvents() {
+    uint64_t count;
+    return read(timerEventFd, &count, sizeof(count)) == (ssize_t)sizeof(count) ? ENGINE_EVENT_TIMER : 0;
+}
+
+/*
+ * Publishes the first view and starts the renderer and timer threads.
+ * Returns 0 (nothing left running) if any piece fails.
+ */
+int startEngineThreads() {
+    timerEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (timerEventFd < 0 || !addEpollSource(timerEventFd, TIMER_TAG)) {
+        if (timerEventFd >= 0) close(timerEventFd);
+        timerEventFd = -1;
+        return 0;
+    }
+    publishQueueView();
+
+    // Like the logger, the readers never take SIGINT/SIGTERM
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &previous);
+
+    engineThreadsRunning = 1;
+    int rendererOk = pthread_create(&rendererThread, NULL, rendererMain, NULL) == 0;
+    int timerOk = rendererOk && pthread_create(&timerThread, NULL, timerMain, NULL) == 0;
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+    if (!timerOk) {
+        pthread_mutex_lock(&viewLock);
+        engineThreadsRunning = 0;
+        pthread_cond_broadcast(&viewChanged);
+        pthread_mutex_unlock(&viewLock);
+        if (rendererOk) pthread_join(rendererThread, NULL);
+        close(timerEventFd);
+        timerEventFd = -1;
+        return 0;
     }
+    return 1;
 }
 
-void resolveNextTicket(const char *admin_username) {
-    struct Ticket t;
-    if (!dequeue(&t)) return;
-    archiveAndRemove(t.ticketID, admin_username);
-    loadFromFile();
-    generateAdminHTML();
+void stopEngineThreads() {
+    if (!engineThreadsRunning) return;
+    pthread_mutex_lock(&viewLock);
+    engineThreadsRunning = 0;
+    pthread_cond_broadcast(&viewChanged);
+    pthread_mutex_unlock(&viewLock);
+
+    pthread_join(rendererThread, NULL);
+    pthread_join(timerThread, NULL);
+    close(timerEventFd);
+    timerEventFd = -1;
+
+    releaseQueueView(currentView);
+    currentView = NULL;
 }
 
-/* ==================== PENDING TICKET PROCESSING ==================== */
+/*
+ * Owner thread: a view is due once the renderer has taken the last one
+ * and VIEW_PUBLISH_INTERVAL_MS has passed. Returns 0 if it is due now,
+ * else the milliseconds to wait before checking again.
+ */
+int viewPublishDelay(uint64_t lastPublishNs) {
+    uint64_t dueNs = lastPublishNs + (uint64_t)VIEW_PUBLISH_INTERVAL_MS * 1000000ULL;
+    uint64_t nowNs = metricsNow();
+    if (nowNs < dueNs) return (int)((dueNs - nowNs + 999999ULL) / 1000000ULL);
+    if (__atomic_load_n(&consumedGeneration, __ATOMIC_ACQUIRE) != viewGeneration) {
+        return VIEW_PUBLISH_INTERVAL_MS;   // Renderer still busy with an older view
+    }
+    return 0;
+}
 
-void processPendingTickets() {
-    FILE *pf = fopen("pending_tickets.csv", "r");
-    if (!pf) return;
+// Brings the dashboard up to date: the event loop publishes the change
+// to the renderer (rate-limited) before it next sleeps
+void refreshDashboard() {
+    if (engineThreadsRunning) {
+        markDashboardDirty();
+    } else {
+        generateAdminHTML();
+    }
+}
 
-    FILE *db = fopen("customer_support_tickets_updated.csv", "a");
-    FILE *duplicates = fopen("duplicate_tickets.log", "a");
-    
-    char line[1024];
-    time_t entryTime = time(NULL);
+void runEventLoop() {
+    // Pick up anything that arrived while the engine was down, and apply
+    // escalations that came due meanwhile
+    unsigned int fired = ENGINE_EVENT_PENDING | ENGINE_EVENT_ADMIN | ENGINE_EVENT_TIMER;
 
-    while (fgets(line, sizeof(line), pf)) {
-        struct Ticket t;
-        removeNewline(line);
+    // Set by real input only, so exporting never schedules another wake-up
+    int metricsPending = 0;
+    unsigned long publishedVersion = queueVersion;
+    uint64_t lastPublishNs = 0;
 
-        // Simple CSV parser that handles quoted fields
-        char *fields[6];
-        int fieldIndex = 0;
-        char *ptr = line;
-        char fieldBuffer[512];
-        int bufferIndex = 0;
-        int inQuotes = 0;
-
-        while (*ptr && fieldIndex < 6) {
-            if (*ptr == '"') {
-                inQuotes = !inQuotes;
-                ptr++;
-                continue;
-            }
-            
-            if (*ptr == ',' && !inQuotes) {
-                fieldBuffer[bufferIndex] = '\0';
-                fields[fieldIndex] = strdup(fieldBuffer);
-                fieldIndex++;
-                bufferIndex = 0;
-                ptr++;
-                continue;
-            }
-            
-            if (bufferIndex < 511) fieldBuffer[bufferIndex++] = *ptr;
-            ptr++;
-        }
-        
-        // Last field
-        fieldBuffer[bufferIndex] = '\0';
-        fields[fieldIndex] = strdup(fieldBuffer);
-        fieldIndex++;
-
-        if (fieldIndex < 6) {
-            for (int i = 0; i < fieldIndex; i++) {
-                free(fields[i]);
+    while (running) {
+        uint64_t cycleStartNs = metricsNow();
+        if (fired) metricsPending = 1;
+
+        if (fired & ENGINE_EVENT_DATABASE) {
+            if (databaseChangedExternally()) {
+                loadFromFile();
+                markDashboardDirty();
+                fired |= ENGINE_EVENT_TIMER;   // Reloaded tickets may be overdue
             }
-            continue;
         }
+        if (fired & ENGINE_EVENT_PENDING) processPendingTickets();
+        if (fired & ENGINE_EVENT_ADMIN) checkAdminCommands();
+        if (fired & ENGINE_EVENT_TIMER) escalateOldTickets();
 
-        t.ticketID = atoi(fields[0]);
-        strncpy(t.customerName, fields[1], 99);
-        t.customerName[99] = '\0';
-        strncpy(t.email, fields[2], 99);
-        t.email[99] = '\0';
-        strncpy(t.product, fields[3], 99);
-        t.product[99] = '\0';
-        strncpy(t.purchaseDate, fields[4], 49);
-        t.purchaseDate[49] = '\0';
-        strncpy(t.issueDescription, fields[5], 199);
-        t.issueDescription[199] = '\0';
-
-        // DUPLICATE DETECTION
-        int existingTicketID = isDuplicateInQueue(t.email, t.issueDescription);
-        
-        if (existingTicketID > 0) {
-            // Log duplicate and skip
-            char timeBuf[50];
-            getSystemTime(timeBuf);
-            fprintf(duplicates, "[%s] Duplicate rejected: Ticket #%d (similar to #%d) - %s - %s\n",
-                    timeBuf, t.ticketID, existingTicketID, t.email, t.issueDescription);
-            
-            for (int i = 0; i < fieldIndex; i++) {
-                free(fields[i]);
+        // Renderer and timer pick up the change from here. Under a burst
+        // of requests the view copy runs at most once per interval.
+        int publishDelayMs = -1;
+        if (dashboardDirty || queueVersion != publishedVersion) {
+            publishDelayMs = viewPublishDelay(lastPublishNs);
+            if (publishDelayMs == 0) {
+                publishQueueView();
+                publishedVersion = queueVersion;
+                lastPublishNs = metricsNow();
+                publishDelayMs = -1;
             }
-            continue; // Skip this duplicate ticket
         }
 
-        // If not duplicate, process normally
-        strncpy(t.priority, getAutoPriority(t.issueDescription), 19);
-        t.priority[19] = '\0';
-        t.queueEntryTime = entryTime;
-
-        enqueue(t);
+        publishQueueSnapshot();
 
-        // Write to CSV with simplified structure
-        fprintf(db, "%d,\"%s\",\"%s\",\"%s\",\"%s\",\"%s\",%s,%ld\n",
-            t.ticketID, t.customerName, t.email,
-            t.product, t.purchaseDate,
-            t.issueDescription, t.priority, (long)entryTime);
+        // Everything the engine wrote to the database this round is its own
+        rememberDatabaseStamp();
+        maybeCompactDatabase();
+        expireArchivePartitions();
+        recordStageLatency(STAGE_CYCLE, cycleStartNs);
 
-        // Free allocated strings
-        for (int i = 0; i < fieldIndex; i++) {
-            free(fields[i]);
+        time_t now = time(NULL);
+        if (metricsPending && now - lastMetricsExport >= METRICS_EXPORT_SECONDS) {
+            exportMetrics(now);
+            metricsPending = 0;
         }
+
+        // Escalation deadlines and dashboard refreshes belong to the threads
+        int timeoutMs = publishDelayMs;
+        if (metricsPending) timeoutMs = foldTimeout(timeoutMs, lastMetricsExport + METRICS_EXPORT_SECONDS, now);
+
+        fired = waitForEngineEvents(timeoutMs);
     }
+}
 
-    fclose(pf);
-    fclose(db);
-    fclose(duplicates);
+#else /* !__linux__ */
 
-    // Clear pending tickets (they're now in active queue)
-    pf = fopen("pending_tickets.csv", "w");
-    fclose(pf);
+int startEventSources() { return 0; }
+void stopEventSources() {}
+void runEventLoop() {}
+void refreshDashboard() { generateAdminHTML(); }
 
-    loadFromFile();
-}
+#endif /* __linux__ */
 
-/* ==================== ADMIN COMMANDS ==================== */
+/* ==================== CLEANUP AND STATE PERSISTENCE ==================== */
 
-void checkAdminCommands() {
-    FILE *cmd = fopen("admin_commands.txt", "r");
-    if (!cmd) return;
+// The queue, front to rear, with its own copy of the text arena
+struct QueueCopy {
+    struct QueuedTicket *records;
+    char *text;
+    struct DatabaseMap *map;   // Cold rows' database mapping, or NULL
+    int count;
+};
 
-    char line[256];
-    if (fgets(line, sizeof(line), cmd)) {
-        int id;
-        char admin_username[100] = "admin";  // fallback default
-        
-        // Parse: "RESOLVE <id> <admin_username>"
-        if (sscanf(line, "RESOLVE %d %99s", &id, admin_username) >= 1) {
-            resolveNextTicket(admin_username);
+/*
+ * Writes a complete active database (header + one row per copied
+ * ticket) to `path` and fsyncs it. Returns 1 on success.
+ */
+int writeTicketFile(const char *path, const struct QueueCopy *copy) {
+    FILE *f = fopen(path, "w");
+    if (!f) return 0;
+
+    fprintf(f, "Ticket ID,Customer Name,Customer Email,Product,Purchase Date,Issue Description,Priority,Queue Entry Time\n");
+    char row[TICKET_RECORD_MAX];
+    struct Ticket t;
+    for (int i = 0; i < copy->count; i++) {
+        if (!expandTicketFrom(copy->text, copy->map, &copy->records[i], &t)) {
+            logEvent(LOG_ERROR, "ERROR: Cannot read ticket #%d from the active database - not rewriting it",
+                     copy->records[i].ticketID);
+            fclose(f);
+            return 0;
         }
+        int len = formatTicketRecord(row, sizeof(row), &t);
+        fwrite(row, 1, (size_t)len, f);
     }
+    int ok = syncDatabase(f);
+    if (fclose(f) != 0) ok = 0;
+    return ok;
+}
 
-    fclose(cmd);
-    // Clear command file
-    cmd = fopen("admin_commands.txt", "w");
-    fclose(cmd);
+void freeQueueCopy(struct QueueCopy *copy) {
+    free(copy->records);
+    free(copy->text);
+    releaseDatabaseMap(copy->map);
+    copy->records = NULL;
+    copy->text = NULL;
+    copy->map = NULL;
+    copy->count = 0;
 }
 
-/* ==================== CLEANUP AND STATE PERSISTENCE ==================== */
+// Copies the queue records and the arena; returns 0 if out of memory
+int snapshotQueue(struct QueueCopy *copy) {
+    copy->count = isEmpty() ? 0 : (rear - front + MAX) % MAX + 1;
+    copy->records = malloc((size_t)(copy->count ? copy->count : 1) * sizeof(struct QueuedTicket));
+    copy->text = malloc(textArenaSize ? textArenaSize : 1);
+    copy->map = NULL;
+    if (!copy->records || !copy->text) {
+        freeQueueCopy(copy);
+        return 0;
+    }
+    for (int i = 0; i < copy->count; i++) copy->records[i] = queue[(front + i) % MAX];
+    if (textArenaSize > 0) memcpy(copy->text, textArena, textArenaSize);
+    copy->map = holdColdRows();
+    return 1;
+}
+
+// rename() that replaces `to` on every platform
+int replaceFile(const char *from, const char *to) {
+#ifdef _WIN32
+    remove(to);
+#endif
+    return rename(from, to) == 0;
+}
+
+int databaseRewrites = 0;   // Bumped by every full rewrite (invalidates running compactions)
 
 void saveQueueToFile() {
     /*
      * Saves current queue state to CSV file.
-     * Called during graceful shutdown to preserve data.
+     * Called during graceful shutdown to preserve data, and when a log
+     * cannot be appended to. Written to a temp file and swapped in, so a
+     * crash mid-write leaves the old database intact. A background
+     * compaction writes the same temp file: it is stopped and dropped
+     * first (this rewrite supersedes it anyway).
      */
-    FILE *f = fopen(PENDING_TICKETS_FILE, "w");
-    if (!f) {
-        logError("Cannot save queue state during shutdown");
+    abandonCompaction();
+
+    struct QueueCopy copy;
+    if (!snapshotQueue(&copy) || !writeTicketFile(DATABASE_COMPACT_TMP, &copy) ||
+        !replaceFile(DATABASE_COMPACT_TMP, PENDING_TICKETS_FILE)) {
+        logError("Cannot save queue state to the active database");
+        freeQueueCopy(&copy);
         return;
     }
-    
-    fprintf(f, "Ticket ID,Customer Name,Customer Email,Product,Purchase Date,Issue Description,Priority,Queue Entry Time\n");
-    
-    if (!isEmpty()) {
-        int i = front;
-        while (1) {
-            fprintf(f, "%d,\"%s\",\"%s\",\"%s\",%s,\"%s\",%s,%ld\n",
-                    queue[i].ticketID,
-                    queue[i].customerName,
-                    queue[i].email,
-                    queue[i].product,
-                    queue[i].purchaseDate,
-                    queue[i].issueDescription,
-                    queue[i].priority,
-                    (long)queue[i].queueEntryTime);
-            
-            if (i == rear) break;
-            i = (i + 1) % MAX;
+    relocateColdRows(copy.map);
+    freeQueueCopy(&copy);
+    databaseRewrites++;
+
+    // Every logged priority change and removal is now in the CSV itself
+    remove(PRIORITY_LOG_FILE);
+    priorityLogRecords = 0;
+    remove(REMOVAL_LOG_FILE);
+    removalLogRecords = 0;
+    releaseOverflowState();
+}
+
+/* ==================== BACKGROUND COMPACTION ==================== */
+
+/*
+ * DESIGN DECISION: Background compaction with an atomic swap
+ * Resolves and priority changes only append (tombstones in
+ * REMOVAL_LOG_FILE, changes in PRIORITY_LOG_FILE), so the active CSV
+ * accumulates dead rows. Once they pass COMPACT_DEAD_PERCENT of the file
+ * (or the priority log grows past PRIORITY_LOG_COMPACT_RECORDS), the
+ * engine copies the queue and notes how long the database and both logs
+ * are. A worker thread writes the copy to DATABASE_COMPACT_TMP. Back on
+ * the engine thread, rows appended since the snapshot are copied over,
+ * the file is renamed over the database, and each log keeps only its
+ * records written after the snapshot. The engine never waits on the
+ * rewrite; only the tail copy happens inline.
+ */
+
+struct CompactionJob {
+    struct QueueCopy snapshot;
+    long databaseSize;          // File lengths when the snapshot was taken
+    long removalLogSize;
+    long priorityLogSize;
+    int rewrites;               // databaseRewrites at snapshot time
+    int state;                  // COMPACTION_* (atomic while the worker runs)
+    int threaded;               // Written by `thread` (else inline)
+#ifndef _WIN32
+    pthread_t thread;
+#endif
+};
+
+enum { COMPACTION_IDLE, COMPACTION_WRITING, COMPACTION_WRITTEN, COMPACTION_FAILED };
+
+struct CompactionJob compactionJob;   // Zeroed: COMPACTION_IDLE
+
+long fileLength(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : 0;
+}
+
+// Appends bytes [offset, end) of `path` to `out`; returns lines copied, or -1
+int copyFileTail(const char *path, long offset, FILE *out) {
+    FILE *in = fopen(path, "r");
+    if (!in) return 0;
+    fseek(in, offset, SEEK_SET);
+
+    char buf[8192];
+    size_t n;
+    int lines = 0;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        for (size_t i = 0; i < n; i++) lines += buf[i] == '\n';
+        if (fwrite(buf, 1, n, out) != n) {
+            lines = -1;
+            break;
         }
     }
-    
-    fclose(f);
+    fclose(in);
+    return lines;
+}
+
+// Keeps only the records appended to log `path` after `offset`; returns their count
+int trimLogBefore(const char *path, long offset) {
+    if (fileLength(path) <= offset) {
+        remove(path);
+        return 0;
+    }
+    char tmp[300];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *out = fopen(tmp, "w");
+    if (!out) return -1;
+    int lines = copyFileTail(path, offset, out);
+    if (fclose(out) != 0 || lines < 0 || !replaceFile(tmp, path)) {
+        remove(tmp);
+        return -1;
+    }
+    return lines;
+}
+
+void *compactionMain(void *arg) {
+    struct CompactionJob *job = arg;
+    int ok = writeTicketFile(DATABASE_COMPACT_TMP, &job->snapshot);
+    __atomic_store_n(&job->state, ok ? COMPACTION_WRITTEN : COMPACTION_FAILED, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+void startCompaction() {
+    if (!snapshotQueue(&compactionJob.snapshot)) return;
+
+    compactionJob.databaseSize = fileLength(PENDING_TICKETS_FILE);
+    compactionJob.removalLogSize = fileLength(REMOVAL_LOG_FILE);
+    compactionJob.priorityLogSize = fileLength(PRIORITY_LOG_FILE);
+    compactionJob.rewrites = databaseRewrites;
+    compactionJob.state = COMPACTION_WRITING;
+    compactionJob.threaded = 0;
+
+#ifndef _WIN32
+    if (pthread_create(&compactionJob.thread, NULL, compactionMain, &compactionJob) == 0) {
+        compactionJob.threaded = 1;
+        return;
+    }
+#endif
+    compactionMain(&compactionJob);   // No worker thread: write inline
+}
+
+// Joins a finished worker; returns the job state it ended in
+int reapCompaction(int wait) {
+    int state = __atomic_load_n(&compactionJob.state, __ATOMIC_ACQUIRE);
+    if (state == COMPACTION_IDLE || (state == COMPACTION_WRITING && !wait)) return state;
+#ifndef _WIN32
+    if (compactionJob.threaded) pthread_join(compactionJob.thread, NULL);
+    compactionJob.threaded = 0;
+#endif
+    freeQueueCopy(&compactionJob.snapshot);
+    return __atomic_load_n(&compactionJob.state, __ATOMIC_ACQUIRE);
+}
+
+// Swaps a written snapshot in, carrying over everything appended since
+void finishCompaction() {
+    if (compactionJob.rewrites != databaseRewrites) {
+        remove(DATABASE_COMPACT_TMP);   // Superseded by a full rewrite
+        compactionJob.state = COMPACTION_IDLE;
+        return;
+    }
+    if (databaseChangedExternally()) return;   // Reload first; retried next cycle
+
+    FILE *out = fopen(DATABASE_COMPACT_TMP, "a");
+    int ok = out && copyFileTail(PENDING_TICKETS_FILE, compactionJob.databaseSize, out) >= 0 &&
+             syncDatabase(out);
+    if (out && fclose(out) != 0) ok = 0;
+    struct DatabaseMap *old = ok ? holdColdRows() : NULL;
+    if (!ok || !replaceFile(DATABASE_COMPACT_TMP, PENDING_TICKETS_FILE)) {
+        logError("Cannot swap in compacted database - keeping the current one");
+        remove(DATABASE_COMPACT_TMP);
+        releaseDatabaseMap(old);
+        compactionJob.state = COMPACTION_IDLE;
+        return;
+    }
+    rememberDatabaseStamp();
+    relocateColdRows(old);
+    releaseDatabaseMap(old);
+
+    // Tombstones and priority changes from before the snapshot are in the new file
+    int removals = trimLogBefore(REMOVAL_LOG_FILE, compactionJob.removalLogSize);
+    int priorities = trimLogBefore(PRIORITY_LOG_FILE, compactionJob.priorityLogSize);
+    if (removals >= 0) removalLogRecords = removals;
+    if (priorities >= 0) priorityLogRecords = priorities;
+    compactionJob.state = COMPACTION_IDLE;
+}
+
+// Called once per engine cycle: finishes a written compaction or starts one
+void maybeCompactDatabase() {
+    int state = reapCompaction(0);
+    if (state == COMPACTION_WRITING) return;
+    if (state == COMPACTION_WRITTEN) {
+        finishCompaction();
+        return;
+    }
+    if (state == COMPACTION_FAILED) {
+        logError("Background compaction failed - will retry");
+        remove(DATABASE_COMPACT_TMP);
+        compactionJob.state = COMPACTION_IDLE;
+        return;
+    }
+
+    // A rewrite holds only the queue, so never compact over overflow rows
+    if (databaseOverflowRows > 0) return;
+
+    int live = isEmpty() ? 0 : (rear - front + MAX) % MAX + 1;
+    int dead = removalLogRecords;
+    int deadRatioReached = dead >= COMPACT_MIN_DEAD_ROWS &&
+                           (long)dead * 100 >= (long)COMPACT_DEAD_PERCENT * (dead + live);
+    if (deadRatioReached || priorityLogRecords >= PRIORITY_LOG_COMPACT_RECORDS) startCompaction();
+}
+
+// Full rewrite or shutdown: let a running worker finish and drop its result
+void abandonCompaction() {
+    reapCompaction(1);
+    remove(DATABASE_COMPACT_TMP);
+    compactionJob.state = COMPACTION_IDLE;
 }
 
 void cleanup() {
@@ -1225,8 +6451,93 @@ void cleanup() {
 
 /* ==================== MAIN LOOP ==================== */
 
+// Fallback for platforms without inotify/signalfd: fixed-interval polling
+void runPollingLoop(int socketActive) {
+    rememberDatabaseStamp();
+
+    int cycles = 0;
+    while (running) {  // Changed from while(1) to while(running)
+        uint64_t cycleStartNs = metricsNow();
+        
+        // Pick up rows appended to the database by other tools
+        if (databaseChangedExternally()) loadFromFile();
+        
+        processPendingTickets();
+        escalateOldTickets();
+        checkAdminCommands();
+        
+        // Regenerate HTML every N cycles (configurable)
+        // This reduces file I/O and race conditions while still being responsive
+        if (cycles % HTML_GENERATION_CYCLES == 0) {
+            generateAdminHTML();
+        }
+        
+        cycles++;
+        
+        // Display statistics periodically
+        if (cycles % STATS_DISPLAY_CYCLES == 0) {
+            int total = 0, oldestHours = 0;
+            double avgWait = 0.0;
+            int priorities[4] = {0, 0, 0, 0};
+            getQueueStats(&total, &avgWait, &oldestHours, priorities);
+            
+            printf("[Status] Tickets: %d | Avg Wait: %.1fh | Oldest: %dh | Critical: %d High: %d Med: %d Low: %d\n",
+                   total, avgWait, oldestHours, priorities[0], priorities[1], priorities[2], priorities[3]);
+            struct WaitQuantiles waits[4];
+            getWaitQuantiles(waits, NULL, 0);
+            printWaitSummary(waits);
+        }
+        
+        publishQueueSnapshot();
+        rememberDatabaseStamp();
+        maybeCompactDatabase();
+        expireArchivePartitions();
+        recordStageLatency(STAGE_CYCLE, cycleStartNs);
+        
+        time_t now = time(NULL);
+        if (now - lastMetricsExport >= METRICS_EXPORT_SECONDS) exportMetrics(now);
+        
+        // Sleep using configured interval (serving socket requests meanwhile)
+        if (socketActive) {
+            waitForEngineEvents(SLEEP_MILLISECONDS);
+        } else {
+        #ifdef _WIN32
+            Sleep(SLEEP_MILLISECONDS);
+        #else
+            usleep(SLEEP_MILLISECONDS * 1000);  // Convert milliseconds to microseconds
+        #endif
+        }
+    }
+}
+
 #ifndef TESTING
-int main() {
+int main(int argc, char *argv[]) {
+    const char *tracePath = NULL;
+    int reportGroup = -1, reportDays = REPORT_DEFAULT_DAYS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--cold-fields") == 0) {
+            coldFieldMode = 1;
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc &&
+                   (reportGroup = reportGroupFromName(argv[i + 1])) >= 0) {
+            i++;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) reportDays = atoi(argv[++i]);
+        } else {
+            printf("Usage: %s [--trace <file>] [--cold-fields]\n", argv[0]);
+            printf("       %s --report <priority|product|admin|day> [days]\n", argv[0]);
+            return 1;
+        }
+    }
+    // Offline report from the archive; the running engine answers REPORT too
+    if (reportGroup >= 0) return printReport(reportGroup, reportDays > 0 ? reportDays : REPORT_DEFAULT_DAYS);
+#ifdef _WIN32
+    if (coldFieldMode) {
+        printf(" Warning: --cold-fields needs mmap - keeping ticket text in memory\n");
+        coldFieldMode = 0;
+    }
+#endif
+
     printf("\n");
     printf("\n");
     printf("  Customer Support Ticketing System (DSA Project)           \n");
@@ -1246,56 +6557,70 @@ int main() {
     printf("Configuration:\n");
     printf("   - Queue Capacity: %d tickets\n", MAX_QUEUE_SIZE);
     printf("   - Escalation Cycle: %d hours\n", ESCALATION_CYCLE_HOURS);
-    printf("   - Safety Net: %d hours → Critical\n\n", SAFETY_NET_HOURS);
+    printf("   - Safety Net: %d hours → Critical\n", SAFETY_NET_HOURS);
+    printf("   - Ticket Text: %s\n\n", coldFieldMode ? "cold fields read from the active database" : "in memory");
     
     printf("System starting...\n");
     
     // Setup signal handlers for graceful shutdown
     setupSignalHandlers();
     
+    // Background log writer (falls back to inline writes if unavailable)
+    startLogger();
+    
     // Load existing tickets from CSV
     loadFromFile();
     
+    // File-based submissions arrive as batch files in the spool
+    if (!ensureSpoolDirectories()) {
+        printf(" Warning: cannot create %s - file-based submissions disabled\n", SPOOL_DIR);
+    }
+    
+    // Index resolved tickets per customer (one archive pass)
+    buildArchiveIndexes();
+    
+    // Make sure leased ticket IDs start above everything already stored
+    seedTicketIDAllocator();
+    
+    // Resume the admin command journal where we left off
+    loadAdminCommandState();
+    
+    // Lock-free queue index for Flask (status position, duplicate check)
+    if (openQueueSnapshot()) publishQueueSnapshot();
+    
     // Generate initial admin dashboard
     generateAdminHTML();
     
+    // Record incoming requests for later replay
+    if (tracePath) {
+        if (openTrace(tracePath)) {
+            printf(" Capturing workload trace to %s\n", tracePath);
+        } else {
+            printf(" Warning: cannot open trace file %s - capture disabled\n", tracePath);
+        }
+    }
+    
+    // Socket requests from Flask (file polling remains as fallback)
+    int socketActive = startCommandSocket();
+    
     printf(" System ready. Press Ctrl+C for graceful shutdown.\n\n");
 
-    int cycles = 0;
-    while (running) {  // Changed from while(1) to while(running)
-        processPendingTickets();
-        escalateOldTickets();
-        checkAdminCommands();
-        
-        // Regenerate HTML every N cycles (configurable)
-        // This reduces file I/O and race conditions while still being responsive
-        if (cycles % HTML_GENERATION_CYCLES == 0) {
-            generateAdminHTML();
-        }
-        
-        cycles++;
-        
-        // Display statistics periodically
-        if (cycles % STATS_DISPLAY_CYCLES == 0) {
-            int total = 0, oldestHours = 0;
-            double avgWait = 0.0;
-            int priorities[4] = {0, 0, 0, 0};
-            getQueueStats(&total, &avgWait, &oldestHours, priorities);
-            
-            printf("[Status] Tickets: %d | Avg Wait: %.1fh | Oldest: %dh | Critical: %d High: %d Med: %d Low: %d\n",
-                   total, avgWait, oldestHours, priorities[0], priorities[1], priorities[2], priorities[3]);
-        }
-        
-        // Sleep using configured interval
-        #ifdef _WIN32
-            Sleep(SLEEP_MILLISECONDS);
-        #else
-            usleep(SLEEP_MILLISECONDS * 1000);  // Convert milliseconds to microseconds
-        #endif
+    if (startEventSources()) {
+        // Tickless: sleeps until input, an escalation deadline or a signal
+        runEventLoop();
+    } else {
+        runPollingLoop(socketActive);
     }
     
+    stopCommandSocket();
+    stopEventSources();
+    closeQueueSnapshot();
+    exportMetrics(time(NULL));
+    closeTrace();
+    
     // Graceful shutdown cleanup
     cleanup();
+    stopLogger();
     
     return 0;
 }
@@ -0,0 +1,77 @@
+#!/bin/bash
+
+# Smart Ticket Engine - Microbenchmark Runner
+# Compiles and runs the benchmark suite, saving CSV results to bench_output.txt
+#
+# Usage: ./run_benchmarks.sh [max_queue_size] [repetitions]
+#        (defaults: 999999 tickets - every valid ticket ID - and 5 repetitions)
+
+echo ""
+echo "╔════════════════════════════════════════════════════════════════════╗"
+echo "║     SMART TICKET ENGINE - BENCHMARK RUNNER                         ║"
+echo "╚════════════════════════════════════════════════════════════════════╝"
+echo ""
+
+# Colors for output
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+MAX_SIZE=${1:-999999}
+REPS=${2:-5}
+REPO_DIR=$(pwd)
+BENCH_DIR=$(mktemp -d)
+
+# Step 1: Compile benchmark suite (optimized, queue sized for the largest run)
+echo -e "${YELLOW}[1/3]${NC} Compiling benchmark suite..."
+echo "      Compiling: main.c + data_generator.c + bench_queue.c"
+
+if command -v gcc &> /dev/null; then
+    CC=gcc
+elif command -v cc &> /dev/null; then
+    CC=cc
+else
+    echo -e "${RED}✗${NC} Error: No C compiler found (gcc or cc required)"
+    exit 1
+fi
+
+$CC -O2 -DTESTING -DGENERATOR_LIBRARY -DMAX_QUEUE_SIZE=$((MAX_SIZE + 1)) \
+    main.c data_generator.c bench_queue.c -o "$BENCH_DIR/bench_runner" -lm -pthread 2> "$BENCH_DIR/compile.log"
+if [ $? -ne 0 ]; then
+    cat "$BENCH_DIR/compile.log"
+    echo -e "${RED}✗${NC} Compilation failed!"
+    rm -rf "$BENCH_DIR"
+    exit 1
+fi
+
+echo -e "${GREEN}✓${NC} Compilation successful"
+echo ""
+
+# Step 2: Prepare a scratch directory (benchmarks write the database and dashboard)
+echo -e "${YELLOW}[2/3]${NC} Preparing scratch directory..."
+cp GENERATOR_CONFIG.json "$BENCH_DIR/"
+mkdir -p "$BENCH_DIR/templates"
+echo -e "${GREEN}✓${NC} Using $BENCH_DIR"
+echo ""
+
+# Step 3: Run benchmarks
+echo -e "${YELLOW}[3/3]${NC} Running benchmarks (up to $MAX_SIZE tickets, $REPS repetitions)..."
+echo ""
+
+(cd "$BENCH_DIR" && ./bench_runner "$MAX_SIZE" "$REPS") | tee "$REPO_DIR/bench_output.txt"
+BENCH_RESULT=${PIPESTATUS[0]}
+
+echo ""
+
+# Cleanup
+echo "Cleaning up scratch directory..."
+rm -rf "$BENCH_DIR"
+
+if [ $BENCH_RESULT -eq 0 ]; then
+    echo -e "${GREEN}✓${NC} Results saved to bench_output.txt"
+    exit 0
+else
+    echo -e "${RED}✗${NC} Benchmark run failed!"
+    exit 1
+fi
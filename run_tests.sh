@@ -27,10 +27,10 @@ echo "      Compiling: main.c + test_queue.c"
 
 # Try GCC first
 if command -v gcc &> /dev/null; then
-    gcc -DTESTING main.c test_queue.c -o test_runner -lm
+    gcc -DTESTING main.c test_queue.c -o test_runner -lm -pthread
     COMPILE_RESULT=$?
 elif command -v cc &> /dev/null; then
-    cc -DTESTING main.c test_queue.c -o test_runner -lm
+    cc -DTESTING main.c test_queue.c -o test_runner -lm -pthread
     COMPILE_RESULT=$?
 else
     echo -e "${RED}✗${NC} Error: No C compiler found (gcc or cc required)"
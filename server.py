@@ -8,6 +8,14 @@ import secrets
 import html as html_lib
 from datetime import datetime, timedelta
 import json
+import socket
+import struct
+import mmap
+import threading
+try:
+    import fcntl  # POSIX only; used to serialize admin journal appends
+except ImportError:
+    fcntl = None
 
 app = Flask(__name__, template_folder='templates', static_folder='static')
 
@@ -548,10 +556,353 @@ def register_user(username, password):
         csv.writer(f).writerow([username, password_hash])
     return True
 
+# ==================== ENGINE SOCKET CLIENT ====================
+
+"""
+DESIGN DECISION: Talk to the C engine over its Unix domain socket
+Requests are applied immediately and acknowledged, so no more sleeping and
+hoping the engine noticed a file. If the engine is not running (or on
+Windows) every caller falls back to the old file-based path.
+
+Frame: 4-byte big-endian length + tab-separated UTF-8 fields (see config.h)
+"""
+
+ENGINE_SOCKET_PATH = 'ticket_engine.sock'
+ENGINE_SOCKET_TIMEOUT = 2.0
+
+def _recv_exact(sock, size):
+    data = b''
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError('engine closed connection')
+        data += chunk
+    return data
+
+def engine_request(*fields):
+    """
+    Send one request to the engine.
+    Returns the reply as a list of fields, or None if the engine is unreachable.
+    """
+    if not hasattr(socket, 'AF_UNIX') or not os.path.exists(ENGINE_SOCKET_PATH):
+        return None
+    
+    # Tabs and newlines are field/record separators on the wire
+    payload = '\t'.join(str(f).replace('\t', ' ').replace('\n', ' ') for f in fields)
+    payload = payload.encode('utf-8')
+    
+    try:
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+            sock.settimeout(ENGINE_SOCKET_TIMEOUT)
+            sock.connect(ENGINE_SOCKET_PATH)
+            sock.sendall(struct.pack('!I', len(payload)) + payload)
+            (length,) = struct.unpack('!I', _recv_exact(sock, 4))
+            return _recv_exact(sock, length).decode('utf-8', 'replace').split('\t')
+    except (OSError, ValueError, struct.error):
+        return None
+
+# ==================== TICKET SPOOL ====================
+
+"""
+Fallback submission path when the engine socket is unavailable.
+Each submission is written as its own batch file in spool/tmp, fsynced,
+and renamed into spool/new. The engine only ever sees complete files
+and deletes them after the tickets are durable (see config.h).
+"""
+
+SPOOL_TMP_DIR = os.path.join('spool', 'tmp')
+SPOOL_NEW_DIR = os.path.join('spool', 'new')
+SPOOL_CUR_DIR = os.path.join('spool', 'cur')
+_spool_seq = {'next': 0}
+_spool_seq_lock = threading.Lock()
+
+def spool_tickets(rows):
+    """Publish rows (pending_tickets.csv columns) as one batch file"""
+    os.makedirs(SPOOL_TMP_DIR, exist_ok=True)
+    os.makedirs(SPOOL_NEW_DIR, exist_ok=True)
+    with _spool_seq_lock:
+        _spool_seq['next'] += 1
+        seq = _spool_seq['next']
+    # Unique per process; names sort in publication order for the engine
+    name = f"{time.time_ns():020d}.{os.getpid()}.{seq}.csv"
+    tmp_path = os.path.join(SPOOL_TMP_DIR, name)
+    
+    with open(tmp_path, 'w', newline='', encoding='utf-8') as f:
+        writer = csv.writer(f, quoting=csv.QUOTE_MINIMAL)
+        writer.writerows(rows)
+        f.flush()
+        os.fsync(f.fileno())
+    os.replace(tmp_path, os.path.join(SPOOL_NEW_DIR, name))
+
+def spooled_ticket_rows():
+    """Rows of every batch not yet deleted by the engine (new/ and cur/)"""
+    for directory in (SPOOL_NEW_DIR, SPOOL_CUR_DIR):
+        try:
+            names = os.listdir(directory)
+        except OSError:
+            continue
+        for name in names:
+            try:
+                with open(os.path.join(directory, name), 'r', newline='', encoding='utf-8') as f:
+                    yield from csv.reader(f)
+            except OSError:
+                continue  # Claimed or deleted while we looked
+
+# ==================== RESOLVED ARCHIVE ====================
+
+"""
+The engine archives resolved tickets in monthly partitions under
+archive/, listed in archive/manifest.txt (see config.h). Rows of the
+old single-file resolved_tickets.csv are moved there when it starts.
+"""
+
+ARCHIVE_DIR = 'archive'
+ARCHIVE_MANIFEST_FILE = os.path.join(ARCHIVE_DIR, 'manifest.txt')
+LEGACY_RESOLVED_FILE = 'resolved_tickets.csv'
+
+def resolved_archive_files():
+    """Archive partitions, newest first, then the legacy file"""
+    files = []
+    try:
+        with open(ARCHIVE_MANIFEST_FILE, 'r') as f:
+            for line in f:
+                if line.strip() and not line.startswith('#'):
+                    files.append(os.path.join(ARCHIVE_DIR, line.split()[0]))
+    except OSError:
+        pass
+    files.reverse()
+    files.append(LEGACY_RESOLVED_FILE)
+    return files
+
+def resolved_ticket_rows():
+    """Rows of every archive file, headers skipped"""
+    for path in resolved_archive_files():
+        try:
+            with open(path, 'r', newline='', encoding='utf-8') as f:
+                reader = csv.reader(f)
+                next(reader, None)
+                yield from reader
+        except OSError:
+            continue  # Deleted by retention while we looked
+
+# ==================== ACTIVE DATABASE ====================
+
+"""
+Resolves do not rewrite customer_support_tickets_updated.csv; the engine
+appends "<id>,<time>" to resolved_removals.log until its next rewrite.
+Readers of the CSV (only used when the snapshot is unavailable) skip
+those IDs.
+"""
+
+ACTIVE_TICKETS_FILE = 'customer_support_tickets_updated.csv'
+REMOVAL_LOG_FILE = 'resolved_removals.log'
+
+def removed_ticket_ids():
+    """IDs resolved since the engine last rewrote the active database"""
+    removed = set()
+    try:
+        with open(REMOVAL_LOG_FILE, 'r') as f:
+            for line in f:
+                ticket_id = line.split(',', 1)[0].strip()
+                if ticket_id:
+                    removed.add(ticket_id)
+    except OSError:
+        pass
+    return removed
+
+def active_ticket_rows():
+    """Rows of the active database (header skipped) that are still open"""
+    if not os.path.exists(ACTIVE_TICKETS_FILE):
+        return
+    removed = removed_ticket_ids()
+    with open(ACTIVE_TICKETS_FILE, 'r', encoding='utf-8') as f:
+        reader = csv.reader(f)
+        next(reader, None)  # Skip header
+        for row in reader:
+            if row and row[0].strip() not in removed:
+                yield row
+
+# ==================== ADMIN COMMAND JOURNAL ====================
+
+"""
+Fallback command channel when the engine socket is unavailable.
+Commands are appended as "<seq> <COMMAND> <args>" lines (never overwritten),
+the engine applies them in order and appends "<seq> OK|ERR <message>"
+to the results file, which we poll instead of sleeping blindly.
+"""
+
+ADMIN_COMMANDS_JOURNAL = 'admin_commands.journal'
+ADMIN_COMMAND_STATE = 'admin_commands.state'
+ADMIN_COMMAND_RESULTS = 'admin_command_results.txt'
+ADMIN_RESULT_TIMEOUT = 2.0
+
+def _last_command_seq(journal):
+    """Highest seq issued so far: journal tail, or engine state if compacted"""
+    last_seq = 0
+    try:
+        with open(ADMIN_COMMAND_STATE, 'r') as f:
+            last_seq = int(f.read().split()[0])
+    except (OSError, ValueError, IndexError):
+        pass
+    
+    journal.seek(0, os.SEEK_END)
+    size = journal.tell()
+    if size:
+        journal.seek(max(0, size - 4096))
+        for line in reversed(journal.read().splitlines()):
+            try:
+                last_seq = max(last_seq, int(line.split()[0]))
+                break
+            except (ValueError, IndexError):
+                continue
+    return last_seq
+
+def submit_admin_command(command, *args):
+    """Append a command to the journal; returns its sequence number"""
+    with open(ADMIN_COMMANDS_JOURNAL, 'a+') as journal:
+        if fcntl:
+            fcntl.flock(journal, fcntl.LOCK_EX)
+        try:
+            seq = _last_command_seq(journal) + 1
+            journal.write(f"{seq} {command} {' '.join(str(a) for a in args)}\n")
+            journal.flush()
+        finally:
+            if fcntl:
+                fcntl.flock(journal, fcntl.LOCK_UN)
+    return seq
+
+def wait_for_command_result(seq, timeout=ADMIN_RESULT_TIMEOUT):
+    """Poll the results file for our seq; returns (ok, message) or None on timeout"""
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        if os.path.exists(ADMIN_COMMAND_RESULTS):
+            with open(ADMIN_COMMAND_RESULTS, 'r') as f:
+                for line in f:
+                    parts = line.rstrip('\n').split(' ', 2)
+                    if parts and parts[0] == str(seq):
+                        return parts[1] == 'OK', parts[2] if len(parts) > 2 else ''
+        time.sleep(0.02)
+    return None
+
+# ==================== QUEUE SNAPSHOT (SHARED MEMORY) ====================
+
+"""
+DESIGN DECISION: Read queue positions from the engine's mmapped snapshot
+The engine publishes ticket ID, position, entry time, priority, email hash
+and duplicate key for every open ticket (see main.c, SHARED-MEMORY QUEUE
+SNAPSHOT). Reading it is lock-free: copy, then verify the seqlock counter
+did not move. Returns None when the engine is not running, so callers fall
+back to parsing the CSV.
+"""
+
+QUEUE_SNAPSHOT_FILE = 'queue_snapshot.shm'
+SNAPSHOT_HEADER = struct.Struct('<8sIIIIIIqQ16s')
+SNAPSHOT_ENTRY = struct.Struct('<iiqQQB7x')
+SNAPSHOT_SEQ_OFFSET = 20
+SNAPSHOT_FLAG_LIVE = 0x1
+PRIORITY_NAMES = ('Critical', 'High', 'Medium', 'Low')
+DUPLICATE_CHECK_PREFIX_LEN = 30
+
+_snapshot_map = None
+_snapshot_inode = None
+
+def fnv1a64(data):
+    """Same hash as hashString() in main.c"""
+    h = 1469598103934665603
+    for b in data:
+        h = ((h ^ b) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+def normalize_email(email):
+    return email.strip(' \t\r\n\v\f"').lower()
+
+def duplicate_key(email, description):
+    """Same key as duplicateKey() in main.c (byte prefix, ASCII lowercase)"""
+    prefix = description.encode('utf-8')[:DUPLICATE_CHECK_PREFIX_LEN].lower()
+    return fnv1a64(normalize_email(email).encode('utf-8') + b'\x1f' + prefix)
+
+def _snapshot_mapping():
+    global _snapshot_map, _snapshot_inode
+    try:
+        st = os.stat(QUEUE_SNAPSHOT_FILE)
+    except OSError:
+        return None
+    
+    # Remap if the engine recreated the file
+    if _snapshot_map is None or _snapshot_inode != (st.st_dev, st.st_ino) or len(_snapshot_map) != st.st_size:
+        if _snapshot_map is not None:
+            _snapshot_map.close()
+            _snapshot_map = None
+        if st.st_size < SNAPSHOT_HEADER.size:
+            return None
+        with open(QUEUE_SNAPSHOT_FILE, 'rb') as f:
+            _snapshot_map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        _snapshot_inode = (st.st_dev, st.st_ino)
+    return _snapshot_map
+
+def read_queue_snapshot(retries=100):
+    """
+    Returns a list of dicts in queue order, or None if no live snapshot
+    """
+    try:
+        m = _snapshot_mapping()
+    except (OSError, ValueError):
+        return None
+    if m is None:
+        return None
+    
+    for _ in range(retries):
+        (seq_before,) = struct.unpack_from('<I', m, SNAPSHOT_SEQ_OFFSET)
+        if seq_before & 1:
+            time.sleep(0)
+            continue
+        
+        magic, version, entry_size, capacity, _, count, flags, _, _, _ = SNAPSHOT_HEADER.unpack_from(m, 0)
+        if magic.rstrip(b'\0') != b'TQSNAP1' or entry_size != SNAPSHOT_ENTRY.size or count > capacity:
+            return None
+        end = SNAPSHOT_HEADER.size + count * entry_size
+        if end > len(m):
+            return None
+        raw = m[SNAPSHOT_HEADER.size:end]
+        
+        (seq_after,) = struct.unpack_from('<I', m, SNAPSHOT_SEQ_OFFSET)
+        if seq_after != seq_before:
+            continue
+        if not flags & SNAPSHOT_FLAG_LIVE:
+            return None
+        
+        entries = []
+        for ticket_id, position, entry_time, email_hash, dup_key, priority in SNAPSHOT_ENTRY.iter_unpack(raw):
+            entries.append({
+                'ticket_id': ticket_id,
+                'position': position,
+                'entry_time': entry_time,
+                'email_hash': email_hash,
+                'duplicate_key': dup_key,
+                'priority': PRIORITY_NAMES[priority] if priority < len(PRIORITY_NAMES) else 'Low',
+            })
+        return entries
+    return None
+
 # ==================== TICKET ID GENERATION ====================
 
-def get_next_ticket_id():
-    """Generate next available ticket ID by scanning all CSV files"""
+"""
+DESIGN DECISION: Lease blocks of IDs instead of scanning for max+1
+ticket_id.hwm holds the next unassigned ID. Each process leases a block
+(from the engine's ALLOC request, or directly under flock when the engine
+is down) and hands IDs out locally, so assignment is O(1) and concurrent
+producers never collide. Unused IDs of a block are skipped on restart.
+"""
+
+TICKET_ID_HWM_FILE = 'ticket_id.hwm'
+TICKET_ID_LEASE_SIZE = 50
+FIRST_ALLOCATED_TICKET_ID = 1001
+
+_id_lease = {'next': 0, 'end': 0}
+_id_lease_lock = threading.Lock()
+
+def _scan_max_ticket_id():
+    """Highest ticket ID in any CSV file (only used to seed a missing mark)"""
     max_id = 1000 
 
     # Check active tickets
@@ -568,34 +919,67 @@ def get_next_ticket_id():
                     except: 
                         pass
     
-    # Check pending tickets
-    if os.path.exists('pending_tickets.csv'):
-        with open('pending_tickets.csv', 'r') as f:
-            reader = csv.reader(f)
-            for row in reader:
-                if row:
-                    try:
-                        curr_id = int(row[0])
-                        if curr_id > max_id: 
-                            max_id = curr_id
-                    except: 
-                        pass
+    # Check spooled tickets
+    for row in spooled_ticket_rows():
+        if row:
+            try:
+                curr_id = int(row[0])
+                if curr_id > max_id: 
+                    max_id = curr_id
+            except: 
+                pass
     
     # Check resolved tickets
-    if os.path.exists('resolved_tickets.csv'):
-        with open('resolved_tickets.csv', 'r') as f:
-            reader = csv.reader(f)
-            next(reader, None)
-            for row in reader:
-                if row:
-                    try:
-                        curr_id = int(row[0])
-                        if curr_id > max_id: 
-                            max_id = curr_id
-                    except: 
-                        pass
+    for row in resolved_ticket_rows():
+        if row:
+            try:
+                curr_id = int(row[0])
+                if curr_id > max_id: 
+                    max_id = curr_id
+            except: 
+                pass
                     
-    return max_id + 1
+    return max_id
+
+def _lease_from_file(count):
+    """Same protocol as reserveTicketIDs() in main.c"""
+    with open(TICKET_ID_HWM_FILE, 'a+') as f:
+        if fcntl:
+            fcntl.flock(f, fcntl.LOCK_EX)
+        try:
+            f.seek(0)
+            try:
+                first = int(f.read().strip())
+            except ValueError:
+                first = _scan_max_ticket_id() + 1
+            first = max(first, FIRST_ALLOCATED_TICKET_ID)
+            f.seek(0)
+            f.truncate()
+            f.write(f"{first + count}\n")
+            f.flush()
+            os.fsync(f.fileno())
+        finally:
+            if fcntl:
+                fcntl.flock(f, fcntl.LOCK_UN)
+    return first
+
+def lease_ticket_ids(count=TICKET_ID_LEASE_SIZE):
+    """Reserve `count` consecutive IDs; returns the first one"""
+    reply = engine_request('ALLOC', count)
+    if reply and reply[0] == 'OK':
+        return int(reply[1])
+    return _lease_from_file(count)
+
+def get_next_ticket_id():
+    """Next ID from this process's leased block (leases a new block when empty)"""
+    with _id_lease_lock:
+        if _id_lease['next'] >= _id_lease['end']:
+            first = lease_ticket_ids(TICKET_ID_LEASE_SIZE)
+            _id_lease['next'] = first
+            _id_lease['end'] = first + TICKET_ID_LEASE_SIZE
+        ticket_id = _id_lease['next']
+        _id_lease['next'] += 1
+        return ticket_id
 
 # ==================== DUPLICATE DETECTION ====================
 
@@ -608,24 +992,31 @@ def check_duplicate_ticket(email, description):
     Checks: Same email + similar issue (first 30 chars match)
     """
     
-    if not os.path.exists('customer_support_tickets_updated.csv'):
+    reply = engine_request('DUPCHECK', email, description)
+    if reply and reply[0] == 'DUPLICATE':
+        return True, reply[1]
+    if reply and reply[0] == 'OK':
+        return False, None
+    
+    snapshot = read_queue_snapshot()
+    if snapshot is not None:
+        key = duplicate_key(email, description)
+        for entry in snapshot:
+            if entry['duplicate_key'] == key:
+                return True, str(entry['ticket_id'])
         return False, None
     
     desc_prefix = description[:30].lower().strip()
     
-    with open('customer_support_tickets_updated.csv', 'r') as f:
-        reader = csv.reader(f)
-        next(reader, None)  # Skip header
+    for row in active_ticket_rows():
+        if len(row) < 6:
+            continue
         
-        for row in reader:
-            if len(row) < 6:
-                continue
-            
-            csv_email = row[2].strip().lower()
-            csv_desc = row[5].strip().lower()[:30]
-            
-            if csv_email == email.lower() and csv_desc == desc_prefix:
-                return True, row[0]  # Duplicate found
+        csv_email = row[2].strip().lower()
+        csv_desc = row[5].strip().lower()[:30]
+        
+        if csv_email == email.lower() and csv_desc == desc_prefix:
+            return True, row[0]  # Duplicate found
     
     return False, None
 
@@ -767,7 +1158,7 @@ def ticket_form():
 def submit_ticket():
     """
     Handle ticket submission with comprehensive validation, duplicate detection, and XSS protection
-    Flow: Validate inputs → Check for duplicates → Generate ID → Save to pending_tickets.csv
+    Flow: Validate inputs → Check for duplicates → Generate ID → Send to engine (or spool)
     """
     # SECURITY FIX: Sanitize all user inputs to prevent XSS attacks
     name = html_lib.escape(request.form.get('name', '').strip())
@@ -829,21 +1220,30 @@ def submit_ticket():
     # Not a duplicate - create new ticket
     new_ticket_id = get_next_ticket_id()
 
-    # Save to pending_tickets.csv (staging area)
-    with open('pending_tickets.csv', 'a', newline='', encoding='utf-8') as f:
-        writer = csv.writer(f, quoting=csv.QUOTE_MINIMAL)
-        writer.writerow([new_ticket_id, name, email, product, purchase_date, description])
-    
-    # Calculate queue position for user feedback
-    queue_size = 0
-    if os.path.exists('customer_support_tickets_updated.csv'):
-        with open('customer_support_tickets_updated.csv', 'r') as f:
-            queue_size = sum(1 for line in f) - 1  # Subtract header
+    # Preferred path: hand the ticket straight to the engine (queued on ack)
+    reply = engine_request('SUBMIT', new_ticket_id, name, email, product, purchase_date, description)
     
-    # Add pending tickets count
-    if os.path.exists('pending_tickets.csv'):
-        with open('pending_tickets.csv', 'r') as f:
-            queue_size += sum(1 for line in f)
+    if reply and reply[0] == 'DUPLICATE':
+        return render_template('homepage.html',
+            message=f"⚠️ You already have an open ticket for this issue (#{reply[1]}). "
+                   f"Please wait for resolution or check ticket status.",
+            new_id=reply[1])
+    
+    if reply and reply[0] == 'OK':
+        queue_size = int(reply[3])
+    elif reply:
+        # The engine rejected the ticket (invalid data, queue full): do not spool it
+        reason = reply[1] if len(reply) > 1 else reply[0]
+        return render_template('index1.html', error=f"❌ Ticket could not be created: {reason}")
+    else:
+        # Engine unreachable: publish a batch file to the engine's spool
+        spool_tickets([[new_ticket_id, name, email, product, purchase_date, description]])
+        
+        # Calculate queue position for user feedback
+        queue_size = sum(1 for row in active_ticket_rows())
+        
+        # Add spooled tickets count
+        queue_size += sum(1 for row in spooled_ticket_rows() if row)
     
     # Generate user feedback message
     position_msg = f"✅ Ticket #{new_ticket_id} created successfully!{product_correction_note}"
@@ -887,6 +1287,9 @@ def check_status():
         """Search CSV file for ticket with email verification"""
         if not os.path.exists(filename): 
             return None
+        
+        # Resolved-but-not-yet-compacted rows are not active
+        removed = removed_ticket_ids() if db_type == 'active' else set()
             
         with open(filename, 'r', encoding='utf-8') as f:
             reader = csv.reader(f)
@@ -900,15 +1303,65 @@ def check_status():
                 csv_id = row[0].strip()
                 csv_email = row[2].strip().lower()
 
-                if csv_id == ticket_id:
+                if csv_id == ticket_id and csv_id not in removed:
                     if csv_email == email_input:
                         return row
                     else:
                         return "UNAUTHORIZED"
         return None
 
+    def format_wait(wait_seconds):
+        wait_hours = wait_seconds / 3600.0
+        if wait_hours < 1:
+            return f"{wait_hours * 60:.0f} minutes"
+        return f"{wait_hours:.1f} hours"
+
+    # Engine answers from its in-memory indexes (open and resolved tickets)
+    reply = engine_request('QUERY', ticket_id, email_input) if ticket_id.isdigit() else None
+    if reply and reply[0] in ('OK', 'UNAUTHORIZED', 'NOT_FOUND'):
+        if reply[0] == 'UNAUTHORIZED':
+            error_msg = "🔒 Security Error: Ticket ID exists but Email does not match!"
+        elif reply[0] == 'NOT_FOUND' or len(reply) < 10:
+            error_msg = "❌ Ticket ID not found in our database."
+        else:
+            found_status = reply[1]
+            found_priority, found_customer, found_product, found_dop, found_issue = reply[5:10]
+            if found_status == 'Open':
+                queue_position = int(reply[3])
+                wait_time = format_wait(int(reply[4]))
+            else:
+                found_resolve_time = reply[3]
+        
+        return render_template('status.html', 
+                               ticket_id=ticket_id if not error_msg else None, 
+                               status=found_status, 
+                               customer=found_customer, 
+                               product=found_product,
+                               dop=found_dop, 
+                               issue=found_issue, 
+                               priority=found_priority,
+                               wait_time=wait_time,
+                               queue_position=queue_position,
+                               resolve_time=found_resolve_time, 
+                               error=error_msg)
+
+    # Engine snapshot answers "is it open, and where" without parsing the CSV
+    snapshot_entry = None
+    snapshot = read_queue_snapshot()
+    if snapshot is not None:
+        email_hash = fnv1a64(normalize_email(email_input).encode('utf-8'))
+        for entry in snapshot:
+            if str(entry['ticket_id']) == ticket_id:
+                snapshot_entry = entry
+                break
+    
     # Search in active tickets first
-    result = search_csv('customer_support_tickets_updated.csv', 'active')
+    if snapshot_entry and snapshot_entry['email_hash'] != email_hash:
+        result = "UNAUTHORIZED"
+    elif snapshot is not None and not snapshot_entry:
+        result = None  # Not open: skip straight to resolved tickets
+    else:
+        result = search_csv('customer_support_tickets_updated.csv', 'active')
     
     if result == "UNAUTHORIZED":
         error_msg = "🔒 Security Error: Ticket ID exists but Email does not match!"
@@ -921,20 +1374,21 @@ def check_status():
         found_priority = result[6].strip() if len(result) > 6 else "N/A"
         
         # Calculate queue position
-        position = 1
-        with open('customer_support_tickets_updated.csv', 'r') as f:
-            reader = csv.reader(f)
-            next(reader, None)
-            for row in reader:
-                if row and row[0].strip() == ticket_id:
+        if snapshot_entry:
+            queue_position = snapshot_entry['position']
+            found_priority = snapshot_entry['priority']
+        else:
+            position = 1
+            for row in active_ticket_rows():
+                if row[0].strip() == ticket_id:
                     break
                 position += 1
-        queue_position = position
+            queue_position = position
         
         # Calculate wait time
-        if len(result) > 7 and result[7]:
+        if snapshot_entry or (len(result) > 7 and result[7]):
             try:
-                entry_time = int(result[7].strip())
+                entry_time = snapshot_entry['entry_time'] if snapshot_entry else int(result[7].strip())
                 current_time = int(time.time())
                 wait_hours = (current_time - entry_time) / 3600.0
                 if wait_hours < 1:
@@ -946,7 +1400,11 @@ def check_status():
 
     # If not in active, search resolved
     if not found_status and not error_msg:
-        result = search_csv('resolved_tickets.csv', 'resolved')
+        result = None
+        for path in resolved_archive_files():
+            result = search_csv(path, 'resolved')
+            if result:
+                break
         if result == "UNAUTHORIZED":
             error_msg = "🔒 Security Error: Ticket ID exists but Email does not match!"
         elif result:
@@ -1030,9 +1488,13 @@ def resolve_ticket(ticket_id):
     
     admin_username = session.get('admin_username', 'admin')
     
-    # Write command with admin username for tracking
-    with open('admin_commands.txt', 'w') as f: 
-        f.write(f"RESOLVE {ticket_id} {admin_username}")
+    # Resolve through the engine socket; the ack means it is already archived
+    reply = engine_request('RESOLVE', ticket_id, admin_username)
+    
+    command_seq = None
+    if reply is None:
+        # Engine socket unavailable - journal the command with admin username for tracking
+        command_seq = submit_admin_command('RESOLVE', ticket_id, admin_username)
     
     # Mark as resolved in session with timestamp
     session[resolved_key] = True
@@ -1042,7 +1504,9 @@ def resolve_ticket(ticket_id):
     log_admin_activity('RESOLVE_TICKET', ticket_id=ticket_id, 
                       details=f'Ticket #{ticket_id} resolved')
     
-    time.sleep(0.5)
+    if command_seq is not None:
+        # Wait (bounded) for the engine to apply it, so the dashboard is current
+        wait_for_command_result(command_seq)
     
     # Force browser to reload (prevent cache)
     from flask import make_response
@@ -1052,6 +1516,80 @@ def resolve_ticket(ticket_id):
     response.headers['Expires'] = '0'
     return response
 
+# IDs per RESOLVE_IDS command, so each fits one socket frame / journal line
+BULK_RESOLVE_CHUNK = 500
+
+def _bulk_resolve(command, *args):
+    """Run one bulk command; returns the number resolved, or None if it failed"""
+    reply = engine_request(command, *args)
+    if reply is not None:
+        return int(reply[1]) if reply[0] == 'OK' and len(reply) > 1 else None
+    
+    # Engine socket unavailable - journal it and wait (bounded) for the result
+    result = wait_for_command_result(submit_admin_command(command, *args))
+    if result is None or not result[0]:
+        return None
+    try:
+        return int(result[1].split()[0])
+    except (ValueError, IndexError):
+        return None
+
+@app.route('/resolve_bulk', methods=['POST'])
+def resolve_bulk():
+    """Resolve many tickets at once (ID list, filter, or first N) - admin only"""
+    if not session.get('is_admin'):
+        flash("Unauthorized.", "error")
+        return redirect(url_for('login_page'))
+    
+    admin_username = session.get('admin_username', 'admin')
+    mode = request.form.get('mode', '')
+    resolved = None
+    
+    if mode == 'ids':
+        ids = [t for t in re.split(r'[\s,]+', request.form.get('ids', '')) if t.isdigit()]
+        if ids:
+            resolved = 0
+            for start in range(0, len(ids), BULK_RESOLVE_CHUNK):
+                count = _bulk_resolve('RESOLVE_IDS', admin_username, ','.join(ids[start:start + BULK_RESOLVE_CHUNK]))
+                if count is None:
+                    resolved = None
+                    break
+                resolved += count
+        details = f"IDs: {', '.join(ids[:20])}{' ...' if len(ids) > 20 else ''}"
+    elif mode == 'matching':
+        priority = request.form.get('priority', '*')
+        product = re.sub(r'\s+', ' ', request.form.get('product', '')).strip() or '*'
+        try:
+            min_age_hours = max(0.0, float(request.form.get('min_age_hours') or 0))
+        except ValueError:
+            min_age_hours = 0.0
+        if priority not in ('*', 'Low', 'Medium', 'High', 'Critical'):
+            priority = '*'
+        if priority != '*' or product != '*' or min_age_hours > 0:
+            resolved = _bulk_resolve('RESOLVE_MATCHING', admin_username, priority, min_age_hours, product)
+        details = f"priority={priority} product={product} older_than={min_age_hours}h"
+    elif mode == 'first':
+        try:
+            count = int(request.form.get('count') or 0)
+        except ValueError:
+            count = 0
+        if count > 0:
+            resolved = _bulk_resolve('RESOLVE_FIRST', count, admin_username)
+        details = f"first {count}"
+    else:
+        details = ''
+    
+    if resolved is None:
+        flash("Bulk resolve failed: check the filter and try again.", "error")
+    else:
+        log_admin_activity('BULK_RESOLVE', details=f'{resolved} tickets resolved ({details})')
+        flash(f"✅ {resolved} tickets resolved.", "success")
+    
+    from flask import make_response
+    response = make_response(redirect(url_for('admin_dashboard')))
+    response.headers['Cache-Control'] = 'no-cache, no-store, must-revalidate, max-age=0'
+    return response
+
 @app.route('/update_priority/<int:ticket_id>/<priority>', methods=['POST'])
 def update_priority(ticket_id, priority):
     """Update ticket priority - requires active admin session"""
@@ -1064,41 +1602,30 @@ def update_priority(ticket_id, priority):
     if priority not in valid_priorities:
         return jsonify({'success': False, 'error': 'Invalid priority'})
     
-    # Update in active queue CSV
-    try:
-        rows = []
-        found = False
-        old_priority = 'Unknown'
-        
-        if os.path.exists('customer_support_tickets_updated.csv'):
-            with open('customer_support_tickets_updated.csv', 'r') as f:
-                reader = csv.reader(f)
-                header = next(reader)
-                rows.append(header)
-                
-                for row in reader:
-                    if len(row) > 0 and row[0].strip() == str(ticket_id):
-                        old_priority = row[6] if len(row) > 6 else 'Unknown'
-                        row[6] = priority  # Priority is column 6
-                        found = True
-                    rows.append(row)
-            
-            # Write back
-            if found:
-                with open('customer_support_tickets_updated.csv', 'w', newline='') as f:
-                    writer = csv.writer(f)
-                    writer.writerows(rows)
-                
-                # Log the priority change
-                log_admin_activity('CHANGE_PRIORITY', ticket_id=ticket_id,
-                                 details=f'Priority changed: {old_priority} → {priority}')
-                
-                return jsonify({'success': True, 'message': f'Priority updated to {priority}'})
-        
-        return jsonify({'success': False, 'error': 'Ticket not found'})
-    
-    except Exception as e:
-        return jsonify({'success': False, 'error': str(e)})
+    # Preferred path: the engine updates its in-memory queue and persists it
+    reply = engine_request('SET_PRIORITY', ticket_id, priority, session.get('admin_username', 'admin'))
+    if reply is not None:
+        if reply[0] != 'OK':
+            return jsonify({'success': False, 'error': reply[1] if len(reply) > 1 else 'Engine error'})
+        log_admin_activity('CHANGE_PRIORITY', ticket_id=ticket_id,
+                         details=f'Priority changed: {reply[1]} → {priority}')
+        return jsonify({'success': True, 'message': f'Priority updated to {priority}'})
+    
+    # Fallback: journal the command; the engine applies it in memory
+    # (never rewrite the CSV here - that raced with the engine's own writes)
+    seq = submit_admin_command('SET_PRIORITY', ticket_id, priority, session.get('admin_username', 'admin'))
+    result = wait_for_command_result(seq)
+    if result is None:
+        log_admin_activity('CHANGE_PRIORITY', ticket_id=ticket_id,
+                         details=f'Priority change to {priority} queued')
+        return jsonify({'success': True, 'message': f'Priority change to {priority} queued'})
+    
+    ok, message = result
+    if not ok:
+        return jsonify({'success': False, 'error': message or 'Ticket not found'})
+    log_admin_activity('CHANGE_PRIORITY', ticket_id=ticket_id,
+                     details=f'Priority changed: {message}')
+    return jsonify({'success': True, 'message': f'Priority updated to {priority}'})
 
 @app.route('/activity_log')
 def view_activity_log():
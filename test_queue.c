@@ -10,25 +10,57 @@
 #include <assert.h>
 #include <string.h>
 #include <time.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include "config.h"
+#ifndef _WIN32
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
 
 /* ==================== EXTERNAL DECLARATIONS ==================== */
 
 // Data structure from main.c
 struct Ticket {
     int ticketID;
-    char customerName[100];
-    char email[100];
-    char product[100];
-    char purchaseDate[50];
-    char issueDescription[200];
-    char priority[20];
+    char customerName[MAX_CUSTOMER_NAME_LEN + 1];
+    char email[MAX_EMAIL_LEN + 1];
+    char product[MAX_PRODUCT_LEN + 1];
+    char purchaseDate[MAX_PURCHASE_DATE_LEN + 1];
+    char issueDescription[MAX_ISSUE_DESC_LEN + 1];
+    char priority[MAX_PRIORITY_LEN + 1];
     time_t queueEntryTime;
 };
 
+// Sketch quantiles from main.c (WAIT TIME SKETCHES)
+struct WaitQuantiles {
+    char name[MAX_PRODUCT_LEN + 1];
+    double weight;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+};
+
+// Report row from main.c (RESOLVED ANALYTICS)
+struct ReportLine {
+    char name[MAX_PRODUCT_LEN + 1];
+    uint64_t count;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+};
+
+// Bulk resolve predicate from main.c (BULK RESOLVE)
+struct ResolveFilter {
+    const char *priority;
+    const char *product;
+    long minAgeSeconds;
+};
+
 // External variables from main.c
-extern struct Ticket queue[MAX_QUEUE_SIZE];
 extern int front, rear;
+extern size_t textArenaSize, textArenaLive;
 
 // External functions from main.c
 extern int isEmpty();
@@ -40,6 +72,43 @@ extern int isValidEmail(const char *email);
 extern int isValidPriority(const char *priority);
 extern int isValidTicketID(int id);
 extern int isValidString(const char *str, int minLen, int maxLen);
+extern void recordCustomerResolution(const char *email, time_t resolvedAt);
+extern int lookupCustomerHistory(const char *email, time_t *lastResolved);
+extern void resetCustomerHistoryIndex();
+extern int findTicketSlot(int id);
+extern int removeTicketAt(int slot, struct Ticket *t);
+extern int queuePosition(int slot);
+extern int isDuplicateInQueue(const char *email, const char *issue);
+extern int histogramBucket(uint64_t ns);
+extern uint64_t histogramBucketHigh(int index);
+extern int enqueueBatch(struct Ticket *tickets, int count, time_t entryTime, FILE *db, int *results);
+extern long ticketIDHighWater;
+extern void resetQueue();
+extern void copyQueuedTicket(int slot, struct Ticket *t);
+extern int coldFieldMode;
+extern void saveQueueToFile();
+extern void buildArchiveIndexes();
+extern int archiveTickets(const struct Ticket *tickets, int count, const char *admin_username);
+extern int isDuplicateInResolved(const char *email, const char *issue, int maxDaysBack);
+extern int lookupResolvedTicket(int id, char *line, size_t lineSize, char **fields, int maxFields);
+extern struct ReportLine *buildReport(int group, time_t from, time_t to, int *count);
+extern void getQueueStats(int *total, double *avgWaitHours, int *oldestHours, int priorities[4]);
+extern void recordResolvedWait(int priority, uint16_t product, time_t entryTime, time_t now);
+extern void resetWaitSketches();
+extern int getWaitQuantiles(struct WaitQuantiles byPriority[4], struct WaitQuantiles *byProduct, int maxProducts);
+extern int resolveTicketByID(int id, const char *admin_username);
+extern void loadFromFile();
+extern int removalLogRecords;
+extern int databaseOverflowRows;
+extern void rememberDatabaseStamp();
+extern void startCompaction();
+extern int reapCompaction(int wait);
+extern void finishCompaction();
+extern int resolveTicketList(const int *ids, int idCount, const char *admin_username);
+extern int resolveMatching(const struct ResolveFilter *filter, const char *admin_username);
+extern int resolveFirst(int n, const char *admin_username);
+extern int runBulkResolve(char **args, int nargs);
+extern int isArchivedTicket(int id);
 
 /* ==================== TEST UTILITIES ==================== */
 
@@ -60,6 +129,82 @@ void reset_queue() {
     front = rear = -1;
 }
 
+void make_batch_ticket(struct Ticket *t, int id, const char *email, const char *issue) {
+    memset(t, 0, sizeof(*t));
+    t->ticketID = id;
+    strcpy(t->customerName, "Batch User");
+    strcpy(t->email, email);
+    strcpy(t->product, "Laptop");
+    strcpy(t->issueDescription, issue);
+}
+
+#ifndef _WIN32
+/*
+ * Tests that write engine files (database, archive, logs) run in a
+ * scratch directory: enter_scratch_dir() creates /tmp/ticket_<name>_XXXXXX
+ * and moves into it, leave_scratch_dir() empties it and moves back.
+ */
+char scratch_dir[64];
+char scratch_cwd[1024];
+
+// Deletes the entries of `dir` whose name contains `pattern`; NULL deletes
+// everything, subdirectories included
+void remove_files(const char *dir, const char *pattern) {
+    DIR *d = opendir(dir);
+    struct dirent *entry;
+    while (d && (entry = readdir(d))) {
+        if (entry->d_name[0] == '.' || (pattern && !strstr(entry->d_name, pattern))) continue;
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        struct stat st;
+        if (!pattern && stat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+            remove_files(path, NULL);
+            rmdir(path);
+        } else {
+            remove(path);
+        }
+    }
+    if (d) closedir(d);
+}
+
+int enter_scratch_dir(const char *name) {
+    snprintf(scratch_dir, sizeof(scratch_dir), "/tmp/ticket_%s_XXXXXX", name);
+    return getcwd(scratch_cwd, sizeof(scratch_cwd)) && mkdtemp(scratch_dir) && chdir(scratch_dir) == 0;
+}
+
+void leave_scratch_dir() {
+    remove_files(".", NULL);
+    if (chdir(scratch_cwd) == 0) rmdir(scratch_dir);
+}
+
+// True if `path` has a line starting with `prefix`
+int file_has_line(const char *path, const char *prefix) {
+    FILE *f = fopen(path, "r");
+    char line[4096];
+    int found = 0;
+    while (f && !found && fgets(line, sizeof(line), f)) {
+        found = strncmp(line, prefix, strlen(prefix)) == 0;
+    }
+    if (f) fclose(f);
+    return found;
+}
+
+// Starts an active database holding `count` tickets from `firstID` on
+void write_ticket_database(int firstID, int count) {
+    FILE *db = fopen(PENDING_TICKETS_FILE, "w");
+    fprintf(db, "Ticket ID,Customer Name,Customer Email,Product,Purchase Date,Issue Description,Priority,Queue Entry Time\n");
+    for (int i = 0; i < count; i++) {
+        struct Ticket t;
+        char email[64], issue[64];
+        snprintf(email, sizeof(email), "user%d@test.com", firstID + i);
+        snprintf(issue, sizeof(issue), "Problem number %d", firstID + i);
+        make_batch_ticket(&t, firstID + i, email, issue);
+        enqueueBatch(&t, 1, time(NULL), db, NULL);
+    }
+    fclose(db);
+}
+#endif
+
 /* ==================== BASIC QUEUE TESTS ==================== */
 
 void test_queue_initialization() {
@@ -293,8 +438,581 @@ void test_string_validation() {
     test_assert(isValidString(NULL, 2, 10) == 0, "Invalid String 3", "NULL should be invalid");
 }
 
+/* ==================== INDEX TESTS ==================== */
+
+void test_customer_history_index() {
+    printf("\n📋 TEST 13: Customer History Index\n");
+    resetCustomerHistoryIndex();
+    
+    test_assert(lookupCustomerHistory("new@test.com", NULL) == 0, "Unknown Customer", "Should have no history");
+    
+    recordCustomerResolution("Repeat@Test.com", 1000);
+    recordCustomerResolution("\"repeat@test.com\"", 2000);
+    recordCustomerResolution("other@test.com", 1500);
+    
+    time_t last = 0;
+    test_assert(lookupCustomerHistory("repeat@test.com", &last) == 2, "Normalized Count", "Should count case/quote variants together");
+    test_assert(last == 2000, "Last Resolved", "Should keep the latest resolution time");
+    test_assert(lookupCustomerHistory("other@test.com", NULL) == 1, "Separate Key", "Other customer should have 1");
+    
+    // Force several table growths
+    char email[64];
+    for (int i = 0; i < 5000; i++) {
+        sprintf(email, "bulk%d@test.com", i);
+        recordCustomerResolution(email, i);
+    }
+    test_assert(lookupCustomerHistory("bulk4999@test.com", NULL) == 1, "After Growth", "Lookups should survive rehashing");
+    test_assert(lookupCustomerHistory("repeat@test.com", NULL) == 2, "Old Keys After Growth", "Existing counts should be preserved");
+    
+    resetCustomerHistoryIndex();
+}
+
+void test_ticket_index() {
+    printf("\n📋 TEST 14: Ticket ID and Duplicate Index\n");
+    reset_queue();
+    
+    for (int i = 1; i <= 5; i++) {
+        struct Ticket t = {.ticketID = 1000 + i, .queueEntryTime = time(NULL)};
+        sprintf(t.email, "user%d@test.com", i);
+        sprintf(t.issueDescription, "Issue number %d with the product", i);
+        strcpy(t.priority, "Low");
+        enqueue(t);
+    }
+    
+    test_assert(queuePosition(findTicketSlot(1003)) == 3, "Lookup Position", "Ticket 1003 should be 3rd");
+    test_assert(findTicketSlot(9999) == -1, "Missing ID", "Unknown ticket should not be found");
+    test_assert(isDuplicateInQueue("USER4@test.com", "issue NUMBER 4 with the product") == 1004,
+                "Duplicate Probe", "Case-insensitive duplicate should return ticket 1004");
+    
+    struct Ticket removed;
+    removeTicketAt(findTicketSlot(1002), &removed);
+    test_assert(removed.ticketID == 1002, "Remove By Slot", "Should remove ticket 1002");
+    test_assert(findTicketSlot(1002) == -1, "Removed ID", "Removed ticket should leave the index");
+    test_assert(queuePosition(findTicketSlot(1005)) == 4, "Shifted Position", "Later tickets should move up");
+    test_assert(isDuplicateInQueue("user2@test.com", "Issue number 2 with the product") == 0,
+                "Removed Duplicate", "Removed ticket should no longer be a duplicate");
+    
+    dequeue(&removed);
+    test_assert(findTicketSlot(1001) == -1 && queuePosition(findTicketSlot(1003)) == 1,
+                "Dequeue Updates Index", "Front ticket should leave the index");
+}
+
+void test_latency_histogram_buckets() {
+    printf("\n📋 TEST 15: Latency Histogram Buckets\n");
+    
+    int within = 1;
+    int monotonic = 1;
+    int previous = -1;
+    for (uint64_t v = 0; v < (1ULL << 40); v = v * 3 / 2 + 1) {
+        int bucket = histogramBucket(v);
+        uint64_t high = histogramBucketHigh(bucket);
+        // Upper bound must cover v and stay within 12.5% of it
+        if (high < v || (double)high > (double)v * 1.125 + 1) within = 0;
+        if (bucket < previous) monotonic = 0;
+        previous = bucket;
+    }
+    test_assert(within, "Bucket Error Bound", "Bucket upper bounds should be within 12.5%");
+    test_assert(monotonic, "Bucket Order", "Larger values should never map to lower buckets");
+    test_assert(histogramBucket(7) == 7 && histogramBucketHigh(7) == 7, "Exact Small Values", "Values below 8ns are exact");
+}
+
+void test_batch_enqueue() {
+    printf("\n📋 TEST 16: Batch Enqueue\n");
+    reset_queue();
+    ticketIDHighWater = MAX_TICKET_ID + 1L;   // Keep the ID allocator off disk
+    
+    struct Ticket batch[5];
+    int results[5];
+    make_batch_ticket(&batch[0], 3001, "batch@test.com", "Payment page shows an error");
+    make_batch_ticket(&batch[1], 3002, "BATCH@test.com", "PAYMENT PAGE shows an error");
+    make_batch_ticket(&batch[2], 3001, "other@test.com", "Different issue entirely");
+    make_batch_ticket(&batch[3], 3003, "not-an-email", "Bad row");
+    make_batch_ticket(&batch[4], 3004, "second@test.com", "Screen flickers");
+    
+    int added = enqueueBatch(batch, 5, time(NULL), NULL, results);
+    test_assert(added == 2, "Batch Count", "Should enqueue the two distinct valid tickets");
+    test_assert(results[0] == SUCCESS && results[4] == SUCCESS, "Batch Accepted", "Valid rows should succeed");
+    test_assert(results[1] == TICKET_ERROR_DUPLICATE, "In-Batch Duplicate", "Same email and issue within the batch is a duplicate");
+    test_assert(results[2] == TICKET_ERROR_DUPLICATE, "Repeated ID", "A repeated ticket ID should be skipped");
+    test_assert(results[3] == TICKET_ERROR_INVALID_DATA, "Invalid Row", "Invalid email should be rejected");
+    test_assert(queuePosition(findTicketSlot(3004)) == 2, "Batch Order", "Accepted tickets keep batch order");
+    struct Ticket queued;
+    copyQueuedTicket(findTicketSlot(3001), &queued);
+    test_assert(strcmp(queued.priority, "Critical") == 0, "Batch Priority", "Batch tickets should be auto-classified");
+    
+    struct Ticket again;
+    make_batch_ticket(&again, 3005, "second@test.com", "screen flickers");
+    added = enqueueBatch(&again, 1, time(NULL), NULL, results);
+    test_assert(added == 0 && results[0] == TICKET_ERROR_DUPLICATE, "Queue Duplicate", "Duplicate of a queued ticket should be rejected");
+}
+
+void test_text_arena() {
+    printf("\n📋 TEST 17: Ticket Text Arena\n");
+    resetQueue();
+    
+    struct Ticket t;
+    make_batch_ticket(&t, 4001, "long@test.com", "");
+    for (int i = 0; i < 1500; i++) t.issueDescription[i] = (char)('a' + i % 26);
+    t.issueDescription[1500] = '\0';
+    strcpy(t.priority, "High");
+    enqueue(t);
+    
+    struct Ticket out;
+    copyQueuedTicket(findTicketSlot(4001), &out);
+    test_assert(strcmp(out.issueDescription, t.issueDescription) == 0, "Long Description", "A 1500-byte issue should be stored intact");
+    test_assert(strcmp(out.email, "long@test.com") == 0 && strcmp(out.priority, "High") == 0,
+                "Packed Fields", "Other fields should survive packing");
+    
+    // Same-sized tickets cycling through the queue recycle one block
+    size_t grownTo = textArenaSize;
+    for (int i = 0; i < 100; i++) {
+        dequeue(&out);
+        out.ticketID++;
+        enqueue(out);
+    }
+    test_assert(textArenaSize == grownTo, "Block Reuse", "Freed blocks should be reused before the arena grows");
+    test_assert(textArenaLive < sizeof(struct Ticket), "Live Bytes", "One queued ticket should hold one text block");
+    
+    resetQueue();
+}
+
+void test_cold_fields() {
+    printf("\n📋 TEST 18: Cold Field Mode\n");
+#ifndef _WIN32
+    if (!enter_scratch_dir("cold")) {
+        test_assert(0, "Cold Setup", "Cannot create a scratch directory");
+        return;
+    }
+    resetQueue();
+    ticketIDHighWater = MAX_TICKET_ID + 1L;
+    coldFieldMode = 1;
+    
+    FILE *db = fopen(PENDING_TICKETS_FILE, "w");
+    fprintf(db, "Ticket ID,Customer Name,Customer Email,Product,Purchase Date,Issue Description,Priority,Queue Entry Time\n");
+    struct Ticket batch[3];
+    make_batch_ticket(&batch[0], 5001, "cold1@test.com", "Order arrived damaged, box crushed");
+    make_batch_ticket(&batch[1], 5002, "cold2@test.com", "Refund not received");
+    make_batch_ticket(&batch[2], 5003, "cold3@test.com", "Cannot log in");
+    int added = enqueueBatch(batch, 3, time(NULL), db, NULL);
+    fclose(db);
+    test_assert(added == 3, "Cold Batch", "Batch should enqueue in cold-field mode");
+    test_assert(textArenaLive < 3 * 64, "Cold Arena", "Only emails should stay in the arena");
+    
+    struct Ticket out;
+    copyQueuedTicket(findTicketSlot(5001), &out);
+    test_assert(strcmp(out.issueDescription, batch[0].issueDescription) == 0 &&
+                strcmp(out.customerName, batch[0].customerName) == 0 &&
+                strcmp(out.email, "cold1@test.com") == 0, "Cold Read", "Fields should be read back from the database row");
+    test_assert(isDuplicateInQueue("cold2@test.com", "refund not received") == 5002,
+                "Cold Duplicate", "Duplicate check should compare the cold issue text");
+    
+    // A rewrite moves the rows; cold tickets follow them
+    removeTicketAt(findTicketSlot(5001), &out);
+    saveQueueToFile();
+    copyQueuedTicket(findTicketSlot(5003), &out);
+    test_assert(strcmp(out.issueDescription, "Cannot log in") == 0, "Cold Relocation",
+                "Fields should be found at the new row after a rewrite");
+    
+    coldFieldMode = 0;
+    resetQueue();
+    leave_scratch_dir();
+#else
+    test_assert(1, "Cold Field Mode", "Not available without mmap");
+#endif
+}
+
+void test_archive_partitions() {
+    printf("\n📋 TEST 19: Archive Partitions\n");
+#ifndef _WIN32
+    if (!enter_scratch_dir("archive")) {
+        test_assert(0, "Archive Setup", "Cannot create a scratch directory");
+        return;
+    }
+    
+    // Single-file archive from before partitioning
+    FILE *legacy = fopen(RESOLVED_TICKETS_FILE, "w");
+    fprintf(legacy, "Ticket ID,Customer Name,Customer Email,Product,Purchase Date,Issue Description,Priority,Queue Entry Time,Resolved At,Resolved By\n");
+    fprintf(legacy, "6001,Old User,old@test.com,Laptop,2020-01-01,Old issue,Low,1577000000,2020-01-15 10:00:00,admin1\n");
+    fclose(legacy);
+    buildArchiveIndexes();
+    
+    FILE *moved = fopen(ARCHIVE_DIR "/resolved-2020-01.csv", "r");
+    test_assert(moved != NULL, "Legacy Import", "Old rows should move to their month's partition");
+    if (moved) fclose(moved);
+    char line[4096];
+    char *fields[10];
+    test_assert(lookupResolvedTicket(6001, line, sizeof(line), fields, 10) >= 9, "Imported Lookup",
+                "Imported tickets should be found by ID");
+    
+    struct Ticket t;
+    make_batch_ticket(&t, 6002, "new@test.com", "Fresh problem");
+    strcpy(t.priority, "Low");
+    archiveTickets(&t, 1, "admin2");
+    test_assert(lookupResolvedTicket(6002, line, sizeof(line), fields, 10) >= 10 && strcmp(fields[9], "admin2") == 0,
+                "Partition Lookup", "Newly resolved tickets should be found in the current partition");
+    test_assert(isDuplicateInResolved("new@test.com", "fresh problem", DUPLICATE_LOOKBACK_DAYS) == 1,
+                "Lookback Hit", "Recent resolution should be inside the window");
+    test_assert(isDuplicateInResolved("old@test.com", "Old issue", DUPLICATE_LOOKBACK_DAYS) == 0,
+                "Lookback Window", "Old partitions should be outside the window");
+    
+    leave_scratch_dir();
+#else
+    test_assert(1, "Archive Partitions", "Needs a POSIX scratch directory");
+#endif
+}
+
+void test_resolved_analytics() {
+    printf("\n📋 TEST 20: Resolved Analytics\n");
+#ifndef _WIN32
+    if (!enter_scratch_dir("analytics")) {
+        test_assert(0, "Analytics Setup", "Cannot create a scratch directory");
+        return;
+    }
+    buildArchiveIndexes();
+    
+    // Three High Laptop tickets waiting 1 hour, one Low Phone ticket waiting 10 hours
+    time_t now = time(NULL);
+    struct Ticket batch[3];
+    for (int i = 0; i < 3; i++) {
+        make_batch_ticket(&batch[i], 7001 + i, "stats@test.com", "Report issue");
+        strcpy(batch[i].priority, "High");
+        batch[i].queueEntryTime = now - 3600;
+    }
+    archiveTickets(batch, 3, "admin1");
+    struct Ticket t;
+    make_batch_ticket(&t, 7004, "stats@test.com", "Other issue");
+    strcpy(t.product, "Phone");
+    strcpy(t.priority, "Low");
+    t.queueEntryTime = now - 36000;
+    archiveTickets(&t, 1, "admin2");
+    
+    int count = 0;
+    struct ReportLine *lines = buildReport(0, now - 86400, now + 60, &count);   // By priority
+    test_assert(lines && count == 2 && strcmp(lines[0].name, "High") == 0 && lines[0].count == 3 &&
+                strcmp(lines[1].name, "Low") == 0 && lines[1].count == 1,
+                "Priority Groups", "Report should count resolved tickets per priority");
+    test_assert(lines && count == 2 && lines[0].p50 >= 3600 && lines[0].p50 <= 3600 * 9 / 8,
+                "Wait Quantile", "Median wait should be within a histogram bucket of 1 hour");
+    free(lines);
+    
+    lines = buildReport(1, now - 86400, now + 60, &count);   // By product, largest first
+    test_assert(lines && count == 2 && strcmp(lines[0].name, "Laptop") == 0 && lines[0].count == 3 &&
+                strcmp(lines[1].name, "Phone") == 0,
+                "Product Groups", "Products should be named from the dictionary");
+    free(lines);
+    
+    // A lost sidecar is rebuilt from the partition at startup
+    remove_files(ARCHIVE_DIR, ".cols");
+    buildArchiveIndexes();
+    lines = buildReport(2, now - 86400, now + 60, &count);   // By admin
+    test_assert(lines && count == 2 && strcmp(lines[0].name, "admin1") == 0 && lines[0].count == 3,
+                "Sidecar Rebuild", "Missing column files should be rebuilt from the CSV rows");
+    free(lines);
+    
+    leave_scratch_dir();
+#else
+    test_assert(1, "Resolved Analytics", "Needs a POSIX scratch directory");
+#endif
+}
+
+void test_wait_sketches() {
+    printf("\n📋 TEST 21: Wait Time Sketches\n");
+    
+    // Queue statistics come from the counters, not a scan
+    resetQueue();
+    time_t now = time(NULL);
+    struct Ticket t;
+    make_batch_ticket(&t, 8001, "wait1@test.com", "Waiting since ten hours");
+    strcpy(t.priority, "Low");
+    t.queueEntryTime = now - 10 * 3600;
+    enqueue(t);
+    make_batch_ticket(&t, 8002, "wait2@test.com", "Waiting since two hours");
+    strcpy(t.priority, "High");
+    t.queueEntryTime = now - 2 * 3600;
+    enqueue(t);
+    int total, oldestHours, priorities[4];
+    double avgWait;
+    getQueueStats(&total, &avgWait, &oldestHours, priorities);
+    test_assert(total == 2 && oldestHours == 10 && avgWait > 5.9 && avgWait < 6.1 && priorities[1] == 1,
+                "Incremental Stats", "Average and oldest wait should follow enqueues");
+    dequeue(NULL);
+    getQueueStats(&total, &avgWait, &oldestHours, priorities);
+    test_assert(total == 1 && oldestHours == 2 && avgWait > 1.9 && avgWait < 2.1,
+                "Stats After Dequeue", "Dequeued tickets should leave the averages");
+    resetQueue();
+    
+    // 90 High tickets resolved after 1 hour, 10 after 10 hours
+    resetWaitSketches();
+    for (int i = 0; i < 100; i++) {
+        recordResolvedWait(1, 0xFFFF, now - (i < 90 ? 3600 : 36000), now);
+    }
+    struct WaitQuantiles waits[4];
+    getWaitQuantiles(waits, NULL, 0);
+    test_assert(waits[1].weight > 99.9 && waits[1].p50 >= 3600 && waits[1].p50 <= 3600 * 9 / 8 &&
+                waits[1].p99 >= 36000 && waits[1].p99 <= 36000 * 9 / 8 && waits[0].weight == 0.0,
+                "Sketch Quantiles", "p50 and p99 should be within a bucket of the true waits");
+    
+    // The same resolves one half-life ago weigh half as much
+    resetWaitSketches();
+    time_t earlier = now - WAIT_SKETCH_HALF_LIFE_HOURS * 3600;
+    for (int i = 0; i < 100; i++) {
+        recordResolvedWait(1, 0xFFFF, earlier - (i < 90 ? 3600 : 36000), earlier);
+    }
+    getWaitQuantiles(waits, NULL, 0);
+    test_assert(waits[1].weight > 49.9 && waits[1].weight < 50.1 && waits[1].p50 >= 3600 && waits[1].p50 <= 3600 * 9 / 8,
+                "Sketch Decay", "Weights should halve after one half-life, quantiles unchanged");
+    resetWaitSketches();
+}
+
 /* ==================== STRESS TESTS ==================== */
 
+void test_background_compaction() {
+    printf("\n📋 TEST 22: Background Compaction\n");
+#ifndef _WIN32
+    if (!enter_scratch_dir("compact")) {
+        test_assert(0, "Compaction Setup", "Cannot create a scratch directory");
+        return;
+    }
+    resetQueue();
+    ticketIDHighWater = MAX_TICKET_ID + 1L;
+    buildArchiveIndexes();
+    removalLogRecords = 0;   // Fresh directory: no removal log yet
+    write_ticket_database(8001, 4);
+    resolveTicketByID(8001, "admin1");
+    resolveTicketByID(8002, "admin1");
+    test_assert(removalLogRecords == 2, "Removal Markers", "Each resolve should append one marker");
+    
+    // Snapshot of #8003, #8004; while it is written, #8005 arrives and #8003 is resolved
+    startCompaction();
+    FILE *db = fopen(PENDING_TICKETS_FILE, "a");
+    struct Ticket late;
+    make_batch_ticket(&late, 8005, "late@test.com", "Arrived during compaction");
+    enqueueBatch(&late, 1, time(NULL), db, NULL);
+    fclose(db);
+    resolveTicketByID(8003, "admin1");
+    rememberDatabaseStamp();   // The engine's own writes
+    
+    test_assert(reapCompaction(1) == 2, "Compaction Written", "Worker should write the snapshot");   // COMPACTION_WRITTEN
+    finishCompaction();
+    test_assert(!file_has_line(PENDING_TICKETS_FILE, "8001,") && !file_has_line(PENDING_TICKETS_FILE, "8002,") &&
+                file_has_line(PENDING_TICKETS_FILE, "8004,") && access(DATABASE_COMPACT_TMP, F_OK) != 0,
+                "Compaction Swap", "Compacted file should replace the database without the resolved rows");
+    test_assert(file_has_line(PENDING_TICKETS_FILE, "8005,"), "Tail Copy",
+                "Rows appended during the rewrite should be carried over");
+    test_assert(removalLogRecords == 1 && file_has_line(REMOVAL_LOG_FILE, "8003,") &&
+                !file_has_line(REMOVAL_LOG_FILE, "8001,"),
+                "Log Trim", "Only markers written after the snapshot should stay");
+    
+    loadFromFile();
+    struct Ticket out;
+    int reloaded = dequeue(&out) && out.ticketID == 8004 && dequeue(&out) && out.ticketID == 8005 && isEmpty();
+    test_assert(reloaded, "Compacted Reload", "Reload should give #8004, #8005 (#8003 still marked)");
+    
+    // A full rewrite while a compaction runs drops the compaction
+    write_ticket_database(8101, 3);
+    startCompaction();
+    dequeue(&out);
+    saveQueueToFile();
+    test_assert(access(DATABASE_COMPACT_TMP, F_OK) != 0 && !file_has_line(PENDING_TICKETS_FILE, "8101,") &&
+                file_has_line(PENDING_TICKETS_FILE, "8103,") && reapCompaction(0) == 0,
+                "Rewrite Supersedes", "Saving should abandon the running compaction");
+    
+    resetQueue();
+    leave_scratch_dir();
+#else
+    test_assert(1, "Background Compaction", "Needs a POSIX scratch directory");
+#endif
+}
+
+// Number of queued tickets
+int queued_count() {
+    int total, oldest, priorities[4];
+    double avgWait;
+    getQueueStats(&total, &avgWait, &oldest, priorities);
+    return total;
+}
+
+void test_removal_log() {
+    printf("\n📋 TEST 23: Removal Log and Overflow Rows\n");
+#ifndef _WIN32
+    if (!enter_scratch_dir("removal")) {
+        test_assert(0, "Removal Setup", "Cannot create a scratch directory");
+        return;
+    }
+    resetQueue();
+    ticketIDHighWater = MAX_TICKET_ID + 1L;
+    buildArchiveIndexes();
+    removalLogRecords = 0;
+    write_ticket_database(9001, 4);
+    resolveTicketByID(9002, "admin1");
+    
+    loadFromFile();
+    test_assert(findTicketSlot(9002) < 0 && findTicketSlot(9001) >= 0 && queued_count() == 3 &&
+                removalLogRecords == 1 && file_has_line(PENDING_TICKETS_FILE, "9002,"),
+                "Marked Skip", "Reload should skip the resolved row still in the database");
+    
+    saveQueueToFile();
+    test_assert(access(REMOVAL_LOG_FILE, F_OK) != 0 && removalLogRecords == 0 &&
+                !file_has_line(PENDING_TICKETS_FILE, "9002,") && file_has_line(PENDING_TICKETS_FILE, "9003,"),
+                "Removal Fold-In", "A rewrite should drop resolved rows and the removal log");
+    loadFromFile();
+    struct Ticket out;
+    int order = dequeue(&out) && out.ticketID == 9001 && dequeue(&out) && out.ticketID == 9003 &&
+                dequeue(&out) && out.ticketID == 9004 && isEmpty();
+    test_assert(order, "Folded Reload", "Rewritten database should reload in FIFO order");
+    
+    // An archive that cannot be written leaves the ticket queued and unmarked
+    write_ticket_database(9101, 2);
+    loadFromFile();
+    rename(ARCHIVE_DIR, ARCHIVE_DIR ".away");
+    fclose(fopen(ARCHIVE_DIR, "w"));   // A file where the directory should be
+    int failed = resolveTicketByID(9101, "admin1");
+    test_assert(failed == TICKET_ERROR_FILE_OPEN && findTicketSlot(9101) == front && !isArchivedTicket(9101) &&
+                access(REMOVAL_LOG_FILE, F_OK) != 0, "Archive Failure",
+                "A failed archive write should keep the ticket queued and out of the removal log");
+    remove(ARCHIVE_DIR);
+    rename(ARCHIVE_DIR ".away", ARCHIVE_DIR);
+    test_assert(resolveTicketByID(9101, "admin1") == SUCCESS && isArchivedTicket(9101) &&
+                file_has_line(REMOVAL_LOG_FILE, "9101,"), "Archive Retry", "The resolve should succeed once the archive is back");
+    
+    // A few rows more than the queue holds
+    int total = MAX_QUEUE_SIZE + 2;
+    resetQueue();
+    write_ticket_database(20001, total);
+    test_assert(databaseOverflowRows > 0 && databaseOverflowRows == total - queued_count(), "Batch Overflow",
+                "Rows written past a full queue should be counted as overflow");
+    loadFromFile();
+    int held = queued_count();
+    test_assert(held >= MAX_QUEUE_SIZE - 1 && databaseOverflowRows == total - held, "Overflow Reload",
+                "Reload should queue what fits and count the rest");
+    
+    int next = 20001 + held;   // First row that did not fit
+    resolveTicketByID(20001, "admin1");
+    copyQueuedTicket(rear, &out);
+    test_assert(out.ticketID == next && findTicketSlot(next + 1) < 0 && queued_count() == held &&
+                databaseOverflowRows == total - held - 1,
+                "Incremental Load", "A freed slot should take the next overflow row, in file order");
+    int remaining = databaseOverflowRows;
+    for (int i = 0; i < remaining; i++) resolveTicketByID(20002 + i, "admin1");
+    struct Ticket first;
+    copyQueuedTicket(rear, &out);
+    copyQueuedTicket(front, &first);
+    test_assert(databaseOverflowRows == 0 && out.ticketID == 20000 + total && first.ticketID == 20002 + remaining,
+                "Overflow Drained", "The last overflow rows should follow the others");
+    
+    resetQueue();
+    leave_scratch_dir();
+#else
+    test_assert(1, "Removal Log", "Needs a POSIX scratch directory");
+#endif
+}
+
+/*
+ * Queues tickets 1..count so they straddle the end of the array: the
+ * front sits three slots before the wrap point. Tickets 1 and `count`
+ * are "Phone" tickets, the rest "Laptop".
+ */
+void fill_across_wrap(int count) {
+    resetQueue();
+    struct Ticket t;
+    make_batch_ticket(&t, 900000, "filler@test.com", "Filler");
+    strcpy(t.priority, "Low");
+    enqueue(t);
+    for (int i = 1; i < MAX_QUEUE_SIZE - 3; i++) {   // Walk the one filler up the array
+        t.ticketID = 900000 + i;
+        enqueue(t);
+        dequeue(NULL);
+    }
+    for (int id = 1; id <= count; id++) {
+        char email[64], issue[64];
+        snprintf(email, sizeof(email), "bulk%d@test.com", id);
+        snprintf(issue, sizeof(issue), "Bulk problem %d", id);
+        make_batch_ticket(&t, id, email, issue);
+        strcpy(t.priority, "Medium");
+        if (id == 1 || id == count) strcpy(t.product, "Phone");
+        enqueue(t);
+    }
+    dequeue(NULL);   // The filler
+}
+
+// True if the queue holds exactly `ids` in FIFO order, each found by
+// findTicketSlot() at its position
+int queue_holds(const int *ids, int count) {
+    if (queued_count() != count) return 0;
+    for (int i = 0; i < count; i++) {
+        int slot = (front + i) % MAX_QUEUE_SIZE;
+        struct Ticket t;
+        copyQueuedTicket(slot, &t);
+        if (t.ticketID != ids[i] || findTicketSlot(ids[i]) != slot) return 0;
+    }
+    return 1;
+}
+
+void test_bulk_resolve() {
+    printf("\n📋 TEST 24: Bulk Resolve\n");
+#ifndef _WIN32
+    if (!enter_scratch_dir("bulk")) {
+        test_assert(0, "Bulk Setup", "Cannot create a scratch directory");
+        return;
+    }
+    ticketIDHighWater = MAX_TICKET_ID + 1L;
+    buildArchiveIndexes();
+    
+    fill_across_wrap(8);
+    test_assert(front == MAX_QUEUE_SIZE - 3 && rear == 4, "Wrapped Setup", "Tickets 1-3 should sit before the wrap, 4-8 after");
+    
+    // Both sides of the wrap, an unknown ID and repeats
+    int list[] = {2, 5, 999998, 5, 7, 2};
+    int listed = resolveTicketList(list, 6, "admin1");
+    int afterList[] = {1, 3, 4, 6, 8};
+    test_assert(listed == 3, "List Count", "Unknown and repeated IDs should not count");
+    test_assert(queue_holds(afterList, 5), "List Survivors", "Survivors should keep FIFO order and their index slots");
+    test_assert(isArchivedTicket(2) && isArchivedTicket(5) && isArchivedTicket(7) && !isArchivedTicket(999998),
+                "List Archived", "Only the resolved tickets should be archived");
+    
+    // A filter matching the first and last tickets
+    fill_across_wrap(8);
+    struct ResolveFilter phones = {NULL, "phone", 0};
+    int matched = resolveMatching(&phones, "admin1");
+    int afterMatch[] = {2, 3, 4, 5, 6, 7};
+    test_assert(matched == 2 && queue_holds(afterMatch, 6), "Matching Both Ends",
+                "Front and rear matches should go, the middle keep its order");
+    struct ResolveFilter none = {"Critical", NULL, 0};
+    test_assert(resolveMatching(&none, "admin1") == 0 && queue_holds(afterMatch, 6), "Matching None",
+                "A filter matching nothing should leave the queue alone");
+    
+    // The front N, then more than the queue holds
+    fill_across_wrap(8);
+    int afterFirst[] = {5, 6, 7, 8};
+    test_assert(resolveFirst(4, "admin1") == 4 && queue_holds(afterFirst, 4) && front == 1,
+                "First Across Wrap", "Resolving the front four should leave 5-8 in place");
+    test_assert(resolveFirst(100, "admin1") == 4 && isEmpty(), "First Past Size",
+                "N larger than the queue should resolve everything queued");
+    test_assert(resolveFirst(1, "admin1") == 0, "First On Empty", "An empty queue has nothing to resolve");
+    
+    // Protocol verbs
+    fill_across_wrap(8);
+    char verb[] = "RESOLVE_IDS", admin[] = "admin1", ids[] = "3,8,3,0,4";
+    char *idArgs[] = {verb, admin, ids};
+    int afterVerb[] = {1, 2, 5, 6, 7};
+    test_assert(runBulkResolve(idArgs, 3) == 3 && queue_holds(afterVerb, 5), "IDs Verb",
+                "RESOLVE_IDS should parse the list and skip invalid and repeated IDs");
+    char matching[] = "RESOLVE_MATCHING", any[] = "*", age[] = "0";
+    char *everything[] = {matching, admin, any, age, any};
+    test_assert(runBulkResolve(everything, 5) == TICKET_ERROR_INVALID_DATA && queue_holds(afterVerb, 5),
+                "Unfiltered Refused", "RESOLVE_MATCHING without a filter should be rejected");
+    char first[] = "RESOLVE_FIRST", zero[] = "0";
+    char *firstArgs[] = {first, zero, admin};
+    test_assert(runBulkResolve(firstArgs, 3) == TICKET_ERROR_INVALID_DATA, "First Zero",
+                "RESOLVE_FIRST needs a positive count");
+    
+    resetQueue();
+    leave_scratch_dir();
+#else
+    test_assert(1, "Bulk Resolve", "Needs a POSIX scratch directory");
+#endif
+}
+
 void test_rapid_enqueue_dequeue() {
     printf("\n📋 TEST 12: Rapid Enqueue/Dequeue (Stress Test)\n");
     reset_queue();
@@ -371,6 +1089,20 @@ int main() {
     printf("\n⚡ Running Stress Tests...\n");
     test_rapid_enqueue_dequeue();
     
+    printf("\n🗂️  Running Index Tests...\n");
+    test_customer_history_index();
+    test_ticket_index();
+    test_latency_histogram_buckets();
+    test_batch_enqueue();
+    test_text_arena();
+    test_cold_fields();
+    test_archive_partitions();
+    test_resolved_analytics();
+    test_wait_sketches();
+    test_background_compaction();
+    test_removal_log();
+    test_bulk_resolve();
+    
     print_summary();
     
     return (tests_failed == 0) ? 0 : 1;